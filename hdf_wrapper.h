@@ -32,31 +32,91 @@ THE	SOFTWARE.
 #include	<sstream>//	for	dealing	with	strings	in	exceptions,	mostly
 #include	<type_traits>	//	for	removal	of	const	qualifiers
 #include	<limits>
+#include	<cmath>
 
 #include	<assert.h>
 #include	<vector>
+#include	<list>
+#include	<unordered_map>
+#include	<map>
+#include	<set>
+#include	<array>
+#include	<complex>
 #include	<iterator>
+#include	<algorithm>
+#include	<cstring>
+#include	<cstdlib>
+#include	<cstdint>
+#include	<stdexcept>
+#include	<thread>
+#include	<mutex>
+#include	<condition_variable>
+#include	<atomic>
+#include	<memory>
+#include	<chrono>
+#include	<functional>
 
 #if	(defined	__APPLE__)
 //	implement	nice	exception	messages	that	need	string	manipulation
 #elif	(defined	_MSC_VER)
 #include	<stdio.h>	//	for	FILE	stream	manipulation
+#include	<malloc.h>	//	for	_aligned_malloc
 #pragma	warning	(disable	:	4800)	//	performance	warning	for	conversion	to	bool
 #elif	(defined	__GNUG__)
 #include	<stdio.h>
 #endif
 
+#ifdef	_MSC_VER
+#include	<io.h>	//	_commit,	see	File::sync
+#else
+#include	<unistd.h>	//	fsync,	see	File::sync
+#endif
+
 #include	"hdf5.h"
 
 #ifdef	HDF_WRAPPER_HAS_BOOST
 #include	<boost/optional.hpp>
 #endif
 
+//	decoding	of	deflate	compressed	chunks	outside	of	the	HDF5	library,	see	read_chunks_parallel
+#ifdef	HDF_WRAPPER_HAS_ZLIB
+#include	<zlib.h>
+#endif
+
+//	SSSE3/AVX2	code	paths,	selected	at	runtime;	see	internal::shuffle
+#if	!defined(HDF_WRAPPER_NO_SIMD)	&&	defined(__GNUC__)	&&	(defined(__x86_64__)	||	defined(__i386__))
+#include	<immintrin.h>
+#define	HDF_WRAPPER_X86_SIMD
+#endif
+
+//	io_uring	file	driver	(Linux),	see	File::io_uring;	uses	the	system	calls	directly,	liburing	is	not	needed
+#ifdef	HDF_WRAPPER_HAS_IO_URING
+#include	<linux/io_uring.h>
+#include	<sys/syscall.h>
+#include	<sys/mman.h>
+#include	<sys/stat.h>
+#include	<sys/file.h>
+#include	<sys/uio.h>
+#include	<fcntl.h>
+#include	<unistd.h>
+#include	<sched.h>
+#include	<errno.h>
+#endif
+
+//	parallel	I/O	through	MPI-IO;	mpi.h	comes	with	hdf5.h
+#ifdef	HDF_WRAPPER_HAS_MPI
+#ifndef	H5_HAVE_PARALLEL
+#error	"HDF_WRAPPER_HAS_MPI	requires	a	parallel	build	of	the	HDF5	library"
+#endif
+#endif
+
 namespace	h5cpp
 {
 
 class	Object;
 class	Dataspace;
+class	Selection;
+struct	ValueRange;
 class	Dataset;
 class	Datatype;
 class	Attributes;
@@ -291,6 +351,33 @@ throw	Exception("error	getting	ref	count");
 return	r;
 }
 
+#if	H5_VERSION_GE(1,	10,	0)
+/*
+Cork	the	object:	its	metadata	stays	in	the	metadata	cache	and	is	not	flushed
+or	evicted	until	uncork()	or	until	the	file	is	closed.	Avoids	disk	access	at
+unpredictable	times	while	an	object	is	updated	frequently.
+*/
+void	cork()
+{
+if	(H5Odisable_mdc_flushes(id)	<	0)
+throw	Exception("error	corking	object	metadata");
+}
+
+void	uncork()
+{
+if	(H5Oenable_mdc_flushes(id)	<	0)
+throw	Exception("error	uncorking	object	metadata");
+}
+
+bool	is_corked()	const
+{
+hbool_t	res;
+if	(H5Oare_mdc_flushes_disabled(id,	&res)	<	0)
+throw	Exception("error	getting	cork	status	of	object");
+return	res;
+}
+#endif
+
 protected:
 hid_t	id;
 };
@@ -325,6 +412,74 @@ throw	Exception("error	creating	array	data	type");
 return	Datatype(id);
 }
 
+//	variable	length	sequences	of	base,	see	H5Tvlen_create
+static	Datatype	createVlen(const	Datatype	&base)
+{
+hid_t	id	=	H5Tvlen_create(base.get_id());
+if	(id	<	0)
+throw	Exception("error	creating	variable	length	data	type");
+return	Datatype(id);
+}
+
+/*
+IEEE	754	style	floating	point	type	with	the	given	field	sizes	and	the	usual
+exponent	bias.	Its	size	is	the	sum	of	the	fields	plus	the	sign	bit,	rounded	up
+to	whole	bytes.
+*/
+static	Datatype	createFloat(size_t	exponent_bits,	size_t	mantissa_bits,	H5T_order_t	order	=	H5T_ORDER_LE)
+{
+Datatype	t	=	copy(H5T_IEEE_F32LE);
+const	size_t	precision	=	1	+	exponent_bits	+	mantissa_bits;
+herr_t	err	=	H5Tset_fields(t.id,	precision	-	1,	mantissa_bits,	exponent_bits,	0,	mantissa_bits);
+if	(err	>=	0)
+err	=	H5Tset_precision(t.id,	precision);
+if	(err	>=	0)
+err	=	H5Tset_size(t.id,	(precision	+	7)	/	8);
+if	(err	>=	0)
+err	=	H5Tset_ebias(t.id,	(size_t(1)	<<	(exponent_bits	-	1))	-	1);
+if	(err	>=	0)
+err	=	H5Tset_order(t.id,	order);
+if	(err	<	0)
+throw	Exception("error	creating	floating	point	data	type");
+return	t;
+}
+
+//	IEEE	754	half	precision,	5	exponent	and	10	mantissa	bits
+static	Datatype	createFloat16(H5T_order_t	order	=	H5T_ORDER_LE)
+{
+return	createFloat(5,	10,	order);
+}
+
+//	the	upper	half	of	a	float,	8	exponent	and	7	mantissa	bits
+static	Datatype	createBFloat16(H5T_order_t	order	=	H5T_ORDER_LE)
+{
+return	createFloat(8,	7,	order);
+}
+
+static	Datatype	createCompound(size_t	size)
+{
+hid_t	id	=	H5Tcreate(H5T_COMPOUND,	size);
+if	(id	<	0)
+throw	Exception("error	creating	compound	data	type");
+return	Datatype(id);
+}
+
+//	add	a	member	to	a	compound	type
+void	insert(const	std::string	&name,	size_t	offset,	const	Datatype	&member)
+{
+herr_t	err	=	H5Tinsert(this->id,	name.c_str(),	offset,	member.get_id());
+if	(err	<	0)
+throw	Exception("error	inserting	compound	member:	"+name);
+}
+
+H5T_class_t	get_class()	const
+{
+H5T_class_t	c	=	H5Tget_class(this->id);
+if	(c	==	H5T_NO_CLASS)
+throw	Exception("cannot	get	datatype	class");
+return	c;
+}
+
 void	set_size(size_t	s)
 {
 herr_t	err	=	H5Tset_size(this->id,	s);
@@ -334,7 +489,7 @@ throw	Exception("cannot	set	datatype	size");
 
 void	set_variable_size()	{	set_size(H5T_VARIABLE);	}
 
-size_t	get_size()	//	in	bytes
+size_t	get_size()	const	//	in	bytes
 {
 size_t	s	=	H5Tget_size(this->id);
 if	(s	==	0)
@@ -363,7 +518,37 @@ throw	Exception("error	locking	datatype");
 /*
 RW	abstracts	away	how	datasets	and	attributes	are	written	since	both	works
 the	same	way,	afik,	except	for	function	names,	e.g.	H5Awrite	vs	H5Dwrite.
+The	h5traits	below	take	the	concrete	class	as	template	parameter,	so	calls
+are	dispatched	statically.	Specializations	taking	RW&	work	as	well.
+*/
+namespace	internal
+{
+
+/*
+The	zone	map	of	a	dataset	(see	build_zone_map)	is	kept	in	attributes	of	the
+dataset:	the	stats	in	pieces	"zone_map.0",	"zone_map.1",	...	of	up	to	2000
+zones,	which	keeps	each	below	the	64	KiB	limit	of	the	object	header,	the	zone
+dimensions	in	"zone_map.zone_dims",	the	extent	they	were	computed	for	in
+"zone_map.dims",	and	"zone_map.valid",	written	last.	Every	write	through
+the	wrapper	removes	"zone_map.valid",	so	read_where	does	not	use	a	stale	map.
 */
+const	hsize_t	zone_map_piece	=	2000;
+
+inline	std::string	zone_map_piece_name(hsize_t	k)
+{
+return	"zone_map."	+	std::to_string(k);
+}
+
+inline	void	invalidate_zone_map(hid_t	ds_id)
+{
+htri_t	res	=	H5Aexists(ds_id,	"zone_map.valid");
+if	(res	!=	0	&&	(res	<	0	||	H5Adelete(ds_id,	"zone_map.valid")	<	0))
+throw	Exception("cannot	invalidate	the	zone	map	of	a	dataset");
+}
+
+}	//	namespace	internal
+
+
 class	RW
 {
 public:
@@ -372,27 +557,28 @@ virtual	void	read(void	*buf)	=	0;
 virtual	~RW()	{}
 };
 
-class	RWdataset	:	public	RW
+class	RWdataset	final	:	public	RW
 {
-hid_t	ds_id,	mem_type_id,	mem_space_id,	file_space_id;
+hid_t	ds_id,	mem_type_id,	mem_space_id,	file_space_id,	xfer_id;
 public:
-RWdataset(hid_t	ds_id_,	hid_t	mem_type_id_,	hid_t	mem_space_id_,	hid_t	file_space_id_)	:	ds_id(ds_id_),	mem_type_id(mem_type_id_),	mem_space_id(mem_space_id_),	file_space_id(file_space_id_)	{}
+RWdataset(hid_t	ds_id_,	hid_t	mem_type_id_,	hid_t	mem_space_id_,	hid_t	file_space_id_,	hid_t	xfer_id_	=	H5P_DEFAULT)	:	ds_id(ds_id_),	mem_type_id(mem_type_id_),	mem_space_id(mem_space_id_),	file_space_id(file_space_id_),	xfer_id(xfer_id_)	{}
 void	write(const	void*	buf)
 {
-herr_t	err	=	H5Dwrite(ds_id,	mem_type_id,	mem_space_id,	file_space_id,	H5P_DEFAULT,	buf);
+internal::invalidate_zone_map(ds_id);
+herr_t	err	=	H5Dwrite(ds_id,	mem_type_id,	mem_space_id,	file_space_id,	xfer_id,	buf);
 if	(err	<	0)
 throw	Exception("error	writing	to	dataset");
 }
 void	read(void	*buf)
 {
-herr_t	err	=	H5Dread(ds_id,	mem_type_id,	mem_space_id,	file_space_id,	H5P_DEFAULT,	buf);
+herr_t	err	=	H5Dread(ds_id,	mem_type_id,	mem_space_id,	file_space_id,	xfer_id,	buf);
 if	(err	<	0)
 throw	Exception("error	reading	from	dataset");
 }
 };
 
 
-class	RWattribute	:	public	RW
+class	RWattribute	final	:	public	RW
 {
 hid_t	attr_id,	mem_type_id;
 public:
@@ -423,6 +609,7 @@ class	Dataspace	:	public	Object
 friend	class	Dataset;
 friend	class	Attributes;
 friend	class	Attribute;
+friend	class	Selection;
 private:
 Dataspace(hid_t	id,	internal::NoIncRC)	:	Object(id)	{}
 Dataspace(hid_t	id,	internal::IncRC)	:	Object(id,	internal::IncRC())	{}
@@ -435,9 +622,10 @@ if	(this->id	==	H5S_ALL)
 this->id	=	-1;
 }
 
-static	Dataspace	simple(int	rank,	const	hsize_t*	dims)
+//	maxdims	may	contain	H5S_UNLIMITED;	NULL	means	fixed	size
+static	Dataspace	simple(int	rank,	const	hsize_t*	dims,	const	hsize_t*	maxdims	=	NULL)
 {
-hid_t	id	=	H5Screate_simple(rank,	dims,	NULL);
+hid_t	id	=	H5Screate_simple(rank,	dims,	maxdims);
 if	(id	<	0)
 {
 std::ostringstream	oss;
@@ -457,6 +645,15 @@ throw	Exception("error	creating	scalar	dataspace");
 return	Dataspace(id,	internal::NoIncRC());
 }
 
+//	a	new	dataspace	with	the	same	extent	and	selection
+Dataspace	copy()	const
+{
+hid_t	id	=	H5Scopy(this->id);
+if	(id	<	0)
+throw	Exception("error	copying	dataspace");
+return	Dataspace(id,	internal::NoIncRC());
+}
+
 /*
 Arguments	specify	dimensions.	The	rank	is	determined	from	the	first	argument	that	is	zero.
 E.g.	simple_dims(5,	6)	and	simple_dims(5,	6	0	10)	both	result	in	a	dataspace
@@ -515,9 +712,9 @@ throw	Exception("unable	to	determine	number	of	elements	in	dataspace");
 return	r;
 }
 
-void	select_hyperslab(hsize_t*	offset,	hsize_t*	stride,	hsize_t*	count,	hsize_t	*block)
+void	select_hyperslab(const	hsize_t*	offset,	const	hsize_t*	stride,	const	hsize_t*	count,	const	hsize_t	*block,	H5S_seloper_t	op	=	H5S_SELECT_SET)
 {
-herr_t	r=	H5Sselect_hyperslab(get_id(),	H5S_SELECT_SET,	offset,	stride,	count,	block);
+herr_t	r=	H5Sselect_hyperslab(get_id(),	op,	offset,	stride,	count,	block);
 if	(r	<	0)
 throw	Exception("unable	to	select	hyperslab");
 }
@@ -529,6 +726,21 @@ if	(r	<	0)
 throw	Exception("error	selecting	the	entire	extent");
 }
 
+//	coords	holds	num_elements	tuples	of	rank	values	each,	see	H5Sselect_elements
+void	select_elements(size_t	num_elements,	const	hsize_t	*coords,	H5S_seloper_t	op	=	H5S_SELECT_SET)
+{
+herr_t	r	=	H5Sselect_elements(get_id(),	op,	num_elements,	coords);
+if	(r	<	0)
+throw	Exception("unable	to	select	elements");
+}
+
+void	select_none()
+{
+herr_t	r	=	H5Sselect_none(get_id());
+if	(r	<	0)
+throw	Exception("error	clearing	the	selection");
+}
+
 hssize_t	get_select_npoints()	const
 {
 hssize_t	r	=	H5Sget_select_npoints(get_id())	;
@@ -547,6 +759,288 @@ return	bool(result);
 };
 
 
+/*
+Selection	of	scattered	elements	of	a	dataset,	built	from	a	list	of	index	tuples.
+The	tuples	may	have	a	lower	rank	than	the	dataset.	Then	they	address	whole	rows,
+i.e.	the	trailing	dimensions	are	selected	entirely.	For	instance,	a	1-D	list
+of	indices	into	a	2-D	dataset	selects	these	rows.
+Indices	are	sorted	and	duplicates	are	removed.	Consecutive	indices	are	merged
+into	runs.	Runs	are	selected	as	a	union	of	hyperslabs	unless	the	indices	are
+sparse,	in	which	case	H5Sselect_elements	is	used.	Data	is	transferred	in	ascending
+index	order,	see	get_indices().
+The	dataspaces	are	built	once	per	dataset	extent	and	reused	by	subsequent	reads
+and	writes,	so	a	Selection	object	should	be	kept	around	for	repeated	access.
+*/
+class	Selection
+{
+public:
+enum	Mode
+{
+SELECT_AUTO,
+SELECT_HYPERSLABS,
+SELECT_POINTS
+};
+
+private:
+int	index_rank;
+std::vector<hsize_t>	coords;	//	sorted	unique	tuples,	index_rank	values	each
+std::vector<hsize_t>	run_starts;	//	first	tuple	of	each	run
+std::vector<hsize_t>	run_lengths;	//	along	the	last	index	dimension
+Mode	mode;
+//	cache	of	the	last	built	dataspaces
+mutable	std::vector<hsize_t>	cached_extent;
+mutable	Dataspace	cached_file_space,	cached_mem_space;
+
+Selection(int	index_rank_,	std::vector<hsize_t>	&&coords_)	:	index_rank(index_rank_),	coords(std::move(coords_)),	mode(SELECT_AUTO)
+{
+if	(index_rank	<	1	||	index_rank	>	H5S_MAX_RANK)
+throw	Exception("bad	rank	of	selection	indices");
+if	(coords.size()	%	index_rank	!=	0)
+throw	Exception("number	of	selection	coordinates	is	not	a	multiple	of	the	rank");
+sort_and_coalesce();
+}
+
+void	sort_and_coalesce()
+{
+const	int	k	=	index_rank;
+const	size_t	n	=	coords.size()	/	k;
+bool	sorted	=	true;
+for	(size_t	i=1;	i<n	&&	sorted;	++i)
+sorted	=	std::lexicographical_compare(&coords[(i-1)*k],	&coords[i*k],	&coords[i*k],	&coords[(i+1)*k]);
+if	(!sorted)
+{
+std::vector<size_t>	order(n);
+for	(size_t	i=0;	i<n;	++i)	order[i]	=	i;
+const	hsize_t	*c	=	coords.data();
+std::sort(order.begin(),	order.end(),	[c,	k](size_t	a,	size_t	b)	{
+return	std::lexicographical_compare(c	+	a*k,	c	+	(a+1)*k,	c	+	b*k,	c	+	(b+1)*k);
+});
+std::vector<hsize_t>	tmp;
+tmp.reserve(coords.size());
+for	(size_t	i=0;	i<n;	++i)
+{
+const	hsize_t	*p	=	c	+	order[i]*k;
+if	(i>0	&&	std::equal(p,	p+k,	&tmp[tmp.size()-k]))
+continue;	//	duplicate
+tmp.insert(tmp.end(),	p,	p+k);
+}
+coords.swap(tmp);
+}
+
+//	consecutive	tuples	which	differ	only	by	one	in	the	last	index	form	a	run
+const	size_t	m	=	coords.size()	/	k;
+for	(size_t	i=0;	i<m;	++i)
+{
+const	hsize_t	*p	=	&coords[i*k];
+if	(!run_lengths.empty())
+{
+const	hsize_t	*q	=	&run_starts[run_starts.size()-k];
+if	(std::equal(p,	p+k-1,	q)	&&	q[k-1]	+	run_lengths.back()	==	p[k-1])
+{
+++run_lengths.back();
+continue;
+}
+}
+run_starts.insert(run_starts.end(),	p,	p+k);
+run_lengths.push_back(1);
+}
+}
+
+bool	use_points(int	rank)	const
+{
+if	(index_rank	<	rank)	//	rows	would	have	to	be	expanded	into	elements
+return	false;
+if	(mode	!=	SELECT_AUTO)
+return	mode	==	SELECT_POINTS;
+//	hyperslab	unions	pay	off	once	runs	cover	at	least	a	few	elements
+return	size()	<	4	*	get_num_runs();
+}
+
+void	build(const	Dataspace	&extent,	const	hsize_t	*dims,	int	rank)	const
+{
+Dataspace	fs	=	extent.copy();
+const	int	k	=	index_rank;
+const	hsize_t	n	=	size();
+for	(size_t	i=0;	i<coords.size();	++i)
+{
+if	(coords[i]	>=	dims[i	%	k])
+throw	Exception("selection	index	out	of	range");
+}
+if	(n	==	0)
+fs.select_none();
+else	if	(use_points(rank))
+fs.select_elements(n,	coords.data());
+else
+{
+hsize_t	offset[H5S_MAX_RANK],	count[H5S_MAX_RANK],	block[H5S_MAX_RANK];
+for	(int	d=0;	d<rank;	++d)
+{
+offset[d]	=	0;
+count[d]	=	1;
+block[d]	=	d	<	k	?	1	:	dims[d];
+}
+for	(size_t	i=0;	i<run_lengths.size();	++i)
+{
+std::copy(&run_starts[i*k],	&run_starts[(i+1)*k],	offset);
+block[k-1]	=	run_lengths[i];
+fs.select_hyperslab(offset,	NULL,	count,	block,	i==0	?	H5S_SELECT_SET	:	H5S_SELECT_OR);
+}
+}
+
+//	memory	is	contiguous,	one	row	of	trailing	dimensions	per	index	tuple
+hsize_t	mdims[H5S_MAX_RANK];
+mdims[0]	=	n;
+std::copy(dims	+	k,	dims	+	rank,	mdims	+	1);
+Dataspace	ms	=	Dataspace::simple(1	+	rank	-	k,	mdims);
+
+cached_file_space	=	fs;
+cached_mem_space	=	ms;
+cached_extent.assign(dims,	dims	+	rank);
+}
+
+public:
+Selection()	:	index_rank(1),	mode(SELECT_AUTO)	{}
+
+//	1-D	indices;	into	a	dataset	of	higher	rank	they	select	rows
+template<class	Int>
+static	Selection	indices(const	Int	*idx,	size_t	n)
+{
+std::vector<hsize_t>	c(idx,	idx	+	n);
+return	Selection(1,	std::move(c));
+}
+
+template<class	Int,	class	A>
+static	Selection	indices(const	std::vector<Int,	A>	&idx)
+{
+return	indices(idx.data(),	idx.size());
+}
+
+//	n	tuples	of	rank	values	each,	laid	out	as	for	H5Sselect_elements
+template<class	Int>
+static	Selection	points(int	rank,	const	Int	*coords,	size_t	n)
+{
+std::vector<hsize_t>	c(coords,	coords	+	n	*	rank);
+return	Selection(rank,	std::move(c));
+}
+
+//	force	hyperslabs	or	points	instead	of	the	automatic	choice
+Selection&	set_mode(Mode	m)
+{
+mode	=	m;
+cached_extent.clear();
+return	*this;
+}
+
+//	number	of	selected	index	tuples,	i.e.	rows	if	the	index	rank	is	lower	than	the	dataset	rank
+hsize_t	size()	const	{	return	coords.size()	/	index_rank;	}
+
+int	get_index_rank()	const	{	return	index_rank;	}
+
+size_t	get_num_runs()	const	{	return	run_lengths.size();	}
+
+//	the	sorted	unique	index	tuples	in	the	order	in	which	data	is	transferred
+const	std::vector<hsize_t>&	get_indices()	const	{	return	coords;	}
+
+/*
+Get	the	dataspaces	for	a	transfer	from/to	a	dataset	with	the	given	extent.	The
+memory	dataspace	has	rank	1	+	rank(extent)	-	index	rank.	The	first	dimension
+counts	the	index	tuples;	the	others	are	the	trailing	dimensions	of	the	extent.
+Both	are	reused	as	long	as	the	extent	does	not	change.
+*/
+void	get_dataspaces(const	Dataspace	&extent,	Dataspace	&file_space,	Dataspace	&mem_space)	const
+{
+hsize_t	dims[H5S_MAX_RANK];
+int	rank	=	extent.get_dims(dims);
+if	(rank	<	index_rank)
+throw	Exception("rank	of	selection	indices	exceeds	dataset	rank");
+if	(cached_extent.size()	!=	(size_t)rank	||	!std::equal(dims,	dims	+	rank,	cached_extent.begin()))
+build(extent,	dims,	rank);
+file_space	=	cached_file_space;
+mem_space	=	cached_mem_space;
+}
+};
+
+
+/*
+The	block	of	a	dataset	extent	owned	by	one	process	when	the	extent	is
+decomposed	among	nprocs	processes,	e.g.	the	MPI	ranks	of	a	communicator.
+Sizes	which	don't	divide	evenly	are	spread	over	the	first	processes.	Use
+file_space()	and	mem_space()	with	Dataset::read/write;	with	a	collective
+transfer	all	processes	must	take	part,	even	if	their	block	is	empty.
+*/
+class	BlockDecomposition
+{
+int	rank;
+hsize_t	offset[H5S_MAX_RANK],	count[H5S_MAX_RANK];
+
+static	void	split(hsize_t	n,	int	proc,	int	nprocs,	hsize_t	&offset,	hsize_t	&count)
+{
+if	(nprocs	<	1	||	proc	<	0	||	proc	>=	nprocs)
+throw	Exception("bad	process	index	for	block	decomposition");
+hsize_t	base	=	n	/	nprocs,	rest	=	n	%	nprocs;
+hsize_t	p	=	(hsize_t)proc;
+count	=	base	+	(p	<	rest	?	1	:	0);
+offset	=	p	*	base	+	std::min(p,	rest);
+}
+
+explicit	BlockDecomposition(const	Dataspace	&extent)
+{
+rank	=	extent.get_dims(count);
+std::fill(offset,	offset	+	rank,	0);
+}
+
+public:
+//	slabs	along	dimension	dim,	e.g.	rows	for	dim	=	0
+static	BlockDecomposition	along(const	Dataspace	&extent,	int	dim,	int	proc,	int	nprocs)
+{
+BlockDecomposition	b(extent);
+if	(dim	<	0	||	dim	>=	b.rank)
+throw	Exception("bad	dimension	for	block	decomposition");
+split(b.count[dim],	proc,	nprocs,	b.offset[dim],	b.count[dim]);
+return	b;
+}
+
+/*
+Cartesian	process	grid	with	proc_dims[i]	processes	along	dimension	i,	as
+from	MPI_Dims_create.	proc_coords	are	the	grid	coordinates	of	this	process,
+as	from	MPI_Cart_coords.
+*/
+static	BlockDecomposition	grid(const	Dataspace	&extent,	const	int	*proc_dims,	const	int	*proc_coords)
+{
+BlockDecomposition	b(extent);
+for	(int	i=0;	i<b.rank;	++i)
+split(b.count[i],	proc_coords[i],	proc_dims[i],	b.offset[i],	b.count[i]);
+return	b;
+}
+
+int	get_rank()	const	{	return	rank;	}
+const	hsize_t*	get_offset()	const	{	return	offset;	}
+const	hsize_t*	get_count()	const	{	return	count;	}
+
+hsize_t	size()	const
+{
+hsize_t	n	=	1;
+for	(int	i=0;	i<rank;	++i)	n	*=	count[i];
+return	n;
+}
+
+//	the	dataset	extent	with	this	block	selected
+Dataspace	file_space(const	Dataspace	&extent)	const
+{
+Dataspace	fs	=	extent.copy();
+if	(size()	==	0)
+fs.select_none();
+else
+fs.select_hyperslab(offset,	NULL,	count,	NULL);
+return	fs;
+}
+
+//	contiguous	buffer	of	the	block
+Dataspace	mem_space()	const
+{
+return	Dataspace::simple(rank,	count);
+}
+};
 class	Attribute	:	public	Object
 {
 friend	class	Attributes;
@@ -740,751 +1234,8676 @@ throw	Exception("error	deleting	attribute");
 };
 
 
-class	Properties	:	protected	Object
-{
-public:
-using	Object::get_id;
-using	Object::is_valid;
-using	Object::is_same;
+/*--------------------------------------------------
+*	shuffle	+	LZ	filter
+*	------------------------------------------------	*/
 
-Properties(hid_t	cls_id)	:	Object()
+/*
+Filter	id	of	the	built-in	shuffle	+	LZ	compression	filter,	from	the	range	for
+private,	unregistered	filters.	Files	written	with	it	can	only	be	read	by
+programs	using	this	header	(or	a	plugin	implementing	the	same	format),	so	the
+id	must	never	change.
+*/
+#ifndef	HDF_WRAPPER_SHUFFLE_LZ_FILTER_ID
+#define	HDF_WRAPPER_SHUFFLE_LZ_FILTER_ID	47104
+#endif
+
+namespace	internal
 {
-this->id	=	H5Pcreate(cls_id);
-if	(this->id	<	0)
-throw	Exception("error	creating	property	list");
+
+#ifdef	HDF_WRAPPER_X86_SIMD
+//	transposes	the	bytes	of	4	byte	elements	within	16	byte	blocks;	the	permutation	is	its	own	inverse
+#define	HDF_WRAPPER_SHUFFLE4_MASK	0,	4,	8,	12,	1,	5,	9,	13,	2,	6,	10,	14,	3,	7,	11,	15
+
+/*
+Byte	shuffle	of	n	4	byte	elements,	16	at	a	time:	bytes	are	first	grouped
+within	each	register,	then	4x4	dwords	are	transposed.	Returns	the	number	of
+elements	done;	the	caller	does	the	rest.
+*/
+__attribute__((target("ssse3")))
+inline	size_t	shuffle4_ssse3(const	unsigned	char	*src,	unsigned	char	*dst,	size_t	n)
+{
+const	__m128i	mask	=	_mm_setr_epi8(HDF_WRAPPER_SHUFFLE4_MASK);
+size_t	i	=	0;
+for	(;	i+16<=n;	i+=16)
+{
+const	unsigned	char	*s	=	src	+	4	*	i;
+__m128i	r0	=	_mm_shuffle_epi8(_mm_loadu_si128((const	__m128i*)s),	mask);
+__m128i	r1	=	_mm_shuffle_epi8(_mm_loadu_si128((const	__m128i*)(s	+	16)),	mask);
+__m128i	r2	=	_mm_shuffle_epi8(_mm_loadu_si128((const	__m128i*)(s	+	32)),	mask);
+__m128i	r3	=	_mm_shuffle_epi8(_mm_loadu_si128((const	__m128i*)(s	+	48)),	mask);
+__m128i	t0	=	_mm_unpacklo_epi32(r0,	r1),	t1	=	_mm_unpackhi_epi32(r0,	r1);
+__m128i	t2	=	_mm_unpacklo_epi32(r2,	r3),	t3	=	_mm_unpackhi_epi32(r2,	r3);
+_mm_storeu_si128((__m128i*)(dst	+	i),	_mm_unpacklo_epi64(t0,	t2));
+_mm_storeu_si128((__m128i*)(dst	+	n	+	i),	_mm_unpackhi_epi64(t0,	t2));
+_mm_storeu_si128((__m128i*)(dst	+	2	*	n	+	i),	_mm_unpacklo_epi64(t1,	t3));
+_mm_storeu_si128((__m128i*)(dst	+	3	*	n	+	i),	_mm_unpackhi_epi64(t1,	t3));
+}
+return	i;
+}
+
+__attribute__((target("ssse3")))
+inline	size_t	unshuffle4_ssse3(const	unsigned	char	*src,	unsigned	char	*dst,	size_t	n)
+{
+const	__m128i	mask	=	_mm_setr_epi8(HDF_WRAPPER_SHUFFLE4_MASK);
+size_t	i	=	0;
+for	(;	i+16<=n;	i+=16)
+{
+__m128i	r0	=	_mm_loadu_si128((const	__m128i*)(src	+	i));
+__m128i	r1	=	_mm_loadu_si128((const	__m128i*)(src	+	n	+	i));
+__m128i	r2	=	_mm_loadu_si128((const	__m128i*)(src	+	2	*	n	+	i));
+__m128i	r3	=	_mm_loadu_si128((const	__m128i*)(src	+	3	*	n	+	i));
+__m128i	t0	=	_mm_unpacklo_epi32(r0,	r1),	t1	=	_mm_unpackhi_epi32(r0,	r1);
+__m128i	t2	=	_mm_unpacklo_epi32(r2,	r3),	t3	=	_mm_unpackhi_epi32(r2,	r3);
+unsigned	char	*d	=	dst	+	4	*	i;
+_mm_storeu_si128((__m128i*)d,	_mm_shuffle_epi8(_mm_unpacklo_epi64(t0,	t2),	mask));
+_mm_storeu_si128((__m128i*)(d	+	16),	_mm_shuffle_epi8(_mm_unpackhi_epi64(t0,	t2),	mask));
+_mm_storeu_si128((__m128i*)(d	+	32),	_mm_shuffle_epi8(_mm_unpacklo_epi64(t1,	t3),	mask));
+_mm_storeu_si128((__m128i*)(d	+	48),	_mm_shuffle_epi8(_mm_unpackhi_epi64(t1,	t3),	mask));
+}
+return	i;
 }
 
-Properties&	deflate(int	strength	=	9)
-{
-H5Pset_deflate(this->id,	strength);
-return	*this;
-};
+/*
+Same	with	32	elements	at	a	time.	The	byte	grouping	works	within	128	bit	lanes,
+so	the	dwords	are	first	brought	into	order	across	lanes,	then	4x4	qwords	are
+transposed.
+*/
+__attribute__((target("avx2")))
+inline	size_t	shuffle4_avx2(const	unsigned	char	*src,	unsigned	char	*dst,	size_t	n)
+{
+const	__m256i	mask	=	_mm256_setr_epi8(HDF_WRAPPER_SHUFFLE4_MASK,	HDF_WRAPPER_SHUFFLE4_MASK);
+const	__m256i	order	=	_mm256_setr_epi32(0,	4,	1,	5,	2,	6,	3,	7);
+size_t	i	=	0;
+for	(;	i+32<=n;	i+=32)
+{
+const	unsigned	char	*s	=	src	+	4	*	i;
+__m256i	q[4];
+for	(int	k=0;	k<4;	++k)
+q[k]	=	_mm256_permutevar8x32_epi32(_mm256_shuffle_epi8(_mm256_loadu_si256((const	__m256i*)(s	+	32	*	k)),	mask),	order);
+__m256i	t0	=	_mm256_unpacklo_epi64(q[0],	q[1]),	t1	=	_mm256_unpackhi_epi64(q[0],	q[1]);
+__m256i	t2	=	_mm256_unpacklo_epi64(q[2],	q[3]),	t3	=	_mm256_unpackhi_epi64(q[2],	q[3]);
+_mm256_storeu_si256((__m256i*)(dst	+	i),	_mm256_permute2x128_si256(t0,	t2,	0x20));
+_mm256_storeu_si256((__m256i*)(dst	+	n	+	i),	_mm256_permute2x128_si256(t1,	t3,	0x20));
+_mm256_storeu_si256((__m256i*)(dst	+	2	*	n	+	i),	_mm256_permute2x128_si256(t0,	t2,	0x31));
+_mm256_storeu_si256((__m256i*)(dst	+	3	*	n	+	i),	_mm256_permute2x128_si256(t1,	t3,	0x31));
+}
+return	i;
+}
+
+__attribute__((target("avx2")))
+inline	size_t	unshuffle4_avx2(const	unsigned	char	*src,	unsigned	char	*dst,	size_t	n)
+{
+const	__m256i	mask	=	_mm256_setr_epi8(HDF_WRAPPER_SHUFFLE4_MASK,	HDF_WRAPPER_SHUFFLE4_MASK);
+const	__m256i	order	=	_mm256_setr_epi32(0,	2,	4,	6,	1,	3,	5,	7);
+size_t	i	=	0;
+for	(;	i+32<=n;	i+=32)
+{
+__m256i	o0	=	_mm256_loadu_si256((const	__m256i*)(src	+	i));
+__m256i	o1	=	_mm256_loadu_si256((const	__m256i*)(src	+	n	+	i));
+__m256i	o2	=	_mm256_loadu_si256((const	__m256i*)(src	+	2	*	n	+	i));
+__m256i	o3	=	_mm256_loadu_si256((const	__m256i*)(src	+	3	*	n	+	i));
+__m256i	t0	=	_mm256_permute2x128_si256(o0,	o2,	0x20),	t2	=	_mm256_permute2x128_si256(o0,	o2,	0x31);
+__m256i	t1	=	_mm256_permute2x128_si256(o1,	o3,	0x20),	t3	=	_mm256_permute2x128_si256(o1,	o3,	0x31);
+__m256i	q[4];
+q[0]	=	_mm256_unpacklo_epi64(t0,	t1);
+q[1]	=	_mm256_unpackhi_epi64(t0,	t1);
+q[2]	=	_mm256_unpacklo_epi64(t2,	t3);
+q[3]	=	_mm256_unpackhi_epi64(t2,	t3);
+unsigned	char	*d	=	dst	+	4	*	i;
+for	(int	k=0;	k<4;	++k)
+_mm256_storeu_si256((__m256i*)(d	+	32	*	k),	_mm256_shuffle_epi8(_mm256_permutevar8x32_epi32(q[k],	order),	mask));
+}
+return	i;
+}
+
+#undef	HDF_WRAPPER_SHUFFLE4_MASK
+
+inline	bool	cpu_has_avx2()
+{
+static	const	bool	res	=	__builtin_cpu_supports("avx2");
+return	res;
+}
 
-Properties&	chunked(int	rank,	const	hsize_t	*dims)
+inline	bool	cpu_has_ssse3()
 {
-H5Pset_chunk(this->id,	rank,	dims);
-return	*this;
+static	const	bool	res	=	__builtin_cpu_supports("ssse3");
+return	res;
 }
+#endif
 
-Properties&	chunked_with_estimated_size(const	Dataspace	&sp)
+//	same	as	the	shuffle	filter	of	the	HDF5	library:	byte	b	of	element	i	is	stored	at	b	*	num_elements	+	i
+inline	void	shuffle(const	unsigned	char	*src,	unsigned	char	*dst,	size_t	nbytes,	size_t	elem_size)
 {
-hsize_t	dims[H5S_MAX_RANK];
-int	r	=	sp.get_dims(dims);
-hsize_t	cdims[H5S_MAX_RANK];
-for	(int	i=0;	i<r;	++i)
+size_t	n	=	elem_size	>	1	?	nbytes	/	elem_size	:	0;
+size_t	done	=	0;
+#ifdef	HDF_WRAPPER_X86_SIMD
+if	(elem_size	==	4)
+done	=	cpu_has_avx2()	?	shuffle4_avx2(src,	dst,	n)	:	cpu_has_ssse3()	?	shuffle4_ssse3(src,	dst,	n)	:	0;
+#endif
+for	(size_t	b=0;	b<elem_size	&&	n>0;	++b)
 {
-hsize_t	val	=	dims[i];
-hsize_t	org_val	=	val;
-val	=	(hsize_t)(val	*	0.1);
-if	(val	<	32.)
-val	=	32;
-if	(val	>	org_val)
-val	=	org_val;
-cdims[i]	=	val;
+unsigned	char	*d	=	dst	+	b	*	n;
+for	(size_t	i=done;	i<n;	++i)
+d[i]	=	src[i	*	elem_size	+	b];
 }
-return	chunked(r,	cdims);
+std::memcpy(dst	+	n	*	elem_size,	src	+	n	*	elem_size,	nbytes	-	n	*	elem_size);	//	leftover	bytes	are	not	shuffled
 }
-};
 
-
-class	iterator;
-
-class	Group	:	public	Object
+//	inverse	of	the	shuffle	filter
+inline	void	unshuffle(const	unsigned	char	*src,	unsigned	char	*dst,	size_t	nbytes,	size_t	elem_size)
 {
-friend	class	File;
-private:
-Group(hid_t	loc_id,	const	char	*	name,	hid_t	gapl_id	,	internal::TagOpen)
+size_t	n	=	elem_size	>	1	?	nbytes	/	elem_size	:	0;
+size_t	done	=	0;
+#ifdef	HDF_WRAPPER_X86_SIMD
+if	(elem_size	==	4)
+done	=	cpu_has_avx2()	?	unshuffle4_avx2(src,	dst,	n)	:	cpu_has_ssse3()	?	unshuffle4_ssse3(src,	dst,	n)	:	0;
+#endif
+for	(size_t	b=0;	b<elem_size	&&	n>0;	++b)
 {
-this->id	=	H5Gopen2(loc_id,	name,	gapl_id);
-if	(this->id	<	0)
-throw	Exception("unable	to	open	group:	"+std::string(name));
+const	unsigned	char	*s	=	src	+	b	*	n;
+for	(size_t	i=done;	i<n;	++i)
+dst[i	*	elem_size	+	b]	=	s[i];
 }
-Group(hid_t	loc_id,	const	char	*name,	hid_t	lcpl_id,	hid_t	gcpl_id,	hid_t	gapl_id,	internal::TagCreate)
-{
-this->id	=	H5Gcreate2(loc_id,	name,	lcpl_id,	gcpl_id,	gapl_id);
-if	(this->id	<	0)
-throw	Exception("unable	to	create	group:	"+std::string(name));
+std::memcpy(dst	+	n	*	elem_size,	src	+	n	*	elem_size,	nbytes	-	n	*	elem_size);	//	leftover	bytes	are	not	shuffled
 }
-public:
 
-Group()	:	Object()	{}
-explicit	Group(hid_t	id)	:	Object(id)	{	Object::inc_ref();	}
+inline	uint32_t	load32(const	unsigned	char	*p)
+{
+uint32_t	v;
+std::memcpy(&v,	p,	4);
+return	v;
+}
 
-bool	exists(const	std::string	&name)	const
+inline	void	put_length(std::vector<unsigned	char>	&out,	size_t	len)
 {
-htri_t	res	=	H5Lexists(this->id,	name.c_str(),	H5P_DEFAULT);
-if	(res	<	0)
-throw	Exception("cannot	determine	existence	of	link");
-return	res	>	0;
+for	(;	len	>=	255;	len	-=	255)
+out.push_back(255);
+out.push_back((unsigned	char)len);
 }
 
-//	number	of	links	in	the	group
-hsize_t	size()	const
-{
-H5G_info_t	info;
-herr_t	res	=	H5Gget_info(this->id,	&info);
-if	(res	<	0)
-throw	Exception("cannot	get	info	of	group");
-return	info.nlinks;
+/*
+Greedy	LZ77	compression	into	the	LZ4	block	format:	sequences	of	a	token	with
+literal	and	match	length	nibbles,	extra	length	bytes,	literals,	and	a	16	bit
+match	offset.	Matches	are	found	through	a	hash	table	of	4	byte	prefixes;	the
+search	skips	ahead	faster	in	incompressible	data.	Appends	to	out.
+*/
+inline	void	lz_compress(const	unsigned	char	*src,	size_t	n,	std::vector<unsigned	char>	&out)
+{
+const	int	HASH_BITS	=	14;
+const	size_t	MIN_MATCH	=	4,	LAST_LITERALS	=	5,	MF_LIMIT	=	12;
+std::vector<uint32_t>	table(size_t(1)	<<	HASH_BITS,	0);
+size_t	ip	=	0,	anchor	=	0,	misses	=	0;
+while	(n	>=	MF_LIMIT	+	1	&&	ip	+	MF_LIMIT	<=	n)
+{
+uint32_t	seq	=	load32(src	+	ip);
+uint32_t	h	=	(seq	*	2654435761u)	>>	(32	-	HASH_BITS);
+size_t	ref	=	table[h];
+table[h]	=	(uint32_t)ip;
+if	(ref	>=	ip	||	ip	-	ref	>	65535	||	load32(src	+	ref)	!=	seq)
+{
+ip	+=	1	+	(misses++	>>	6);
+continue;
+}
+misses	=	0;
+while	(ip	>	anchor	&&	ref	>	0	&&	src[ip-1]	==	src[ref-1])	//	extend	backwards
+{
+--ip;
+--ref;
+}
+size_t	len	=	MIN_MATCH;
+const	size_t	max_len	=	n	-	LAST_LITERALS	-	ip;
+while	(len	<	max_len	&&	src[ref	+	len]	==	src[ip	+	len])
+++len;
+size_t	lit	=	ip	-	anchor,	ml	=	len	-	MIN_MATCH;
+out.push_back((unsigned	char)((std::min<size_t>(lit,	15)	<<	4)	|	std::min<size_t>(ml,	15)));
+if	(lit	>=	15)
+put_length(out,	lit	-	15);
+out.insert(out.end(),	src	+	anchor,	src	+	ip);
+size_t	offset	=	ip	-	ref;
+out.push_back((unsigned	char)offset);
+out.push_back((unsigned	char)(offset	>>	8));
+if	(ml	>=	15)
+put_length(out,	ml	-	15);
+ip	+=	len;
+anchor	=	ip;
+}
+size_t	lit	=	n	-	anchor;
+out.push_back((unsigned	char)(std::min<size_t>(lit,	15)	<<	4));
+if	(lit	>=	15)
+put_length(out,	lit	-	15);
+out.insert(out.end(),	src	+	anchor,	src	+	n);
+}
+
+//	false	on	malformed	input,	which	must	not	crash	since	it	comes	from	a	file
+inline	bool	lz_decompress(const	unsigned	char	*src,	size_t	n,	unsigned	char	*dst,	size_t	out_n)
+{
+size_t	ip	=	0,	op	=	0;
+while	(ip	<	n)
+{
+unsigned	token	=	src[ip++];
+size_t	lit	=	token	>>	4;
+if	(lit	==	15)
+{
+unsigned	char	b;
+do
+{
+if	(ip	>=	n)
+return	false;
+b	=	src[ip++];
+lit	+=	b;
+}	while	(b	==	255);
+}
+if	(lit	>	n	-	ip	||	lit	>	out_n	-	op)
+return	false;
+std::memcpy(dst	+	op,	src	+	ip,	lit);
+ip	+=	lit;
+op	+=	lit;
+if	(ip	==	n)
+break;
+if	(n	-	ip	<	2)
+return	false;
+size_t	offset	=	src[ip]	|	(src[ip+1]	<<	8);
+ip	+=	2;
+if	(offset	==	0	||	offset	>	op)
+return	false;
+size_t	ml	=	token	&	15;
+if	(ml	==	15)
+{
+unsigned	char	b;
+do
+{
+if	(ip	>=	n)
+return	false;
+b	=	src[ip++];
+ml	+=	b;
+}	while	(b	==	255);
+}
+ml	+=	4;
+if	(ml	>	out_n	-	op)
+return	false;
+const	unsigned	char	*m	=	dst	+	op	-	offset;
+if	(offset	>=	ml)
+std::memcpy(dst	+	op,	m,	ml);
+else
+for	(size_t	i=0;	i<ml;	++i)	//	overlapping,	repeats	the	last	offset	bytes
+dst[op	+	i]	=	m[i];
+op	+=	ml;
+}
+return	op	==	out_n;
 }
 
-//	used	to	iterate	over	links	in	the	group,	up	to	size()
-std::string	get_link_name(hsize_t	idx)	const
+/*
+Chunk	format	of	the	shuffle	+	LZ	filter:	a	12	byte	header,	then	the	payload.
+The	header	holds	a	version	byte,	flags	(bit	0:	shuffled,	bit	1:	compressed),
+the	element	size	as	16	bit	and	the	raw	size	as	64	bit	little	endian	number.
+Data	which	does	not	compress	is	stored	uncompressed,	elements	larger	than
+64	KiB	are	not	shuffled.
+*/
+enum	{	SHUFFLE_LZ_HEADER	=	12,	SHUFFLE_LZ_SHUFFLED	=	1,	SHUFFLE_LZ_COMPRESSED	=	2	};
+
+inline	void	shuffle_lz_encode(const	unsigned	char	*src,	size_t	n,	size_t	elem_size,	std::vector<unsigned	char>	&out,	std::vector<unsigned	char>	&tmp)
 {
-char	buffer[4096];
-ssize_t	n	=	H5Lget_name_by_idx(this->id,	".",	H5_INDEX_NAME,	H5_ITER_NATIVE,	(hsize_t)idx,	buffer,	4096	H5P_DEFAULT);
-if	(n	<	0)
-throw	Exception("cannot	get	name	of	link	in	group");
-return	std::string(buffer,	n);
+unsigned	char	flags	=	0;
+if	(elem_size	>	1	&&	elem_size	<=	0xffff)
+{
+tmp.resize(n);
+shuffle(src,	tmp.data(),	n,	elem_size);
+src	=	tmp.data();
+flags	|=	SHUFFLE_LZ_SHUFFLED;
 }
-
-Group	create_group(const	std::string	&name)
+out.assign(SHUFFLE_LZ_HEADER,	0);
+lz_compress(src,	n,	out);
+if	(out.size()	-	SHUFFLE_LZ_HEADER	<	n)
+flags	|=	SHUFFLE_LZ_COMPRESSED;
+else
 {
-return	Group(this->id,	name.c_str(),	H5P_DEFAULT,	H5P_DEFAULT,	H5P_DEFAULT,	internal::TagCreate());
+out.resize(SHUFFLE_LZ_HEADER);
+out.insert(out.end(),	src,	src	+	n);
+}
+out[0]	=	1;
+out[1]	=	flags;
+out[2]	=	(unsigned	char)elem_size;
+out[3]	=	(unsigned	char)(elem_size	>>	8);
+for	(int	b=0;	b<8;	++b)
+out[4	+	b]	=	(unsigned	char)((uint64_t)n	>>	(8	*	b));
+}
+
+inline	bool	shuffle_lz_decode(const	unsigned	char	*src,	size_t	n,	std::vector<unsigned	char>	&out,	std::vector<unsigned	char>	&tmp)
+{
+if	(n	<	SHUFFLE_LZ_HEADER	||	src[0]	!=	1)
+return	false;
+const	unsigned	char	flags	=	src[1];
+const	size_t	elem_size	=	src[2]	|	(src[3]	<<	8);
+uint64_t	raw	=	0;
+for	(int	b=0;	b<8;	++b)
+raw	|=	(uint64_t)src[4	+	b]	<<	(8	*	b);
+if	(raw	>	std::numeric_limits<size_t>::max())
+return	false;
+const	unsigned	char	*payload	=	src	+	SHUFFLE_LZ_HEADER;
+const	size_t	payload_size	=	n	-	SHUFFLE_LZ_HEADER;
+std::vector<unsigned	char>	&plain	=	(flags	&	SHUFFLE_LZ_SHUFFLED)	?	tmp	:	out;
+plain.resize(raw);
+if	(flags	&	SHUFFLE_LZ_COMPRESSED)
+{
+if	(!lz_decompress(payload,	payload_size,	plain.data(),	raw))
+return	false;
 }
-
-Group	open_group(const	std::string	&name)
+else
 {
-return	Group(this->id,	name.c_str(),	H5P_DEFAULT,	internal::TagOpen());
+if	(payload_size	!=	raw)
+return	false;
+std::memcpy(plain.data(),	payload,	raw);
+}
+if	(flags	&	SHUFFLE_LZ_SHUFFLED)
+{
+out.resize(raw);
+unshuffle(tmp.data(),	out.data(),	raw,	elem_size);
+}
+return	true;
 }
 
-Group	require_group(const	std::string	&name,	bool	*had_group	=	NULL)
+//	the	filter	function	for	H5Zregister
+inline	size_t	shuffle_lz_filter(unsigned	int	flags,	size_t	cd_nelmts,	const	unsigned	int	cd_values[],	size_t	nbytes,	size_t	*buf_size,	void	**buf)
 {
-if	(exists(name))
+std::vector<unsigned	char>	out,	tmp;
+try
 {
-if	(had_group)	*had_group	=	true;
-return	open_group(name);
+const	unsigned	char	*src	=	static_cast<const	unsigned	char*>(*buf);
+if	(flags	&	H5Z_FLAG_REVERSE)
+{
+if	(!shuffle_lz_decode(src,	nbytes,	out,	tmp))
+return	0;
 }
 else
+shuffle_lz_encode(src,	nbytes,	cd_nelmts	>	0	?	cd_values[0]	:	1,	out,	tmp);
+}
+catch	(...)
 {
-if	(had_group)	*had_group	=	false;
-return	create_group(name);
+return	0;
 }
+void	*res	=	H5allocate_memory(std::max<size_t>(out.size(),	1),	false);
+if	(!res)
+return	0;
+std::memcpy(res,	out.data(),	out.size());
+H5free_memory(*buf);
+*buf	=	res;
+*buf_size	=	std::max<size_t>(out.size(),	1);
+return	out.size();
 }
 
-Attributes	attrs()
+//	stores	the	element	size	of	the	dataset	type	as	the	filter's	only	parameter
+inline	herr_t	shuffle_lz_set_local(hid_t	dcpl_id,	hid_t	type_id,	hid_t)
 {
-return	Attributes(*this);
+unsigned	int	flags;
+size_t	cd_nelmts	=	0;
+if	(H5Pget_filter_by_id2(dcpl_id,	HDF_WRAPPER_SHUFFLE_LZ_FILTER_ID,	&flags,	&cd_nelmts,	NULL,	0,	NULL,	NULL)	<	0)
+return	-1;
+size_t	size	=	H5Tget_size(type_id);
+if	(size	==	0)
+return	-1;
+unsigned	int	cd_values[1]	=	{	(unsigned	int)size	};
+return	H5Pmodify_filter(dcpl_id,	HDF_WRAPPER_SHUFFLE_LZ_FILTER_ID,	flags,	1,	cd_values);
 }
 
-Dataset	open_dataset(const	std::string	&name);
-
-#ifdef	HDF_WRAPPER_HAS_BOOST
-boost::optional<Dataset>	try_open_dataset(const	std::string	&name);
-#endif
+}	//	namespace	internal
 
-void	remove(const	std::string	&name)
-{
-herr_t	err	=	H5Ldelete(get_id(),	name.c_str(),	H5P_DEFAULT);
-if	(err	<	0)
-throw	Exception("cannot	remove	link	from	group");
+/*
+Register	the	shuffle	+	LZ	filter	with	the	library.	Done	by	Properties::shuffle_lz
+and	when	opening	files	through	File;	call	it	before	reading	such	files	through
+other	means.
+*/
+inline	void	register_shuffle_lz_filter()
+{
+//	a	function	local	static	is	initialized	once,	even	if	several	threads	get	here
+static	const	bool	done	=	[]()
+{
+static	const	H5Z_class2_t	cls	=	{
+H5Z_CLASS_T_VERS,
+(H5Z_filter_t)HDF_WRAPPER_SHUFFLE_LZ_FILTER_ID,
+1,	1,
+"h5cpp	shuffle+lz",
+NULL,
+internal::shuffle_lz_set_local,
+internal::shuffle_lz_filter
+};
+if	(H5Zregister(&cls)	<	0)
+throw	Exception("cannot	register	shuffle+lz	filter");
+return	true;
+}();
+(void)done;
 }
 
-iterator	begin();
-iterator	end();
-};
 
 
+/*--------------------------------------------------
+*	fast	type	conversions
+*	------------------------------------------------	*/
+
 /*
-TODO:	i	probably	want	an	iterator	that	returns	Object	references.	Objects	because
-items	in	groups	can	be	datasets	or	other	groups.	For	this	to	be	usefull,
-i	need	a	mechanism	to	cast	Object	to	derived	classes.
+Replacements	for	the	library's	conversion	functions	between	common	numeric
+types:	float	<->	double,	widening	and	narrowing	of	integers	of	the	same
+signedness,	and	byte	order	swaps	of	16,	32	and	64	bit	numbers.	Out	of	range
+values	are	handled	like	the	library	does	by	default:	integers	saturate,	floats
+become	infinite.	Exception	callbacks	set	by	H5Pset_type_conv_cb	are	honored.
+Registered	by	register_fast_conversions.	Further	down,	conversions	between
+float	or	double	and	16	bit	floats,	registered	by	register_half_conversions.
 */
-class	iterator	:	public	std::iterator<std::bidirectional_iterator_tag,	std::string>
+
+namespace	internal
 {
-hssize_t	idx;
-Group	g;
-friend	class	Group;
-iterator(hssize_t	idx_,	Group	g_)	:	idx(idx_),	g(g_)	{}
-public:
-iterator()	:	idx(std::numeric_limits<int>::max())	{}
-iterator&	operator++()	{	++idx;	return	*this;	}
-iterator&	operator--()	{	--idx;	return	*this;	}
-iterator	operator++(int)	{	auto	tmp	=	*this;	++idx;	return	tmp;	}
-iterator	operator--(int)	{	auto	tmp	=	*this;	--idx;	return	tmp;	}
-bool	operator==(const	iterator	&other)	const	{	return	other.idx	==	idx;	assert(other.g.is_same(g));	}
-bool	operator!=(const	iterator	&other)	const	{	return	!(*this	==	other);	}
-std::string	dereference()	const
+
+#ifdef	HDF_WRAPPER_X86_SIMD
+inline	bool	cpu_has_avx512f()
 {
-return	g.get_link_name(idx);
+static	const	bool	res	=	__builtin_cpu_supports("avx512f");
+return	res;
 }
-std::string	operator*()	const	{	return	dereference();	}
-};
-
 
-inline	iterator	Group::begin()
+inline	bool	cpu_has_avx512bw()
 {
-return	iterator(0,	*this);
+static	const	bool	res	=	__builtin_cpu_supports("avx512f")	&&	__builtin_cpu_supports("avx512bw");
+return	res;
 }
 
-inline	iterator	Group::end()
+/*
+The	kernels	below	convert	n	elements	from	src	to	dst,	which	must	not	overlap,
+and	return	the	number	of	elements	done;	the	caller	does	the	rest.	Before
+narrowing	to	float,	doubles	beyond	the	float	range	are	made	infinite,	like
+convert_value	and	the	library	do,	since	rounding	would	map	those	just	above
+it	to	FLT_MAX;	NaNs	compare	false	and	pass	unchanged.
+*/
+__attribute__((target("avx2")))
+inline	__m256d	clamp_to_float_avx2(__m256d	x)
 {
-return	iterator(this->size(),	*this);
+const	__m256d	max	=	_mm256_set1_pd(std::numeric_limits<float>::max()),	inf	=	_mm256_set1_pd(std::numeric_limits<double>::infinity());
+x	=	_mm256_blendv_pd(x,	inf,	_mm256_cmp_pd(x,	max,	_CMP_GT_OQ));
+return	_mm256_blendv_pd(x,	_mm256_sub_pd(_mm256_setzero_pd(),	inf),	_mm256_cmp_pd(x,	_mm256_sub_pd(_mm256_setzero_pd(),	max),	_CMP_LT_OQ));
 }
 
-
-class	File	:	public	Object
+__attribute__((target("avx512f")))
+inline	__m512d	clamp_to_float_avx512(__m512d	x)
 {
-File(hid_t	id,	internal::NoIncRC)	:	Object(id)	{}	//	takes	a	file	handle	that	needs	to	be	closed.
-friend	class	Object;	//	because	Object	need	to	construct	File	using	the	above	constructor.
-public:
-explicit	File(hid_t	id)	:	Object()	{	this->inc_ref();	}	//	a	logical	copy	of	the	original	given	by	id,
+const	__m512d	max	=	_mm512_set1_pd(std::numeric_limits<float>::max()),	inf	=	_mm512_set1_pd(std::numeric_limits<double>::infinity());
+x	=	_mm512_mask_mov_pd(x,	_mm512_cmp_pd_mask(x,	max,	_CMP_GT_OQ),	inf);
+return	_mm512_mask_mov_pd(x,	_mm512_cmp_pd_mask(x,	_mm512_sub_pd(_mm512_setzero_pd(),	max),	_CMP_LT_OQ),	_mm512_sub_pd(_mm512_setzero_pd(),	inf));
+}
 
-/*
-w	=	create	or	truncate	existing	file
-a	=	append	to	file	or	create	new	file
-r	=	read	only;	file	must	exist
-w-	=	new	file;	file	must	not	already	exist
-r+	=	read/write;	file	must	exist
-*/
-File(const	std::string	&name,	const	std::string	openmode	=	"w")	:	Object()
+__attribute__((target("avx2")))
+inline	size_t	double_to_float_avx2(const	unsigned	char	*src,	unsigned	char	*dst,	size_t	n)
 {
-bool	call_open	=	true;
-unsigned	int	flags;
-if	(openmode	==	"w")
+size_t	i	=	0;
+for	(;	i+8<=n;	i+=8)
 {
-flags	=	H5F_ACC_TRUNC;
-call_open	=	false;
+__m128	lo	=	_mm256_cvtpd_ps(clamp_to_float_avx2(_mm256_loadu_pd((const	double*)(src	+	8	*	i))));
+__m128	hi	=	_mm256_cvtpd_ps(clamp_to_float_avx2(_mm256_loadu_pd((const	double*)(src	+	8	*	i	+	32))));
+_mm_storeu_ps((float*)(dst	+	4	*	i),	lo);
+_mm_storeu_ps((float*)(dst	+	4	*	i	+	16),	hi);
 }
-else	if	(openmode	==	"a")	//	append	at	existing	file	or	create	new	file
+return	i;
+}
+
+__attribute__((target("avx2")))
+inline	size_t	float_to_double_avx2(const	unsigned	char	*src,	unsigned	char	*dst,	size_t	n)
 {
-if	(H5Fis_hdf5(name.c_str())>0)	//	file	exists,	so	open
+size_t	i	=	0;
+for	(;	i+8<=n;	i+=8)
 {
-call_open	=	true;
-flags	=	H5F_ACC_RDWR;
+__m256d	lo	=	_mm256_cvtps_pd(_mm_loadu_ps((const	float*)(src	+	4	*	i)));
+__m256d	hi	=	_mm256_cvtps_pd(_mm_loadu_ps((const	float*)(src	+	4	*	i	+	16)));
+_mm256_storeu_pd((double*)(dst	+	8	*	i),	lo);
+_mm256_storeu_pd((double*)(dst	+	8	*	i	+	32),	hi);
 }
-else	//	create	file
+return	i;
+}
+
+//	GCC	12	warns	about	the	undefined	merge	source	inside	many	AVX-512	intrinsics
+#pragma	GCC	diagnostic	push
+#pragma	GCC	diagnostic	ignored	"-Wmaybe-uninitialized"
+__attribute__((target("avx512f")))
+inline	size_t	double_to_float_avx512(const	unsigned	char	*src,	unsigned	char	*dst,	size_t	n)
 {
-call_open	=	false;
-flags	=	H5F_ACC_TRUNC;
+size_t	i	=	0;
+for	(;	i+16<=n;	i+=16)
+{
+__m256	lo	=	_mm512_cvtpd_ps(clamp_to_float_avx512(_mm512_loadu_pd(src	+	8	*	i)));
+__m256	hi	=	_mm512_cvtpd_ps(clamp_to_float_avx512(_mm512_loadu_pd(src	+	8	*	i	+	64)));
+_mm256_storeu_ps((float*)(dst	+	4	*	i),	lo);
+_mm256_storeu_ps((float*)(dst	+	4	*	i	+	32),	hi);
 }
+return	i;
 }
-else	if	(openmode	==	"w-")
+
+__attribute__((target("avx512f")))
+inline	size_t	float_to_double_avx512(const	unsigned	char	*src,	unsigned	char	*dst,	size_t	n)
 {
-flags	=	H5F_ACC_EXCL;
-call_open	=	false;
+size_t	i	=	0;
+for	(;	i+16<=n;	i+=16)
+{
+__m512d	lo	=	_mm512_cvtps_pd(_mm256_loadu_ps((const	float*)(src	+	4	*	i)));
+__m512d	hi	=	_mm512_cvtps_pd(_mm256_loadu_ps((const	float*)(src	+	4	*	i	+	32)));
+_mm512_storeu_pd(dst	+	8	*	i,	lo);
+_mm512_storeu_pd(dst	+	8	*	i	+	64,	hi);
 }
-else	if	(openmode	==	"r")
-flags	=	H5F_ACC_RDONLY;
-else	if	(openmode	==	"r+")
-flags	=	H5F_ACC_RDWR;
-else
-throw	Exception("bad	openmode:	"	+	openmode);
-if	(call_open)
-this->id	=	H5Fopen(name.c_str(),	flags	,	H5P_DEFAULT);
-else
-this->id	=	H5Fcreate(name.c_str(),	flags	,	H5P_DEFAULT,	H5P_DEFAULT);
-if	(this->id	<	0)
-throw	Exception("unable	to	open	file:	"	+	name);
+return	i;
 }
+#pragma	GCC	diagnostic	pop
 
-File()	:	Object()	{}
-
-void	open(const	std::string	&name,	const	std::string	openmode	=	"w")
+//	reverses	the	bytes	of	each	N	byte	element;	the	shuffle	works	within	128	bit	lanes,	which	N	divides
+template<size_t	N>
+__attribute__((target("avx2")))
+inline	size_t	swap_bytes_avx2(const	unsigned	char	*src,	unsigned	char	*dst,	size_t	n)
 {
-this->~File();
-new	(this)	File(name,	openmode);
+unsigned	char	m[32];
+for	(size_t	k=0;	k<32;	++k)
+m[k]	=	(unsigned	char)(k	-	k	%	N	+	N	-	1	-	k	%	N);
+const	__m256i	mask	=	_mm256_loadu_si256((const	__m256i*)m);
+const	size_t	step	=	32	/	N;
+size_t	i	=	0;
+for	(;	i+step<=n;	i+=step)
+_mm256_storeu_si256((__m256i*)(dst	+	N	*	i),	_mm256_shuffle_epi8(_mm256_loadu_si256((const	__m256i*)(src	+	N	*	i)),	mask));
+return	i;
 }
 
-void	close()
+template<size_t	N>
+__attribute__((target("avx512f,avx512bw")))
+inline	size_t	swap_bytes_avx512(const	unsigned	char	*src,	unsigned	char	*dst,	size_t	n)
 {
-if	(this->id	==	-1)	return;
-herr_t	err	=	H5Fclose(this->id);
-this->id	=	-1;
-if	(err	<	0)
-throw	Exception("unable	to	close	file");
+unsigned	char	m[64];
+for	(size_t	k=0;	k<64;	++k)
+m[k]	=	(unsigned	char)(k	-	k	%	N	+	N	-	1	-	k	%	N);
+const	__m512i	mask	=	_mm512_loadu_si512(m);
+const	size_t	step	=	64	/	N;
+size_t	i	=	0;
+for	(;	i+step<=n;	i+=step)
+_mm512_storeu_si512(dst	+	N	*	i,	_mm512_shuffle_epi8(_mm512_loadu_si512(src	+	N	*	i),	mask));
+return	i;
 }
 
-Group	root()
+//	loads	of	the	16,	8	or	4	bytes	that	widen	to	one	256	bit	register
+__attribute__((target("avx2")))
+inline	__m128i	load_bytes16(const	unsigned	char	*p)
 {
-return	Group(this->id,	"/",	H5P_DEFAULT,	internal::TagOpen());
+return	_mm_loadu_si128((const	__m128i*)p);
 }
 
-void	flush()
+__attribute__((target("avx2")))
+inline	__m128i	load_bytes8(const	unsigned	char	*p)
 {
-herr_t	err	=	H5Fflush(this->id,	H5F_SCOPE_LOCAL);
-if	(err	<	0)
-throw	Exception("unable	to	flush	file");
+return	_mm_loadl_epi64((const	__m128i*)p);
 }
-};
-
 
+__attribute__((target("avx2")))
+inline	__m128i	load_bytes4(const	unsigned	char	*p)
+{
+int	v;
+std::memcpy(&v,	p,	4);
+return	_mm_cvtsi32_si128(v);
+}
 
-inline	File	Object::get_file()	const
+template<class	S,	class	D>
+inline	size_t	widen_avx2(const	unsigned	char	*,	unsigned	char	*,	size_t,	S*,	D*)
 {
-hid_t	fid	=	H5Iget_file_id(id);	//	it	seems	to	increase	the	reference	count	by	its	own.	(The	returned	id
-//	https://www.hdfgroup.org/HDF5/doc/RM/RM_H5I.html#Identify-GetFileId
-if	(fid	<	0)
-throw	Exception("cannot	get	file	id	from	object");
-return	File(fid,	internal::NoIncRC());
+return	0;
 }
 
+#define	HDF_WRAPPER_WIDEN_AVX2(S,	D,	load,	cvt)	\
+__attribute__((target("avx2")))	\
+inline	size_t	widen_avx2(const	unsigned	char	*src,	unsigned	char	*dst,	size_t	n,	S*,	D*)	\
+{	\
+const	size_t	step	=	32	/	sizeof(D);	\
+size_t	i	=	0;	\
+for	(;	i+step<=n;	i+=step)	\
+_mm256_storeu_si256((__m256i*)(dst	+	sizeof(D)	*	i),	cvt(load(src	+	sizeof(S)	*	i)));	\
+return	i;	\
+}
+
+HDF_WRAPPER_WIDEN_AVX2(int8_t,	int16_t,	load_bytes16,	_mm256_cvtepi8_epi16)
+HDF_WRAPPER_WIDEN_AVX2(int8_t,	int32_t,	load_bytes8,	_mm256_cvtepi8_epi32)
+HDF_WRAPPER_WIDEN_AVX2(int8_t,	int64_t,	load_bytes4,	_mm256_cvtepi8_epi64)
+HDF_WRAPPER_WIDEN_AVX2(int16_t,	int32_t,	load_bytes16,	_mm256_cvtepi16_epi32)
+HDF_WRAPPER_WIDEN_AVX2(int16_t,	int64_t,	load_bytes8,	_mm256_cvtepi16_epi64)
+HDF_WRAPPER_WIDEN_AVX2(int32_t,	int64_t,	load_bytes16,	_mm256_cvtepi32_epi64)
+HDF_WRAPPER_WIDEN_AVX2(uint8_t,	uint16_t,	load_bytes16,	_mm256_cvtepu8_epi16)
+HDF_WRAPPER_WIDEN_AVX2(uint8_t,	uint32_t,	load_bytes8,	_mm256_cvtepu8_epi32)
+HDF_WRAPPER_WIDEN_AVX2(uint8_t,	uint64_t,	load_bytes4,	_mm256_cvtepu8_epi64)
+HDF_WRAPPER_WIDEN_AVX2(uint16_t,	uint32_t,	load_bytes16,	_mm256_cvtepu16_epi32)
+HDF_WRAPPER_WIDEN_AVX2(uint16_t,	uint64_t,	load_bytes8,	_mm256_cvtepu16_epi64)
+HDF_WRAPPER_WIDEN_AVX2(uint32_t,	uint64_t,	load_bytes16,	_mm256_cvtepu32_epi64)
+
+#undef	HDF_WRAPPER_WIDEN_AVX2
 
-enum	DsCreationFlags
+/*
+Saturating	narrowing	with	AVX2,	for	the	pairs	that	have	packing	instructions.
+The	packs	work	within	128	bit	lanes,	so	the	halves	are	put	back	in	order	after.
+*/
+template<class	S,	class	D>
+inline	size_t	narrow_avx2(const	unsigned	char	*,	unsigned	char	*,	size_t,	S*,	D*)
 {
-CREATE_DS_0	=	0
-CREATE_DS_COMPRESSED	=	1
-CREATE_DS_CHUNKED	=	2
-#ifndef	HDF_WRAPPER_DS_CREATION_DEFAULT_FLAGS
-#ifdef	H5_HAVE_FILTER_DEFLATE
-CREATE_DS_DEFAULT	=	CREATE_DS_COMPRESSED
-#else
-CREATE_DS_DEFAULT	=	CREATE_DS_0
-#endif
-#else
-CREATE_DS_DEFAULT	=	HDF_WRAPPER_DS_CREATION_DEFAULT_FLAGS
-#endif
-};
-
+return	0;
+}
 
+__attribute__((target("avx2")))
+inline	size_t	narrow_avx2(const	unsigned	char	*src,	unsigned	char	*dst,	size_t	n,	int32_t*,	int16_t*)
+{
+size_t	i	=	0;
+for	(;	i+16<=n;	i+=16)
+{
+__m256i	a	=	_mm256_loadu_si256((const	__m256i*)(src	+	4	*	i));
+__m256i	b	=	_mm256_loadu_si256((const	__m256i*)(src	+	4	*	i	+	32));
+_mm256_storeu_si256((__m256i*)(dst	+	2	*	i),	_mm256_permute4x64_epi64(_mm256_packs_epi32(a,	b),	0xd8));
+}
+return	i;
+}
 
+__attribute__((target("avx2")))
+inline	size_t	narrow_avx2(const	unsigned	char	*src,	unsigned	char	*dst,	size_t	n,	uint32_t*,	uint16_t*)
+{
+const	__m256i	max	=	_mm256_set1_epi32(0xffff);
+size_t	i	=	0;
+for	(;	i+16<=n;	i+=16)
+{
+__m256i	a	=	_mm256_min_epu32(_mm256_loadu_si256((const	__m256i*)(src	+	4	*	i)),	max);
+__m256i	b	=	_mm256_min_epu32(_mm256_loadu_si256((const	__m256i*)(src	+	4	*	i	+	32)),	max);
+_mm256_storeu_si256((__m256i*)(dst	+	2	*	i),	_mm256_permute4x64_epi64(_mm256_packus_epi32(a,	b),	0xd8));
+}
+return	i;
+}
 
+__attribute__((target("avx2")))
+inline	size_t	narrow_avx2(const	unsigned	char	*src,	unsigned	char	*dst,	size_t	n,	int16_t*,	int8_t*)
+{
+size_t	i	=	0;
+for	(;	i+32<=n;	i+=32)
+{
+__m256i	a	=	_mm256_loadu_si256((const	__m256i*)(src	+	2	*	i));
+__m256i	b	=	_mm256_loadu_si256((const	__m256i*)(src	+	2	*	i	+	32));
+_mm256_storeu_si256((__m256i*)(dst	+	i),	_mm256_permute4x64_epi64(_mm256_packs_epi16(a,	b),	0xd8));
+}
+return	i;
+}
 
-class	Dataset	:	public	Object
+__attribute__((target("avx2")))
+inline	size_t	narrow_avx2(const	unsigned	char	*src,	unsigned	char	*dst,	size_t	n,	uint16_t*,	uint8_t*)
 {
-friend	class	Group;
-private:
-Dataset(hid_t	loc_id,	const	std::string	&name,	hid_t	dapl_id,	internal::TagOpen)
+const	__m256i	max	=	_mm256_set1_epi16(0xff);
+size_t	i	=	0;
+for	(;	i+32<=n;	i+=32)
 {
-this->id	=	H5Dopen2(loc_id,	name.c_str(),	dapl_id);
-if	(this->id	<	0)
-throw	Exception("unable	to	open	dataset:	"+name);
+__m256i	a	=	_mm256_min_epu16(_mm256_loadu_si256((const	__m256i*)(src	+	2	*	i)),	max);
+__m256i	b	=	_mm256_min_epu16(_mm256_loadu_si256((const	__m256i*)(src	+	2	*	i	+	32)),	max);
+_mm256_storeu_si256((__m256i*)(dst	+	i),	_mm256_permute4x64_epi64(_mm256_packus_epi16(a,	b),	0xd8));
+}
+return	i;
 }
 
-template<class	T>
-void	write(Dataspace	memspace,	hid_t	disk_space_id,	const	T*	data)
+//	no	packing	for	64	bit	elements:	clamp	with	compares,	then	gather	the	low	halves
+__attribute__((target("avx2")))
+inline	size_t	narrow_avx2(const	unsigned	char	*src,	unsigned	char	*dst,	size_t	n,	int64_t*,	int32_t*)
 {
-Datatype	memtype	=	get_memtype<T>();
-RWdataset	rw(get_id(),	memtype.get_id(),	memspace.get_id(),	disk_space_id);
-h5traits_of<T>::type::write(rw,	memtype,	memspace,	data);
+const	__m256i	hi	=	_mm256_set1_epi64x(std::numeric_limits<int32_t>::max());
+const	__m256i	lo	=	_mm256_set1_epi64x(std::numeric_limits<int32_t>::min());
+const	__m256i	low_halves	=	_mm256_setr_epi32(0,	2,	4,	6,	1,	3,	5,	7);
+size_t	i	=	0;
+for	(;	i+8<=n;	i+=8)
+{
+__m256i	r[2];
+for	(int	k=0;	k<2;	++k)
+{
+__m256i	a	=	_mm256_loadu_si256((const	__m256i*)(src	+	8	*	i	+	32	*	k));
+a	=	_mm256_blendv_epi8(a,	hi,	_mm256_cmpgt_epi64(a,	hi));
+a	=	_mm256_blendv_epi8(a,	lo,	_mm256_cmpgt_epi64(lo,	a));
+r[k]	=	_mm256_permutevar8x32_epi32(a,	low_halves);
+}
+_mm256_storeu_si256((__m256i*)(dst	+	4	*	i),	_mm256_permute2x128_si256(r[0],	r[1],	0x20));
+}
+return	i;
 }
 
-template<class	T>
-void	read(Dataspace	memspace,	hid_t	disk_space_id,	T*	data)	const
+//	there	is	no	unsigned	64	bit	compare	either;	flipping	the	sign	bits	makes	the	signed	one	work
+__attribute__((target("avx2")))
+inline	size_t	narrow_avx2(const	unsigned	char	*src,	unsigned	char	*dst,	size_t	n,	uint64_t*,	uint32_t*)
 {
-Datatype	memtype	=	get_memtype<T>();
-RWdataset	rw(get_id(),	memtype.get_id(),	memspace.get_id(),	disk_space_id);
-h5traits_of<T>::type::read(rw,	memtype,	memspace,	data);
+const	__m256i	sign	=	_mm256_set1_epi64x((long	long)0x8000000000000000ull);
+const	__m256i	max	=	_mm256_set1_epi64x(0xffffffffll);
+const	__m256i	biased_max	=	_mm256_xor_si256(max,	sign);
+const	__m256i	low_halves	=	_mm256_setr_epi32(0,	2,	4,	6,	1,	3,	5,	7);
+size_t	i	=	0;
+for	(;	i+8<=n;	i+=8)
+{
+__m256i	r[2];
+for	(int	k=0;	k<2;	++k)
+{
+__m256i	a	=	_mm256_loadu_si256((const	__m256i*)(src	+	8	*	i	+	32	*	k));
+a	=	_mm256_blendv_epi8(a,	max,	_mm256_cmpgt_epi64(_mm256_xor_si256(a,	sign),	biased_max));
+r[k]	=	_mm256_permutevar8x32_epi32(a,	low_halves);
+}
+_mm256_storeu_si256((__m256i*)(dst	+	4	*	i),	_mm256_permute2x128_si256(r[0],	r[1],	0x20));
+}
+return	i;
 }
 
-Dataset(hid_t	id,	internal::NoIncRC)	:	Object(id)	{}	//	we	get	an	existing	reference,	no	need	to	increase	the	ref
+//	AVX-512	has	saturating	down	conversions	for	every	pair;	they	are	tried	first	and	fall	back	to	AVX2
+#define	HDF_WRAPPER_NARROW(S,	D,	isa,	has_isa,	cvt_store)	\
+__attribute__((target(isa)))	\
+inline	size_t	narrow_avx512(const	unsigned	char	*src,	unsigned	char	*dst,	size_t	n,	S*,	D*)	\
+{	\
+const	size_t	step	=	64	/	sizeof(S);	\
+size_t	i	=	0;	\
+for	(;	i+step<=n;	i+=step)	\
+cvt_store(dst	+	sizeof(D)	*	i,	-1,	_mm512_loadu_si512(src	+	sizeof(S)	*	i));	\
+return	i;	\
+}	\
+inline	size_t	simd_convert(const	unsigned	char	*src,	unsigned	char	*dst,	size_t	n,	S*,	D*)	\
+{	\
+return	has_isa()	?	narrow_avx512(src,	dst,	n,	(S*)0,	(D*)0)	:	cpu_has_avx2()	?	narrow_avx2(src,	dst,	n,	(S*)0,	(D*)0)	:	0;	\
+}
 
-public:
-Dataset()	:	Object()	{}
-explicit	Dataset(hid_t	id)	:	Object(id)	{	Object::inc_ref();	}	//	we	manage	the	new	reference
+HDF_WRAPPER_NARROW(int16_t,	int8_t,	"avx512f,avx512bw",	cpu_has_avx512bw,	_mm512_mask_cvtsepi16_storeu_epi8)
+HDF_WRAPPER_NARROW(int32_t,	int8_t,	"avx512f",	cpu_has_avx512f,	_mm512_mask_cvtsepi32_storeu_epi8)
+HDF_WRAPPER_NARROW(int32_t,	int16_t,	"avx512f",	cpu_has_avx512f,	_mm512_mask_cvtsepi32_storeu_epi16)
+HDF_WRAPPER_NARROW(int64_t,	int8_t,	"avx512f",	cpu_has_avx512f,	_mm512_mask_cvtsepi64_storeu_epi8)
+HDF_WRAPPER_NARROW(int64_t,	int16_t,	"avx512f",	cpu_has_avx512f,	_mm512_mask_cvtsepi64_storeu_epi16)
+HDF_WRAPPER_NARROW(int64_t,	int32_t,	"avx512f",	cpu_has_avx512f,	_mm512_mask_cvtsepi64_storeu_epi32)
+HDF_WRAPPER_NARROW(uint16_t,	uint8_t,	"avx512f,avx512bw",	cpu_has_avx512bw,	_mm512_mask_cvtusepi16_storeu_epi8)
+HDF_WRAPPER_NARROW(uint32_t,	uint8_t,	"avx512f",	cpu_has_avx512f,	_mm512_mask_cvtusepi32_storeu_epi8)
+HDF_WRAPPER_NARROW(uint32_t,	uint16_t,	"avx512f",	cpu_has_avx512f,	_mm512_mask_cvtusepi32_storeu_epi16)
+HDF_WRAPPER_NARROW(uint64_t,	uint8_t,	"avx512f",	cpu_has_avx512f,	_mm512_mask_cvtusepi64_storeu_epi8)
+HDF_WRAPPER_NARROW(uint64_t,	uint16_t,	"avx512f",	cpu_has_avx512f,	_mm512_mask_cvtusepi64_storeu_epi16)
+HDF_WRAPPER_NARROW(uint64_t,	uint32_t,	"avx512f",	cpu_has_avx512f,	_mm512_mask_cvtusepi64_storeu_epi32)
 
-static	Dataset	create(Group	group,	const	std::string	&name,	const	Datatype&	dtype,	const	Dataspace	&space,	const	Properties	&prop)
-{
-hid_t	id	=	H5Dcreate2(group.get_id(),	name.c_str(),
-dtype.get_id(),	space.get_id(),
-H5P_DEFAULT,	prop.get_id(),	H5P_DEFAULT);
-if	(id	<	0)
-throw	Exception("error	creating	dataset:	"+name);
-return	Dataset(id,	internal::NoIncRC());
-}
+#undef	HDF_WRAPPER_NARROW
 
-template<class	T>
-static	Dataset	create(Group	group,	const	std::string	&name,	const	Dataspace	&space,	DsCreationFlags	flags	=	CREATE_DS_DEFAULT)
+inline	size_t	simd_convert(const	unsigned	char	*src,	unsigned	char	*dst,	size_t	n,	double*,	float*)
 {
-return	Dataset::create(group,	name,	get_disktype<T>(),	space,	create_creation_properties(space,	flags));
+return	cpu_has_avx512f()	?	double_to_float_avx512(src,	dst,	n)	:	cpu_has_avx2()	?	double_to_float_avx2(src,	dst,	n)	:	0;
 }
 
-template<class	T>
-void	write(const	Dataspace	&mem_space,	const	Dataspace	&file_space,	const	T*	data)
+inline	size_t	simd_convert(const	unsigned	char	*src,	unsigned	char	*dst,	size_t	n,	float*,	double*)
 {
-write(mem_space,	file_space.get_id(),	data);
+return	cpu_has_avx512f()	?	float_to_double_avx512(src,	dst,	n)	:	cpu_has_avx2()	?	float_to_double_avx2(src,	dst,	n)	:	0;
 }
 
-template<class	T>
-void	write(const	T*	data)
+//	the	remaining	pairs	are	widening	ones
+template<class	S,	class	D>
+inline	size_t	simd_convert(const	unsigned	char	*src,	unsigned	char	*dst,	size_t	n,	S*,	D*)
 {
-Dataspace	ds	=	get_dataspace();
-write(ds,	H5S_ALL,	data);
+return	cpu_has_avx2()	?	widen_avx2(src,	dst,	n,	(S*)0,	(D*)0)	:	0;
 }
 
-static	Properties	create_creation_properties(const	Dataspace	&sp,	DsCreationFlags	flags)
+template<size_t	N>
+inline	size_t	simd_swap_bytes(const	unsigned	char	*src,	unsigned	char	*dst,	size_t	n)
 {
+return	cpu_has_avx512bw()	?	swap_bytes_avx512<N>(src,	dst,	n)	:	cpu_has_avx2()	?	swap_bytes_avx2<N>(src,	dst,	n)	:	0;
+}
+#else
+template<class	S,	class	D>
+inline	size_t	simd_convert(const	unsigned	char	*,	unsigned	char	*,	size_t,	S*,	D*)
+{
+return	0;
+}
+
+template<size_t	N>
+inline	size_t	simd_swap_bytes(const	unsigned	char	*,	unsigned	char	*,	size_t)
+{
+return	0;
+}
+#endif
+
+//	1	if	v	is	above	the	range	of	D,	-1	if	below,	0	otherwise
+template<class	D,	class	S>
+inline	int	out_of_range(S	v,	std::true_type)	//	floating	point
+{
+return	v	>	S(std::numeric_limits<D>::max())	?	1	:	v	<	S(std::numeric_limits<D>::lowest())	?	-1	:	0;
+}
+
+template<class	D,	class	S>
+inline	int	out_of_range(S	v,	std::false_type)	//	integers
+{
+if	(std::numeric_limits<S>::is_signed)
+{
+int64_t	w	=	int64_t(v);
+if	(w	<	int64_t(std::numeric_limits<D>::min()))
+return	-1;
+return	w	>	0	&&	uint64_t(w)	>	uint64_t(std::numeric_limits<D>::max())	?	1	:	0;
+}
+return	uint64_t(v)	>	uint64_t(std::numeric_limits<D>::max())	?	1	:	0;
+}
+
+template<class	D,	class	S>
+inline	int	out_of_range(S	v)
+{
+return	out_of_range<D>(v,	typename	std::is_floating_point<S>::type());
+}
+
+//	what	the	library	stores	for	values	out	of	range	when	there	is	no	exception	callback
+template<class	D,	class	S>
+inline	D	convert_value(S	v)
+{
+typedef	std::numeric_limits<D>	lim;
+int	r	=	out_of_range<D>(v);
+if	(r	>	0)
+return	lim::has_infinity	?	lim::infinity()	:	lim::max();
+if	(r	<	0)
+return	lim::has_infinity	?	-lim::infinity()	:	lim::lowest();
+return	D(v);
+}
+
+template<class	S,	class	D>
+struct	ConvertKernel
+{
+enum	{	src_size	=	sizeof(S),	dst_size	=	sizeof(D)	};
+
+static	void	run(const	unsigned	char	*src,	unsigned	char	*dst,	size_t	n)
+{
+size_t	i	=	simd_convert(src,	dst,	n,	(S*)0,	(D*)0);
+for	(;	i<n;	++i)
+{
+S	v;
+std::memcpy(&v,	src	+	sizeof(S)	*	i,	sizeof(S));
+D	r	=	convert_value<D>(v);
+std::memcpy(dst	+	sizeof(D)	*	i,	&r,	sizeof(D));
+}
+}
+};
+
+template<size_t	N>
+struct	SwapKernel
+{
+enum	{	src_size	=	N,	dst_size	=	N	};
+
+static	void	run(const	unsigned	char	*src,	unsigned	char	*dst,	size_t	n)
+{
+for	(size_t	i=simd_swap_bytes<N>(src,	dst,	n);	i<n;	++i)
+for	(size_t	b=0;	b<N;	++b)
+dst[N	*	i	+	b]	=	src[N	*	i	+	N	-	1	-	b];
+}
+};
+
+/*
+Runs	kernel	K	over	a	conversion	buffer,	which	holds	the	input	and	receives	the
+output	in	place.	Each	block	is	copied	out	first	so	that	the	kernels	never	see
+overlapping	input	and	output.	When	the	output	elements	are	larger,	blocks	are
+done	back	to	front	so	that	no	input	is	overwritten	before	it	is	copied.	With	a
+buffer	stride,	elements	are	gathered	and	scattered	one	at	a	time.
+*/
+template<class	K>
+inline	void	convert_buffer(unsigned	char	*buf,	size_t	n,	size_t	stride)
+{
+const	size_t	block	=	512;
+unsigned	char	in[block	*	8],	out[block	*	8];
+const	bool	backward	=	stride	==	0	&&	K::dst_size	>	K::src_size;
+const	size_t	num_blocks	=	(n	+	block	-	1)	/	block;
+for	(size_t	k=0;	k<num_blocks;	++k)
+{
+const	size_t	first	=	(backward	?	num_blocks	-	1	-	k	:	k)	*	block;
+const	size_t	cnt	=	std::min(block,	n	-	first);
+if	(stride	==	0)
+{
+std::memcpy(in,	buf	+	K::src_size	*	first,	K::src_size	*	cnt);
+K::run(in,	buf	+	K::dst_size	*	first,	cnt);
+}
+else
+{
+for	(size_t	i=0;	i<cnt;	++i)
+std::memcpy(in	+	K::src_size	*	i,	buf	+	stride	*	(first	+	i),	K::src_size);
+K::run(in,	out,	cnt);
+for	(size_t	i=0;	i<cnt;	++i)
+std::memcpy(buf	+	stride	*	(first	+	i),	out	+	K::dst_size	*	i,	K::dst_size);
+}
+}
+}
+
+/*
+Element	by	element	conversion	that	calls	the	exception	callback	for	values	out
+of	range.	Only	used	for	narrowing	conversions,	so	going	front	to	back	in	place
+is	safe.
+*/
+template<class	S,	class	D>
+inline	herr_t	convert_with_callback(hid_t	src_id,	hid_t	dst_id,	unsigned	char	*buf,	size_t	n,	size_t	stride,	H5T_conv_except_func_t	op,	void	*op_data)
+{
+for	(size_t	i=0;	i<n;	++i)
+{
+S	v;
+D	r;
+std::memcpy(&v,	buf	+	(stride	?	stride	:	sizeof(S))	*	i,	sizeof(S));
+int	range	=	out_of_range<D>(v);
+H5T_conv_ret_t	ret	=	H5T_CONV_UNHANDLED;
+if	(range	!=	0)
+ret	=	op(range	>	0	?	H5T_CONV_EXCEPT_RANGE_HI	:	H5T_CONV_EXCEPT_RANGE_LOW,	src_id,	dst_id,	&v,	&r,	op_data);
+if	(ret	==	H5T_CONV_ABORT)
+return	-1;
+if	(ret	==	H5T_CONV_UNHANDLED)
+r	=	convert_value<D>(v);
+std::memcpy(buf	+	(stride	?	stride	:	sizeof(D))	*	i,	&r,	sizeof(D));
+}
+return	0;
+}
+
+//	conversion	function	for	H5Tregister
+template<class	S,	class	D>
+inline	herr_t	convert_numbers(hid_t	src_id,	hid_t	dst_id,	H5T_cdata_t	*cdata,	size_t	nelmts,	size_t	buf_stride,	size_t,	void	*buf,	void	*,	hid_t	dxpl)
+{
+switch	(cdata->command)
+{
+case	H5T_CONV_INIT:
+cdata->need_bkg	=	H5T_BKG_NO;
+return	H5Tget_size(src_id)	==	sizeof(S)	&&	H5Tget_size(dst_id)	==	sizeof(D)	?	0	:	-1;
+case	H5T_CONV_CONV:
+{
+H5T_conv_except_func_t	op	=	NULL;
+void	*op_data	=	NULL;
+if	(sizeof(D)	<	sizeof(S)	&&	dxpl	!=	H5P_DEFAULT	&&	H5Pget_type_conv_cb(dxpl,	&op,	&op_data)	<	0)
+return	-1;
+if	(op)
+return	convert_with_callback<S,	D>(src_id,	dst_id,	(unsigned	char*)buf,	nelmts,	buf_stride,	op,	op_data);
+convert_buffer<ConvertKernel<S,	D>	>((unsigned	char*)buf,	nelmts,	buf_stride);
+return	0;
+}
+default:
+return	0;
+}
+}
+
+template<size_t	N>
+inline	herr_t	swap_byte_order(hid_t	src_id,	hid_t	dst_id,	H5T_cdata_t	*cdata,	size_t	nelmts,	size_t	buf_stride,	size_t,	void	*buf,	void	*,	hid_t)
+{
+switch	(cdata->command)
+{
+case	H5T_CONV_INIT:
+cdata->need_bkg	=	H5T_BKG_NO;
+return	H5Tget_size(src_id)	==	N	&&	H5Tget_size(dst_id)	==	N	?	0	:	-1;
+case	H5T_CONV_CONV:
+convert_buffer<SwapKernel<N>	>((unsigned	char*)buf,	nelmts,	buf_stride);
+return	0;
+default:
+return	0;
+}
+}
+
+inline	void	register_conversion(const	char	*name,	hid_t	src,	hid_t	dst,	H5T_conv_t	func)
+{
+if	(H5Tregister(H5T_PERS_HARD,	name,	src,	dst,	func)	<	0)
+throw	Exception(std::string("cannot	register	conversion	")	+	name);
+}
+
+template<class	S,	class	D>
+inline	void	register_conversions(const	char	*name,	const	char	*reverse_name,	hid_t	src,	hid_t	dst)
+{
+register_conversion(name,	src,	dst,	convert_numbers<S,	D>);
+register_conversion(reverse_name,	dst,	src,	convert_numbers<D,	S>);
+}
+
+template<size_t	N>
+inline	void	register_swaps(const	char	*name,	hid_t	native,	hid_t	swapped)
+{
+register_conversion(name,	native,	swapped,	swap_byte_order<N>);
+register_conversion(name,	swapped,	native,	swap_byte_order<N>);
+}
+
+/*
+16	bit	floats,	see	Datatype::createFloat16	and	createBFloat16.	Both	are
+converted	to	and	from	float	in	registers;	double	goes	through	float,	which
+rounds	the	same	as	converting	directly	since	float	has	more	than	twice	the
+mantissa	bits.
+*/
+#ifdef	HDF_WRAPPER_X86_SIMD
+inline	bool	cpu_has_f16c()
+{
+static	const	bool	res	=	__builtin_cpu_supports("avx")	&&	__builtin_cpu_supports("f16c");
+return	res;
+}
+
+__attribute__((target("avx,f16c")))
+inline	size_t	half_to_float_f16c(const	unsigned	char	*src,	unsigned	char	*dst,	size_t	n)
+{
+size_t	i	=	0;
+for	(;	i+8<=n;	i+=8)
+_mm256_storeu_ps((float*)(dst	+	4	*	i),	_mm256_cvtph_ps(_mm_loadu_si128((const	__m128i*)(src	+	2	*	i))));
+return	i;
+}
+
+__attribute__((target("avx,f16c")))
+inline	size_t	float_to_half_f16c(const	unsigned	char	*src,	unsigned	char	*dst,	size_t	n)
+{
+size_t	i	=	0;
+for	(;	i+8<=n;	i+=8)
+_mm_storeu_si128((__m128i*)(dst	+	2	*	i),	_mm256_cvtps_ph(_mm256_loadu_ps((const	float*)(src	+	4	*	i)),	_MM_FROUND_TO_NEAREST_INT	|	_MM_FROUND_NO_EXC));
+return	i;
+}
+
+//	see	double_to_float_avx512
+#pragma	GCC	diagnostic	push
+#pragma	GCC	diagnostic	ignored	"-Wmaybe-uninitialized"
+__attribute__((target("avx512f")))
+inline	size_t	half_to_float_avx512(const	unsigned	char	*src,	unsigned	char	*dst,	size_t	n)
+{
+size_t	i	=	0;
+for	(;	i+16<=n;	i+=16)
+_mm512_storeu_ps(dst	+	4	*	i,	_mm512_cvtph_ps(_mm256_loadu_si256((const	__m256i*)(src	+	2	*	i))));
+return	i;
+}
+
+__attribute__((target("avx512f")))
+inline	size_t	float_to_half_avx512(const	unsigned	char	*src,	unsigned	char	*dst,	size_t	n)
+{
+size_t	i	=	0;
+for	(;	i+16<=n;	i+=16)
+_mm256_storeu_si256((__m256i*)(dst	+	2	*	i),	_mm512_cvtps_ph(_mm512_loadu_ps(src	+	4	*	i),	_MM_FROUND_TO_NEAREST_INT	|	_MM_FROUND_NO_EXC));
+return	i;
+}
+#pragma	GCC	diagnostic	pop
+
+//	bfloat16	is	the	upper	half	of	a	float,	so	there	are	no	conversion	instructions	needed	except	for	rounding
+__attribute__((target("avx2")))
+inline	size_t	bfloat16_to_float_avx2(const	unsigned	char	*src,	unsigned	char	*dst,	size_t	n)
+{
+size_t	i	=	0;
+for	(;	i+8<=n;	i+=8)
+_mm256_storeu_si256((__m256i*)(dst	+	4	*	i),	_mm256_slli_epi32(_mm256_cvtepu16_epi32(_mm_loadu_si128((const	__m128i*)(src	+	2	*	i))),	16));
+return	i;
+}
+
+//	rounds	to	nearest	even	by	adding	0x7fff	plus	the	lowest	kept	bit;	NaNs	are	truncated	and	made	quiet
+__attribute__((target("avx2")))
+inline	size_t	float_to_bfloat16_avx2(const	unsigned	char	*src,	unsigned	char	*dst,	size_t	n)
+{
+const	__m256i	one	=	_mm256_set1_epi32(1),	round	=	_mm256_set1_epi32(0x7fff),	quiet	=	_mm256_set1_epi32(0x40);
+const	__m256i	abs_mask	=	_mm256_set1_epi32(0x7fffffff),	inf	=	_mm256_set1_epi32(0x7f800000);
+size_t	i	=	0;
+for	(;	i+16<=n;	i+=16)
+{
+__m256i	r[2];
+for	(int	k=0;	k<2;	++k)
+{
+__m256i	x	=	_mm256_loadu_si256((const	__m256i*)(src	+	4	*	i	+	32	*	k));
+__m256i	upper	=	_mm256_srli_epi32(x,	16);
+__m256i	rounded	=	_mm256_srli_epi32(_mm256_add_epi32(x,	_mm256_add_epi32(round,	_mm256_and_si256(upper,	one))),	16);
+__m256i	nan	=	_mm256_cmpgt_epi32(_mm256_and_si256(x,	abs_mask),	inf);
+r[k]	=	_mm256_blendv_epi8(rounded,	_mm256_or_si256(upper,	quiet),	nan);
+}
+_mm256_storeu_si256((__m256i*)(dst	+	2	*	i),	_mm256_permute4x64_epi64(_mm256_packus_epi32(r[0],	r[1]),	0xd8));
+}
+return	i;
+}
+
+#pragma	GCC	diagnostic	push
+#pragma	GCC	diagnostic	ignored	"-Wmaybe-uninitialized"
+__attribute__((target("avx512f")))
+inline	size_t	bfloat16_to_float_avx512(const	unsigned	char	*src,	unsigned	char	*dst,	size_t	n)
+{
+size_t	i	=	0;
+for	(;	i+16<=n;	i+=16)
+_mm512_storeu_si512(dst	+	4	*	i,	_mm512_slli_epi32(_mm512_cvtepu16_epi32(_mm256_loadu_si256((const	__m256i*)(src	+	2	*	i))),	16));
+return	i;
+}
+
+__attribute__((target("avx512f")))
+inline	size_t	float_to_bfloat16_avx512(const	unsigned	char	*src,	unsigned	char	*dst,	size_t	n)
+{
+const	__m512i	one	=	_mm512_set1_epi32(1),	round	=	_mm512_set1_epi32(0x7fff),	quiet	=	_mm512_set1_epi32(0x40);
+const	__m512i	abs_mask	=	_mm512_set1_epi32(0x7fffffff),	inf	=	_mm512_set1_epi32(0x7f800000);
+size_t	i	=	0;
+for	(;	i+16<=n;	i+=16)
+{
+__m512i	x	=	_mm512_loadu_si512(src	+	4	*	i);
+__m512i	upper	=	_mm512_srli_epi32(x,	16);
+__m512i	rounded	=	_mm512_srli_epi32(_mm512_add_epi32(x,	_mm512_add_epi32(round,	_mm512_and_si512(upper,	one))),	16);
+__mmask16	nan	=	_mm512_cmpgt_epi32_mask(_mm512_and_si512(x,	abs_mask),	inf);
+_mm256_storeu_si256((__m256i*)(dst	+	2	*	i),	_mm512_cvtepi32_epi16(_mm512_mask_blend_epi32(nan,	rounded,	_mm512_or_si512(upper,	quiet))));
+}
+return	i;
+}
+#pragma	GCC	diagnostic	pop
+#endif
+
+struct	Float16Format
+{
+static	float	decode(uint16_t	h)
+{
+uint32_t	sign	=	uint32_t(h	&	0x8000)	<<	16,	exponent	=	(h	>>	10)	&	0x1f,	mantissa	=	h	&	0x3ff,	bits;
+if	(exponent	==	0x1f)
+bits	=	sign	|	0x7f800000	|	(mantissa	?	0x400000	|	(mantissa	<<	13)	:	0);
+else	if	(exponent)
+bits	=	sign	|	((exponent	+	112)	<<	23)	|	(mantissa	<<	13);
+else	if	(mantissa)	//	subnormal,	becomes	a	normal	float
+{
+int	shift	=	0;
+for	(;	!(mantissa	&	0x400);	++shift)
+mantissa	<<=	1;
+bits	=	sign	|	uint32_t(113	-	shift)	<<	23	|	(mantissa	&	0x3ff)	<<	13;
+}
+else
+bits	=	sign;
+float	f;
+std::memcpy(&f,	&bits,	4);
+return	f;
+}
+
+static	uint16_t	encode(float	f)
+{
+uint32_t	x;
+std::memcpy(&x,	&f,	4);
+uint16_t	sign	=	uint16_t((x	>>	16)	&	0x8000);
+uint32_t	a	=	x	&	0x7fffffff;
+if	(a	>	0x7f800000)
+return	sign	|	0x7e00	|	((a	>>	13)	&	0x3ff);
+if	(a	>=	0x477ff000)	//	rounds	to	more	than	65504
+return	sign	|	0x7c00;
+if	(a	>=	0x38800000)	//	normal:	rebias	the	exponent,	round	the	mantissa	to	nearest	even
+return	sign	|	uint16_t((a	-	(112u	<<	23)	+	0xfff	+	((a	>>	13)	&	1))	>>	13);
+if	(a	<	0x33000000)	//	less	than	half	the	smallest	subnormal
+return	sign;
+uint32_t	mantissa	=	(a	&	0x7fffff)	|	0x800000,	shift	=	126	-	(a	>>	23);
+uint32_t	r	=	mantissa	>>	shift,	rest	=	mantissa	&	((1u	<<	shift)	-	1),	half	=	1u	<<	(shift	-	1);
+if	(rest	>	half	||	(rest	==	half	&&	(r	&	1)))
+++r;
+return	sign	|	uint16_t(r);
+}
+
+static	bool	is_infinite(uint16_t	h)
+{
+return	(h	&	0x7fff)	==	0x7c00;
+}
+
+static	size_t	simd_decode(const	unsigned	char	*src,	unsigned	char	*dst,	size_t	n)
+{
+#ifdef	HDF_WRAPPER_X86_SIMD
+return	cpu_has_avx512f()	?	half_to_float_avx512(src,	dst,	n)	:	cpu_has_f16c()	?	half_to_float_f16c(src,	dst,	n)	:	0;
+#else
+return	0;
+#endif
+}
+
+static	size_t	simd_encode(const	unsigned	char	*src,	unsigned	char	*dst,	size_t	n)
+{
+#ifdef	HDF_WRAPPER_X86_SIMD
+return	cpu_has_avx512f()	?	float_to_half_avx512(src,	dst,	n)	:	cpu_has_f16c()	?	float_to_half_f16c(src,	dst,	n)	:	0;
+#else
+return	0;
+#endif
+}
+};
+
+struct	BFloat16Format
+{
+static	float	decode(uint16_t	h)
+{
+uint32_t	bits	=	uint32_t(h)	<<	16;
+float	f;
+std::memcpy(&f,	&bits,	4);
+return	f;
+}
+
+static	uint16_t	encode(float	f)
+{
+uint32_t	x;
+std::memcpy(&x,	&f,	4);
+if	((x	&	0x7fffffff)	>	0x7f800000)
+return	uint16_t((x	>>	16)	|	0x40);
+return	uint16_t((x	+	0x7fff	+	((x	>>	16)	&	1))	>>	16);
+}
+
+static	bool	is_infinite(uint16_t	h)
+{
+return	(h	&	0x7fff)	==	0x7f80;
+}
+
+static	size_t	simd_decode(const	unsigned	char	*src,	unsigned	char	*dst,	size_t	n)
+{
+#ifdef	HDF_WRAPPER_X86_SIMD
+return	cpu_has_avx512f()	?	bfloat16_to_float_avx512(src,	dst,	n)	:	cpu_has_avx2()	?	bfloat16_to_float_avx2(src,	dst,	n)	:	0;
+#else
+return	0;
+#endif
+}
+
+static	size_t	simd_encode(const	unsigned	char	*src,	unsigned	char	*dst,	size_t	n)
+{
+#ifdef	HDF_WRAPPER_X86_SIMD
+return	cpu_has_avx512f()	?	float_to_bfloat16_avx512(src,	dst,	n)	:	cpu_has_avx2()	?	float_to_bfloat16_avx2(src,	dst,	n)	:	0;
+#else
+return	0;
+#endif
+}
+};
+
+template<class	F>
+inline	void	decode_halves(const	unsigned	char	*src,	unsigned	char	*dst,	size_t	n)
+{
+for	(size_t	i=F::simd_decode(src,	dst,	n);	i<n;	++i)
+{
+uint16_t	h;
+std::memcpy(&h,	src	+	2	*	i,	2);
+float	f	=	F::decode(h);
+std::memcpy(dst	+	4	*	i,	&f,	4);
+}
+}
+
+template<class	F>
+inline	void	encode_halves(const	unsigned	char	*src,	unsigned	char	*dst,	size_t	n)
+{
+for	(size_t	i=F::simd_encode(src,	dst,	n);	i<n;	++i)
+{
+float	f;
+std::memcpy(&f,	src	+	4	*	i,	4);
+uint16_t	h	=	F::encode(f);
+std::memcpy(dst	+	2	*	i,	&h,	2);
+}
+}
+
+//	between	float	and	the	type	D	that	the	halves	are	converted	from	or	to
+inline	void	from_float(const	unsigned	char	*src,	unsigned	char	*dst,	size_t	n,	float*)
+{
+std::memcpy(dst,	src,	4	*	n);
+}
+
+inline	void	from_float(const	unsigned	char	*src,	unsigned	char	*dst,	size_t	n,	double*)
+{
+ConvertKernel<float,	double>::run(src,	dst,	n);
+}
+
+inline	void	to_float(const	unsigned	char	*src,	unsigned	char	*dst,	size_t	n,	float*)
+{
+std::memcpy(dst,	src,	4	*	n);
+}
+
+inline	void	to_float(const	unsigned	char	*src,	unsigned	char	*dst,	size_t	n,	double*)
+{
+ConvertKernel<double,	float>::run(src,	dst,	n);
+}
+
+template<class	F,	class	D>
+struct	FromHalfKernel
+{
+enum	{	src_size	=	2,	dst_size	=	sizeof(D)	};
+
+static	void	run(const	unsigned	char	*src,	unsigned	char	*dst,	size_t	n)
+{
+if	(std::is_same<D,	float>::value)
+return	decode_halves<F>(src,	dst,	n);
+const	size_t	block	=	512;
+unsigned	char	tmp[block	*	4];
+for	(size_t	i=0;	i<n;	i+=block)
+{
+size_t	cnt	=	std::min(block,	n	-	i);
+decode_halves<F>(src	+	2	*	i,	tmp,	cnt);
+from_float(tmp,	dst	+	sizeof(D)	*	i,	cnt,	(D*)0);
+}
+}
+};
+
+template<class	F,	class	D>
+struct	ToHalfKernel
+{
+enum	{	src_size	=	sizeof(D),	dst_size	=	2	};
+
+static	void	run(const	unsigned	char	*src,	unsigned	char	*dst,	size_t	n)
+{
+if	(std::is_same<D,	float>::value)
+return	encode_halves<F>(src,	dst,	n);
+const	size_t	block	=	512;
+unsigned	char	tmp[block	*	4];
+for	(size_t	i=0;	i<n;	i+=block)
+{
+size_t	cnt	=	std::min(block,	n	-	i);
+to_float(src	+	sizeof(D)	*	i,	tmp,	cnt,	(D*)0);
+encode_halves<F>(tmp,	dst	+	2	*	i,	cnt);
+}
+}
+};
+
+template<class	F,	class	D>
+inline	herr_t	convert_from_half(hid_t	src_id,	hid_t	dst_id,	H5T_cdata_t	*cdata,	size_t	nelmts,	size_t	buf_stride,	size_t,	void	*buf,	void	*,	hid_t)
+{
+switch	(cdata->command)
+{
+case	H5T_CONV_INIT:
+cdata->need_bkg	=	H5T_BKG_NO;
+return	H5Tget_size(src_id)	==	2	&&	H5Tget_size(dst_id)	==	sizeof(D)	?	0	:	-1;
+case	H5T_CONV_CONV:
+convert_buffer<FromHalfKernel<F,	D>	>((unsigned	char*)buf,	nelmts,	buf_stride);
+return	0;
+default:
+return	0;
+}
+}
+
+//	finite	values	that	become	infinite	are	out	of	range,	like	in	convert_with_callback
+template<class	F,	class	D>
+inline	herr_t	convert_to_half_with_callback(hid_t	src_id,	hid_t	dst_id,	unsigned	char	*buf,	size_t	n,	size_t	stride,	H5T_conv_except_func_t	op,	void	*op_data)
+{
+for	(size_t	i=0;	i<n;	++i)
+{
+D	v;
+std::memcpy(&v,	buf	+	(stride	?	stride	:	sizeof(D))	*	i,	sizeof(D));
+uint16_t	r	=	F::encode(convert_value<float>(v));
+if	(F::is_infinite(r)	&&	std::isfinite(v))
+{
+H5T_conv_ret_t	ret	=	op(v	>	0	?	H5T_CONV_EXCEPT_RANGE_HI	:	H5T_CONV_EXCEPT_RANGE_LOW,	src_id,	dst_id,	&v,	&r,	op_data);
+if	(ret	==	H5T_CONV_ABORT)
+return	-1;
+}
+std::memcpy(buf	+	(stride	?	stride	:	2)	*	i,	&r,	2);
+}
+return	0;
+}
+
+template<class	F,	class	D>
+inline	herr_t	convert_to_half(hid_t	src_id,	hid_t	dst_id,	H5T_cdata_t	*cdata,	size_t	nelmts,	size_t	buf_stride,	size_t,	void	*buf,	void	*,	hid_t	dxpl)
+{
+switch	(cdata->command)
+{
+case	H5T_CONV_INIT:
+cdata->need_bkg	=	H5T_BKG_NO;
+return	H5Tget_size(src_id)	==	sizeof(D)	&&	H5Tget_size(dst_id)	==	2	?	0	:	-1;
+case	H5T_CONV_CONV:
+{
+H5T_conv_except_func_t	op	=	NULL;
+void	*op_data	=	NULL;
+if	(dxpl	!=	H5P_DEFAULT	&&	H5Pget_type_conv_cb(dxpl,	&op,	&op_data)	<	0)
+return	-1;
+if	(op)
+return	convert_to_half_with_callback<F,	D>(src_id,	dst_id,	(unsigned	char*)buf,	nelmts,	buf_stride,	op,	op_data);
+convert_buffer<ToHalfKernel<F,	D>	>((unsigned	char*)buf,	nelmts,	buf_stride);
+return	0;
+}
+default:
+return	0;
+}
+}
+
+template<class	F>
+inline	void	register_half_conversions(const	char	*names[4],	const	Datatype	&half)
+{
+register_conversion(names[0],	half.get_id(),	H5T_NATIVE_FLOAT,	convert_from_half<F,	float>);
+register_conversion(names[1],	H5T_NATIVE_FLOAT,	half.get_id(),	convert_to_half<F,	float>);
+register_conversion(names[2],	half.get_id(),	H5T_NATIVE_DOUBLE,	convert_from_half<F,	double>);
+register_conversion(names[3],	H5T_NATIVE_DOUBLE,	half.get_id(),	convert_to_half<F,	double>);
+}
+
+}	//	namespace	internal
+
+/*
+Register	the	conversions	above	with	the	library,	replacing	its	own	for	these
+type	pairs.	Since	the	library	matches	conversion	functions	by	type	properties,
+they	also	apply	to	the	standard	types,	e.g.	H5T_STD_I64LE	->	H5T_NATIVE_INT	on
+little	endian	machines.	Done	when	opening	files	through	File	on	machines	with
+AVX2	or	AVX-512	code	paths,	unless	HDF_WRAPPER_NO_FAST_CONVERSIONS	is	defined.
+*/
+inline	void	register_fast_conversions()
+{
+static	const	bool	done	=	[]()
+{
+using	internal::register_conversions;
+using	internal::register_swaps;
+register_conversions<float,	double>("h5cpp	float->double",	"h5cpp	double->float",	H5T_NATIVE_FLOAT,	H5T_NATIVE_DOUBLE);
+
+register_conversions<int8_t,	int16_t>("h5cpp	int8->int16",	"h5cpp	int16->int8",	H5T_NATIVE_INT8,	H5T_NATIVE_INT16);
+register_conversions<int8_t,	int32_t>("h5cpp	int8->int32",	"h5cpp	int32->int8",	H5T_NATIVE_INT8,	H5T_NATIVE_INT32);
+register_conversions<int8_t,	int64_t>("h5cpp	int8->int64",	"h5cpp	int64->int8",	H5T_NATIVE_INT8,	H5T_NATIVE_INT64);
+register_conversions<int16_t,	int32_t>("h5cpp	int16->int32",	"h5cpp	int32->int16",	H5T_NATIVE_INT16,	H5T_NATIVE_INT32);
+register_conversions<int16_t,	int64_t>("h5cpp	int16->int64",	"h5cpp	int64->int16",	H5T_NATIVE_INT16,	H5T_NATIVE_INT64);
+register_conversions<int32_t,	int64_t>("h5cpp	int32->int64",	"h5cpp	int64->int32",	H5T_NATIVE_INT32,	H5T_NATIVE_INT64);
+register_conversions<uint8_t,	uint16_t>("h5cpp	uint8->uint16",	"h5cpp	uint16->uint8",	H5T_NATIVE_UINT8,	H5T_NATIVE_UINT16);
+register_conversions<uint8_t,	uint32_t>("h5cpp	uint8->uint32",	"h5cpp	uint32->uint8",	H5T_NATIVE_UINT8,	H5T_NATIVE_UINT32);
+register_conversions<uint8_t,	uint64_t>("h5cpp	uint8->uint64",	"h5cpp	uint64->uint8",	H5T_NATIVE_UINT8,	H5T_NATIVE_UINT64);
+register_conversions<uint16_t,	uint32_t>("h5cpp	uint16->uint32",	"h5cpp	uint32->uint16",	H5T_NATIVE_UINT16,	H5T_NATIVE_UINT32);
+register_conversions<uint16_t,	uint64_t>("h5cpp	uint16->uint64",	"h5cpp	uint64->uint16",	H5T_NATIVE_UINT16,	H5T_NATIVE_UINT64);
+register_conversions<uint32_t,	uint64_t>("h5cpp	uint32->uint64",	"h5cpp	uint64->uint32",	H5T_NATIVE_UINT32,	H5T_NATIVE_UINT64);
+
+const	bool	little_endian	=	H5Tget_order(H5T_NATIVE_INT)	==	H5T_ORDER_LE;
+register_swaps<2>("h5cpp	swap	int16",	H5T_NATIVE_INT16,	little_endian	?	H5T_STD_I16BE	:	H5T_STD_I16LE);
+register_swaps<2>("h5cpp	swap	uint16",	H5T_NATIVE_UINT16,	little_endian	?	H5T_STD_U16BE	:	H5T_STD_U16LE);
+register_swaps<4>("h5cpp	swap	int32",	H5T_NATIVE_INT32,	little_endian	?	H5T_STD_I32BE	:	H5T_STD_I32LE);
+register_swaps<4>("h5cpp	swap	uint32",	H5T_NATIVE_UINT32,	little_endian	?	H5T_STD_U32BE	:	H5T_STD_U32LE);
+register_swaps<8>("h5cpp	swap	int64",	H5T_NATIVE_INT64,	little_endian	?	H5T_STD_I64BE	:	H5T_STD_I64LE);
+register_swaps<8>("h5cpp	swap	uint64",	H5T_NATIVE_UINT64,	little_endian	?	H5T_STD_U64BE	:	H5T_STD_U64LE);
+register_swaps<4>("h5cpp	swap	float",	H5T_NATIVE_FLOAT,	little_endian	?	H5T_IEEE_F32BE	:	H5T_IEEE_F32LE);
+register_swaps<8>("h5cpp	swap	double",	H5T_NATIVE_DOUBLE,	little_endian	?	H5T_IEEE_F64BE	:	H5T_IEEE_F64LE);
+return	true;
+}();
+(void)done;
+}
+
+
+/*
+Register	conversions	between	the	16	bit	float	types	and	float	or	double.	The
+library's	own,	used	otherwise,	work	bit	by	bit	and	are	very	slow.	Done	when
+opening	files	through	File,	unless	HDF_WRAPPER_NO_FAST_CONVERSIONS	is	defined.
+*/
+inline	void	register_half_conversions()
+{
+static	const	bool	done	=	[]()
+{
+const	H5T_order_t	order	=	H5Tget_order(H5T_NATIVE_FLOAT);
+const	char	*f16_names[4]	=	{	"h5cpp	float16->float",	"h5cpp	float->float16",	"h5cpp	float16->double",	"h5cpp	double->float16"	};
+const	char	*bf16_names[4]	=	{	"h5cpp	bfloat16->float",	"h5cpp	float->bfloat16",	"h5cpp	bfloat16->double",	"h5cpp	double->bfloat16"	};
+internal::register_half_conversions<internal::Float16Format>(f16_names,	Datatype::createFloat16(order));
+internal::register_half_conversions<internal::BFloat16Format>(bf16_names,	Datatype::createBFloat16(order));
+return	true;
+}();
+(void)done;
+}
+
+//	alignment	of	buffers	and	of	objects	in	files	for	direct	I/O,	see	File::direct	and	AlignedAllocator
+#ifndef	HDF_WRAPPER_DIRECT_IO_ALIGNMENT
+#define	HDF_WRAPPER_DIRECT_IO_ALIGNMENT	4096
+#endif
+
+class	Properties	:	protected	Object
+{
+public:
+using	Object::get_id;
+using	Object::is_valid;
+using	Object::is_same;
+
+Properties(hid_t	cls_id)	:	Object()
+{
+this->id	=	H5Pcreate(cls_id);
+if	(this->id	<	0)
+throw	Exception("error	creating	property	list");
+}
+Properties(hid_t	id,	internal::NoIncRC)	:	Object(id)	{}	//	takes	a	property	list	handle,	e.g.	from	H5Dget_create_plist
+
+Properties&	deflate(int	strength	=	9)
+{
+H5Pset_deflate(this->id,	strength);
+return	*this;
+};
+
+//	reorders	bytes	so	that	equally	significant	bytes	of	all	elements	are	adjacent;	use	before	compression
+Properties&	shuffle()
+{
+herr_t	err	=	H5Pset_shuffle(this->id);
+if	(err	<	0)
+throw	Exception("error	setting	shuffle	filter");
+return	*this;
+}
+
+/*
+The	built-in	shuffle	+	LZ	filter,	much	faster	than	shuffle()	with	deflate()	at
+a	somewhat	lower	ratio.	See	HDF_WRAPPER_SHUFFLE_LZ_FILTER_ID.
+*/
+Properties&	shuffle_lz()
+{
+register_shuffle_lz_filter();
+herr_t	err	=	H5Pset_filter(this->id,	HDF_WRAPPER_SHUFFLE_LZ_FILTER_ID,	H5Z_FLAG_OPTIONAL,	0,	NULL);
+if	(err	<	0)
+throw	Exception("error	setting	shuffle+lz	filter");
+return	*this;
+}
+
+//	stores	only	the	significant	bits	of	the	dataset's	type,	see	H5Tset_precision
+Properties&	nbit()
+{
+herr_t	err	=	H5Pset_nbit(this->id);
+if	(err	<	0)
+throw	Exception("error	setting	n-bit	filter");
+return	*this;
+}
+
+/*
+Scale-offset	filter.	For	floating	point	data	with	H5Z_SO_FLOAT_DSCALE,	factor
+is	the	number	of	decimal	digits	kept	after	the	point,	i.e.	lossy.	For	integers,
+H5Z_SO_INT	with	factor	=	H5Z_SO_INT_MINBITS_DEFAULT	is	lossless.
+*/
+Properties&	scaleoffset(H5Z_SO_scale_type_t	type,	int	factor)
+{
+herr_t	err	=	H5Pset_scaleoffset(this->id,	type,	factor);
+if	(err	<	0)
+throw	Exception("error	setting	scale-offset	filter");
+return	*this;
+}
+
+Properties&	chunked(int	rank,	const	hsize_t	*dims)
+{
+H5Pset_chunk(this->id,	rank,	dims);
+return	*this;
+}
+
+Properties&	chunked_with_estimated_size(const	Dataspace	&sp)
+{
+hsize_t	dims[H5S_MAX_RANK],	maxdims[H5S_MAX_RANK];
+int	r	=	sp.get_dims(dims);
+if	(r	>	0	&&	H5Sget_simple_extent_dims(sp.get_id(),	NULL,	maxdims)	<	0)
+throw	Exception("unable	to	get	dataspace	dimensions");
+hsize_t	cdims[H5S_MAX_RANK];
+for	(int	i=0;	i<r;	++i)
+{
+hsize_t	val	=	dims[i];
+hsize_t	org_val	=	val;
+val	=	(hsize_t)(val	*	0.1);
+if	(val	<	32.)
+val	=	32;
+if	(val	>	org_val	&&	(org_val	>	0	||	maxdims[i]	!=	H5S_UNLIMITED))	//	chunks	of	empty	unlimited	dimensions	keep	the	minimum
+val	=	org_val;
+cdims[i]	=	val;
+}
+return	chunked(r,	cdims);
+}
+
+//	value	of	unwritten	elements,	and	of	unmapped	or	missing	regions	of	virtual	datasets
+template<class	T>
+Properties&	fill_value(const	T	&value)
+{
+herr_t	err	=	H5Pset_fill_value(this->id,	get_memtype<T>().get_id(),	&value);
+if	(err	<	0)
+throw	Exception("error	setting	fill	value");
+return	*this;
+}
+
+//	when	storage	is	allocated:	H5D_ALLOC_TIME_EARLY,	_LATE	(on	first	write)	or	_INCR	(per	chunk)
+Properties&	alloc_time(H5D_alloc_time_t	t)
+{
+herr_t	err	=	H5Pset_alloc_time(this->id,	t);
+if	(err	<	0)
+throw	Exception("error	setting	allocation	time");
+return	*this;
+}
+
+//	H5D_FILL_TIME_NEVER	avoids	writing	fill	values	which	are	overwritten	anyway
+Properties&	fill_time(H5D_fill_time_t	t)
+{
+herr_t	err	=	H5Pset_fill_time(this->id,	t);
+if	(err	<	0)
+throw	Exception("error	setting	fill	time");
+return	*this;
+}
+
+//	data	is	stored	in	the	object	header;	only	for	small	datasets	(<	64	kB)
+Properties&	compact()
+{
+herr_t	err	=	H5Pset_layout(this->id,	H5D_COMPACT);
+if	(err	<	0)
+throw	Exception("error	setting	compact	layout");
+return	alloc_time(H5D_ALLOC_TIME_EARLY);	//	required	for	compact	datasets
+}
+
+//	use	the	compact	layout	if	the	dataset	takes	at	most	max_bytes;	returns	true	if	so
+bool	compact_if_smaller(const	Dataspace	&sp,	const	Datatype	&dtype,	size_t	max_bytes)
+{
+hssize_t	n	=	H5Sget_simple_extent_npoints(sp.get_id());	//	unlike	get_npoints,	allows	empty	extents
+if	(n	<	0)
+throw	Exception("unable	to	determine	number	of	elements	in	dataspace");
+if	((size_t)n	*	dtype.get_size()	>	max_bytes)
+return	false;
+//	compact	datasets	cannot	be	extendible
+hsize_t	dims[H5S_MAX_RANK],	maxdims[H5S_MAX_RANK];
+int	rank	=	H5Sget_simple_extent_dims(sp.get_id(),	dims,	maxdims);
+if	(rank	<	0)
+throw	Exception("unable	to	get	dataspace	dimensions");
+for	(int	i=0;	i<rank;	++i)
+if	(maxdims[i]	!=	dims[i])
+return	false;
+compact();
+return	true;
+}
+
+/*
+Object	header	tuning.	Attributes	are	stored	in	the	header	up	to	max_compact	of
+them,	and	moved	to	separate	dense	storage	above	min_dense.	A	small	max_compact
+keeps	headers	small	for	objects	carrying	many	or	large	attributes.
+*/
+Properties&	attribute_phase_change(unsigned	int	max_compact,	unsigned	int	min_dense)
+{
+herr_t	err	=	H5Pset_attr_phase_change(this->id,	max_compact,	min_dense);
+if	(err	<	0)
+throw	Exception("error	setting	attribute	phase	change");
+return	*this;
+}
+
+//	don't	record	access/modification	times	in	the	object	header
+Properties&	track_times(bool	on)
+{
+herr_t	err	=	H5Pset_obj_track_times(this->id,	on);
+if	(err	<	0)
+throw	Exception("error	setting	time	tracking");
+return	*this;
+}
+
+/*
+Group	creation:	links	are	stored	in	the	object	header	up	to	max_compact	of
+them,	and	in	dense	storage	(a	heap	indexed	by	a	B-tree	of	name	hashes)	above,
+until	they	drop	below	min_dense.	This	and	est_link_info	only	apply	to	new	style
+groups,	which	are	created	in	files	with	libver_bounds	low	>=	H5F_LIBVER_V18,
+or	with	link_creation_order;	otherwise	groups	are	old	style	symbol	tables.
+*/
+Properties&	link_phase_change(unsigned	int	max_compact,	unsigned	int	min_dense)
+{
+herr_t	err	=	H5Pset_link_phase_change(this->id,	max_compact,	min_dense);
+if	(err	<	0)
+throw	Exception("error	setting	link	phase	change");
+return	*this;
+}
+
+//	group	creation:	expected	number	of	links	and	length	of	their	names,	for	sizing	the	object	header
+Properties&	est_link_info(unsigned	int	est_num_entries,	unsigned	int	est_name_len)
+{
+herr_t	err	=	H5Pset_est_link_info(this->id,	est_num_entries,	est_name_len);
+if	(err	<	0)
+throw	Exception("error	setting	estimated	link	info");
+return	*this;
+}
+
+//	group	creation:	H5P_CRT_ORDER_TRACKED,	with	H5P_CRT_ORDER_INDEXED	also	for	fast	access	by	creation	order
+Properties&	link_creation_order(unsigned	int	flags)
+{
+herr_t	err	=	H5Pset_link_creation_order(this->id,	flags);
+if	(err	<	0)
+throw	Exception("error	setting	link	creation	order");
+return	*this;
+}
+
+//	link	creation:	create	the	missing	groups	on	the	path	of	a	new	object
+Properties&	create_intermediate_group(bool	on	=	true)
+{
+herr_t	err	=	H5Pset_create_intermediate_group(this->id,	on);
+if	(err	<	0)
+throw	Exception("error	setting	intermediate	group	creation");
+return	*this;
+}
+
+#if	H5_VERSION_GE(1,	10,	5)
+//	hint	that	the	dataset	gets	no	attributes,	which	allows	a	smaller	object	header
+Properties&	no_attributes_hint(bool	on	=	true)
+{
+herr_t	err	=	H5Pset_dset_no_attrs_hint(this->id,	on);
+if	(err	<	0)
+throw	Exception("error	setting	no-attributes	hint");
+return	*this;
+}
+#endif
+
+#if	H5_VERSION_GE(1,	10,	1)
+//	file	access:	evict	metadata	of	objects	from	the	cache	when	they	are	closed
+Properties&	evict_on_close(bool	on	=	true)
+{
+herr_t	err	=	H5Pset_evict_on_close(this->id,	on);
+if	(err	<	0)
+throw	Exception("error	setting	evict	on	close");
+return	*this;
+}
+#endif
+
+#if	H5_VERSION_GE(1,	10,	0)
+//	file	access:	log	metadata	cache	activity	to	location,	see	File::start_mdc_logging
+Properties&	mdc_logging(const	std::string	&location,	bool	start_on_access	=	false)
+{
+herr_t	err	=	H5Pset_mdc_log_options(this->id,	true,	location.c_str(),	start_on_access);
+if	(err	<	0)
+throw	Exception("error	setting	metadata	cache	logging");
+return	*this;
+}
+#endif
+
+//	dataset	access:	chunk	cache	of	the	dataset	handle;	nslots	should	be	a	prime	about	100	times	the	number	of	chunks	fitting	into	nbytes
+Properties&	chunk_cache(size_t	nslots,	size_t	nbytes,	double	w0	=	H5D_CHUNK_CACHE_W0_DEFAULT)
+{
+herr_t	err	=	H5Pset_chunk_cache(this->id,	nslots,	nbytes,	w0);
+if	(err	<	0)
+throw	Exception("error	setting	chunk	cache");
+return	*this;
+}
+
+#if	H5_VERSION_GE(1,	10,	1)
+//	file	access:	page	buffer,	for	files	created	with	the	paged	file	space	strategy
+Properties&	page_buffer_size(size_t	size,	unsigned	min_meta_percent	=	0,	unsigned	min_raw_percent	=	0)
+{
+herr_t	err	=	H5Pset_page_buffer_size(this->id,	size,	min_meta_percent,	min_raw_percent);
+if	(err	<	0)
+throw	Exception("error	setting	page	buffer	size");
+return	*this;
+}
+#endif
+
+//	file	access:	range	of	library	versions	whose	file	format	features	may	be	used
+Properties&	libver_bounds(H5F_libver_t	low,	H5F_libver_t	high)
+{
+herr_t	err	=	H5Pset_libver_bounds(this->id,	low,	high);
+if	(err	<	0)
+throw	Exception("error	setting	library	version	bounds");
+return	*this;
+}
+
+//	file	access:	objects	of	at	least	threshold	bytes	start	at	multiples	of	alignment	in	the	file
+Properties&	alignment(hsize_t	threshold,	hsize_t	alignment)
+{
+herr_t	err	=	H5Pset_alignment(this->id,	threshold,	alignment);
+if	(err	<	0)
+throw	Exception("error	setting	file	alignment");
+return	*this;
+}
+
+#ifdef	H5_HAVE_DIRECT
+/*
+file	access:	the	direct	driver,	which	bypasses	the	page	cache	with	O_DIRECT.
+Transfers	whose	buffer	address,	size	and	file	offset	are	multiples	of
+block_size	go	straight	to	user	memory,	others	through	a	copy	buffer	of
+cbuf_size	bytes.	Only	in	HDF5	builds	with	--enable-direct-vfd;	File::direct
+falls	back	to	the	default	driver.
+*/
+Properties&	direct(size_t	alignment	=	HDF_WRAPPER_DIRECT_IO_ALIGNMENT,	size_t	block_size	=	HDF_WRAPPER_DIRECT_IO_ALIGNMENT,	size_t	cbuf_size	=	16	<<	20)
+{
+herr_t	err	=	H5Pset_fapl_direct(this->id,	alignment,	block_size,	cbuf_size);
+if	(err	<	0)
+throw	Exception("error	setting	direct	file	driver");
+return	*this;
+}
+#endif
+//	dataset	access:	which	source	files	of	a	virtual	dataset	determine	its	extent
+Properties&	virtual_view(H5D_vds_view_t	view)
+{
+herr_t	err	=	H5Pset_virtual_view(this->id,	view);
+if	(err	<	0)
+throw	Exception("error	setting	virtual	dataset	view");
+return	*this;
+}
+
+//	dataset	access:	number	of	missing	source	files	tolerated	in	a	printf-style	mapping
+Properties&	virtual_printf_gap(hsize_t	gap)
+{
+herr_t	err	=	H5Pset_virtual_printf_gap(this->id,	gap);
+if	(err	<	0)
+throw	Exception("error	setting	virtual	dataset	printf	gap");
+return	*this;
+}
+
+#ifdef	HDF_WRAPPER_HAS_MPI
+/*
+File	access:	use	the	MPI-IO	driver.	Opening	and	creating	files,	as	well	as
+creating	objects,	are	then	collective	operations	on	comm.	collective_metadata
+additionally	makes	metadata	reads	and	writes	collective,	which	avoids	that
+every	process	reads	the	same	metadata	on	its	own.
+*/
+Properties&	mpio(MPI_Comm	comm,	MPI_Info	info	=	MPI_INFO_NULL,	bool	collective_metadata	=	true)
+{
+herr_t	err	=	H5Pset_fapl_mpio(this->id,	comm,	info);
+if	(err	<	0)
+throw	Exception("error	setting	MPI-IO	file	driver");
+if	(collective_metadata)
+{
+if	(H5Pset_all_coll_metadata_ops(this->id,	true)	<	0	||	H5Pset_coll_metadata_write(this->id,	true)	<	0)
+throw	Exception("error	enabling	collective	metadata	operations");
+}
+return	*this;
+}
+
+//	data	transfer:	collective	(all	processes	take	part	in	each	read/write)	or	independent	I/O
+Properties&	collective(bool	on	=	true)
+{
+herr_t	err	=	H5Pset_dxpl_mpio(this->id,	on	?	H5FD_MPIO_COLLECTIVE	:	H5FD_MPIO_INDEPENDENT);
+if	(err	<	0)
+throw	Exception("error	setting	MPI-IO	transfer	mode");
+return	*this;
+}
+#endif
+};
+
+
+//	capacities	of	the	handle	caches,	0	disables	caching;	see	set_handle_cache_capacity
+#ifndef	HDF_WRAPPER_FILE_CACHE_SIZE
+#define	HDF_WRAPPER_FILE_CACHE_SIZE	0
+#endif
+#ifndef	HDF_WRAPPER_OBJECT_CACHE_SIZE
+#define	HDF_WRAPPER_OBJECT_CACHE_SIZE	0
+#endif
+
+namespace	internal
+{
+
+/*
+LRU	cache	of	open	handles,	keyed	by	strings.	One	instance	caches	files	opened
+by	name,	another	groups	and	datasets	opened	by	path.	Keys	of	objects	are	the
+file	name	and	the	absolute	path,	so	all	Group	objects	of	a	file	share	entries.
+The	cache	holds	one	reference	to	each	handle;	eviction	releases	it,	which
+closes	the	handle	unless	it	is	still	in	use	elsewhere.
+Like	the	type	cache	further	below,	the	instances	are	never	destroyed,	since
+that	would	call	into	the	HDF5	library	after	it	was	shut	down.
+*/
+class	HandleCache
+{
+typedef	std::list<std::pair<std::string,	hid_t>	>	List;
+List	lru;	//	most	recently	used	first
+std::unordered_map<std::string,	List::iterator>	index;
+size_t	capacity;
+
+void	erase(List::iterator	it)
+{
+H5Idec_ref(it->second);
+index.erase(it->first);
+lru.erase(it);
+}
+
+void	trim()
+{
+while	(lru.size()	>	capacity)
+erase(std::prev(lru.end()));
+}
+
+public:
+explicit	HandleCache(size_t	capacity_)	:	capacity(capacity_)	{}
+
+static	HandleCache&	files()
+{
+static	HandleCache	*cache	=	new	HandleCache(HDF_WRAPPER_FILE_CACHE_SIZE);
+return	*cache;
+}
+
+static	HandleCache&	objects()
+{
+static	HandleCache	*cache	=	new	HandleCache(HDF_WRAPPER_OBJECT_CACHE_SIZE);
+return	*cache;
+}
+
+bool	enabled()	const	{	return	capacity	>	0;	}
+
+void	set_capacity(size_t	n)
+{
+capacity	=	n;
+trim();
+}
+
+size_t	size()	const	{	return	lru.size();	}
+
+//	the	cached	handle,	still	owned	by	the	cache,	or	-1
+hid_t	get(const	std::string	&key)
+{
+std::unordered_map<std::string,	List::iterator>::iterator	it	=	index.find(key);
+if	(it	==	index.end())
+return	-1;
+if	(H5Iis_valid(it->second->second)	<=	0)	//	closed	behind	our	back
+{
+erase(it->second);
+return	-1;
+}
+lru.splice(lru.begin(),	lru,	it->second);
+return	lru.front().second;
+}
+
+void	put(const	std::string	&key,	hid_t	id)
+{
+if	(!enabled())
+return;
+std::unordered_map<std::string,	List::iterator>::iterator	it	=	index.find(key);
+if	(it	!=	index.end())
+erase(it->second);
+if	(H5Iinc_ref(id)	<	0)
+throw	Exception("error	inc	ref	count");
+lru.push_front(std::make_pair(key,	id));
+index[key]	=	lru.begin();
+trim();
+}
+
+//	drop	the	entry	for	key	and	all	entries	whose	key	continues	it	with	one	of	the	given	separators
+void	invalidate(const	std::string	&key,	const	char	*separators)
+{
+for	(List::iterator	it	=	lru.begin();	it	!=	lru.end();)
+{
+const	std::string	&k	=	(it++)->first;
+if	(k.compare(0,	key.size(),	key)	==	0	&&	(k.size()	==	key.size()	||	std::strchr(separators,	k[key.size()])))
+erase(std::prev(it));
+}
+}
+
+void	clear()
+{
+while	(!lru.empty())
+erase(lru.begin());
+}
+};
+
+//	absolute,	normalized	path	of	name	relative	to	the	object	loc_id
+inline	std::string	absolute_path(hid_t	loc_id,	const	std::string	&name)
+{
+std::string	path;
+if	(name.empty()	||	name[0]	!=	'/')
+{
+ssize_t	l	=	H5Iget_name(loc_id,	NULL,	0);
+if	(l	<	0)
+throw	Exception("cannot	get	object	name");
+path.resize(l);
+if	(l	>	0)
+H5Iget_name(loc_id,	&path[0],	l+1);
+}
+path	+=	"/"	+	name;
+std::string	res;
+size_t	i	=	0;
+while	(i	<	path.size())
+{
+size_t	j	=	path.find('/',	i);
+if	(j	==	std::string::npos)	j	=	path.size();
+std::string	part	=	path.substr(i,	j	-	i);
+if	(!part.empty()	&&	part	!=	".")
+res	+=	"/"	+	part;
+i	=	j	+	1;
+}
+return	res.empty()	?	"/"	:	res;
+}
+
+inline	std::string	file_name_of(hid_t	loc_id)
+{
+ssize_t	l	=	H5Fget_name(loc_id,	NULL,	0);
+if	(l	<	0)
+throw	Exception("cannot	get	object	file	name");
+std::string	res(l,	0);
+if	(l	>	0)
+H5Fget_name(loc_id,	&res[0],	l+1);
+return	res;
+}
+
+//	kind	distinguishes	groups	and	datasets	under	the	same	path
+inline	std::string	object_cache_key(hid_t	loc_id,	const	std::string	&name,	char	kind)
+{
+return	file_name_of(loc_id)	+	'\n'	+	absolute_path(loc_id,	name)	+	'\n'	+	kind;
+}
+
+//	close	cached	handles	of	a	file,	e.g.	before	it	is	truncated	or	after	it	was	closed
+inline	void	invalidate_file_handles(const	std::string	&file_name)
+{
+HandleCache::files().invalidate(file_name,	"\n");
+HandleCache::objects().invalidate(file_name,	"\n");
+}
+
+/*
+Open	an	object	through	the	object	cache.	open(loc_id,	name)	returns	a	new
+handle	which	the	caller	owns.	The	result	is	a	new	reference	in	any	case.
+*/
+template<class	OpenFunc>
+inline	hid_t	cached_open(hid_t	loc_id,	const	std::string	&name,	char	kind,	OpenFunc	open)
+{
+HandleCache	&cache	=	HandleCache::objects();
+if	(!cache.enabled())
+return	open(loc_id,	name);
+std::string	key	=	object_cache_key(loc_id,	name,	kind);
+hid_t	id	=	cache.get(key);
+if	(id	>=	0)
+{
+if	(H5Iinc_ref(id)	<	0)
+throw	Exception("error	inc	ref	count");
+return	id;
+}
+id	=	open(loc_id,	name);
+if	(id	>=	0)
+cache.put(key,	id);
+return	id;
+}
+
+}	//	namespace	internal
+
+
+/*
+Set	the	capacities	of	the	handle	caches.	While	enabled,	File	opens	existing	files
+for	reading,	and	Group::open_group/open_dataset	and	File::root	look	up	groups	and
+datasets,	through	the	caches	instead	of	the	library.	Closing	or	truncating	a	file
+through	the	wrapper	drops	its	cached	handles;	so	does	Group::remove	for	the	removed
+path.	Links	changed	by	other	means	(e.g.	H5Lmove)	are	not	tracked.	Cached	handles
+keep	their	files	open	until	evicted,	see	clear_handle_caches.
+*/
+inline	void	set_handle_cache_capacity(size_t	files,	size_t	objects)
+{
+internal::HandleCache::files().set_capacity(files);
+internal::HandleCache::objects().set_capacity(objects);
+}
+
+inline	void	clear_handle_caches()
+{
+internal::HandleCache::objects().clear();
+internal::HandleCache::files().clear();
+}
+
+
+class	iterator;
+
+class	Group	:	public	Object
+{
+friend	class	File;
+private:
+Group(hid_t	loc_id,	const	char	*	name,	hid_t	gapl_id	,	internal::TagOpen)
+{
+this->id	=	H5Gopen2(loc_id,	name,	gapl_id);
+if	(this->id	<	0)
+throw	Exception("unable	to	open	group:	"+std::string(name));
+}
+Group(hid_t	loc_id,	const	char	*name,	hid_t	lcpl_id,	hid_t	gcpl_id,	hid_t	gapl_id,	internal::TagCreate)
+{
+this->id	=	H5Gcreate2(loc_id,	name,	lcpl_id,	gcpl_id,	gapl_id);
+if	(this->id	<	0)
+throw	Exception("unable	to	create	group:	"+std::string(name));
+}
+Group(hid_t	id,	internal::NoIncRC)	:	Object(id)	{}	//	takes	a	new	handle
+
+static	hid_t	open_group_id(hid_t	loc_id,	const	std::string	&name)
+{
+hid_t	id	=	H5Gopen2(loc_id,	name.c_str(),	H5P_DEFAULT);
+if	(id	<	0)
+throw	Exception("unable	to	open	group:	"+name);
+return	id;
+}
+public:
+
+Group()	:	Object()	{}
+explicit	Group(hid_t	id)	:	Object(id)	{	Object::inc_ref();	}
+
+bool	exists(const	std::string	&name)	const
+{
+htri_t	res	=	H5Lexists(this->id,	name.c_str(),	H5P_DEFAULT);
+if	(res	<	0)
+throw	Exception("cannot	determine	existence	of	link");
+return	res	>	0;
+}
+
+//	number	of	links	in	the	group
+hsize_t	size()	const
+{
+H5G_info_t	info;
+herr_t	res	=	H5Gget_info(this->id,	&info);
+if	(res	<	0)
+throw	Exception("cannot	get	info	of	group");
+return	info.nlinks;
+}
+
+//	used	to	iterate	over	links	in	the	group,	up	to	size()
+std::string	get_link_name(hsize_t	idx)	const
+{
+char	buffer[4096];
+ssize_t	n	=	H5Lget_name_by_idx(this->id,	".",	H5_INDEX_NAME,	H5_ITER_NATIVE,	(hsize_t)idx,	buffer,	4096	H5P_DEFAULT);
+if	(n	<	0)
+throw	Exception("cannot	get	name	of	link	in	group");
+return	std::string(buffer,	n);
+}
+
+//	name	of	the	idx-th	link	in	increasing	order	of	index,	H5_INDEX_CRT_ORDER	needs	creation	order	tracking
+std::string	get_link_name(hsize_t	idx,	H5_index_t	index)	const
+{
+ssize_t	n	=	H5Lget_name_by_idx(this->id,	".",	index,	H5_ITER_INC,	idx,	NULL,	0,	H5P_DEFAULT);
+if	(n	<	0)
+throw	Exception("cannot	get	name	of	link	in	group");
+std::vector<char>	buffer(n	+	1);
+if	(H5Lget_name_by_idx(this->id,	".",	index,	H5_ITER_INC,	idx,	buffer.data(),	buffer.size(),	H5P_DEFAULT)	<	0)
+throw	Exception("cannot	get	name	of	link	in	group");
+return	std::string(buffer.data(),	n);
+}
+
+Group	create_group(const	std::string	&name)
+{
+return	Group(this->id,	name.c_str(),	H5P_DEFAULT,	H5P_DEFAULT,	H5P_DEFAULT,	internal::TagCreate());
+}
+
+//	gcpl	from	create_creation_properties,	or	with	link_phase_change	etc.
+Group	create_group(const	std::string	&name,	const	Properties	&gcpl)
+{
+return	Group(this->id,	name.c_str(),	H5P_DEFAULT,	gcpl.get_id(),	H5P_DEFAULT,	internal::TagCreate());
+}
+
+Group	create_group(const	std::string	&name,	const	Properties	&gcpl,	const	Properties	&lcpl)
+{
+return	Group(this->id,	name.c_str(),	lcpl.get_id(),	gcpl.get_id(),	H5P_DEFAULT,	internal::TagCreate());
+}
+
+//	creates	the	group	at	path,	e.g.	"a/b/c",	and	missing	groups	on	the	way	(with	default	properties)	in	one	call
+Group	create_group_path(const	std::string	&path,	const	Properties	&gcpl	=	Properties(H5P_GROUP_CREATE))
+{
+Properties	lcpl(H5P_LINK_CREATE);
+lcpl.create_intermediate_group();
+return	create_group(path,	gcpl,	lcpl);
+}
+
+/*
+Creation	properties	for	a	group	of	about	est_num_links	links.	Above	a	few
+dozen	links	they	go	to	dense	storage	right	away.	Both	settings	only	apply	to
+new	style	groups,	so	the	creation	order	is	always	tracked,	which	makes	the
+group	new	style	in	files	with	the	default	library	version	bounds	too.
+track_order	also	indexes	it,	see	get_link_name,	at	the	cost	of	a	second	index.
+*/
+static	Properties	create_creation_properties(size_t	est_num_links,	unsigned	int	est_name_len	=	16,	bool	track_order	=	false)
+{
+Properties	gcpl(H5P_GROUP_CREATE);
+if	(est_num_links	>	8)	//	the	default	max_compact
+gcpl.link_phase_change(0,	0);
+else
+gcpl.est_link_info(unsigned(est_num_links),	est_name_len);
+gcpl.link_creation_order(track_order	?	H5P_CRT_ORDER_TRACKED	|	H5P_CRT_ORDER_INDEXED	:	H5P_CRT_ORDER_TRACKED);
+return	gcpl;
+}
+
+//	H5G_STORAGE_TYPE_SYMBOL_TABLE	for	old	style	groups,	_COMPACT	or	_DENSE	for	new	style	ones
+H5G_storage_type_t	storage_type()	const
+{
+H5G_info_t	info;
+if	(H5Gget_info(this->id,	&info)	<	0)
+throw	Exception("cannot	get	info	of	group");
+return	info.storage_type;
+}
+
+Group	open_group(const	std::string	&name)
+{
+return	Group(internal::cached_open(this->id,	name,	'G',	open_group_id),	internal::NoIncRC());
+}
+
+Group	require_group(const	std::string	&name,	bool	*had_group	=	NULL)
+{
+if	(internal::HandleCache::objects().enabled())
+{
+//	one	lookup	instead	of	H5Lexists	+	H5Gopen2;	a	failed	open	falls	through	to	create
+hid_t	id;
+{
+AutoErrorReportingGuard	guard;
+guard.disableReporting();
+id	=	internal::cached_open(this->id,	name,	'G',	[](hid_t	loc_id,	const	std::string	&n)	{	return	H5Gopen2(loc_id,	n.c_str(),	H5P_DEFAULT);	});
+}
+if	(id	>=	0)
+{
+if	(had_group)	*had_group	=	true;
+return	Group(id,	internal::NoIncRC());
+}
+if	(had_group)	*had_group	=	false;
+return	create_group(name);
+}
+if	(exists(name))
+{
+if	(had_group)	*had_group	=	true;
+return	open_group(name);
+}
+else
+{
+if	(had_group)	*had_group	=	false;
+return	create_group(name);
+}
+}
+
+Attributes	attrs()
+{
+return	Attributes(*this);
+}
+
+Dataset	open_dataset(const	std::string	&name);
+Dataset	open_dataset(const	std::string	&name,	const	Properties	&dapl);
+
+#ifdef	HDF_WRAPPER_HAS_BOOST
+boost::optional<Dataset>	try_open_dataset(const	std::string	&name);
+#endif
+
+void	remove(const	std::string	&name)
+{
+if	(internal::HandleCache::objects().enabled())
+{
+//	drop	cached	handles	of	the	object	and	of	everything	below	it
+std::string	key	=	internal::file_name_of(get_id())	+	'\n'	+	internal::absolute_path(get_id(),	name);
+internal::HandleCache::objects().invalidate(key,	"/\n");
+}
+herr_t	err	=	H5Ldelete(get_id(),	name.c_str(),	H5P_DEFAULT);
+if	(err	<	0)
+throw	Exception("cannot	remove	link	from	group");
+}
+
+iterator	begin();
+iterator	end();
+};
+
+
+/*
+TODO:	i	probably	want	an	iterator	that	returns	Object	references.	Objects	because
+items	in	groups	can	be	datasets	or	other	groups.	For	this	to	be	usefull,
+i	need	a	mechanism	to	cast	Object	to	derived	classes.
+*/
+class	iterator	:	public	std::iterator<std::bidirectional_iterator_tag,	std::string>
+{
+hssize_t	idx;
+Group	g;
+friend	class	Group;
+iterator(hssize_t	idx_,	Group	g_)	:	idx(idx_),	g(g_)	{}
+public:
+iterator()	:	idx(std::numeric_limits<int>::max())	{}
+iterator&	operator++()	{	++idx;	return	*this;	}
+iterator&	operator--()	{	--idx;	return	*this;	}
+iterator	operator++(int)	{	auto	tmp	=	*this;	++idx;	return	tmp;	}
+iterator	operator--(int)	{	auto	tmp	=	*this;	--idx;	return	tmp;	}
+bool	operator==(const	iterator	&other)	const	{	return	other.idx	==	idx;	assert(other.g.is_same(g));	}
+bool	operator!=(const	iterator	&other)	const	{	return	!(*this	==	other);	}
+std::string	dereference()	const
+{
+return	g.get_link_name(idx);
+}
+std::string	operator*()	const	{	return	dereference();	}
+};
+
+
+inline	iterator	Group::begin()
+{
+return	iterator(0,	*this);
+}
+
+inline	iterator	Group::end()
+{
+return	iterator(this->size(),	*this);
+}
+
+
+/*
+Metadata	cache	and	page	buffer	statistics	of	a	file,	see	File::cache_stats.
+Hit	rates	and	page	buffer	counts	accumulate	since	the	file	was	opened	or
+File::reset_cache_stats	was	called.
+*/
+struct	FileCacheStats
+{
+double	mdc_hit_rate;
+size_t	mdc_max_size,	mdc_min_clean_size,	mdc_cur_size;	//	current	sizes,	in	bytes
+int	mdc_num_entries;
+size_t	mdc_config_max_size;	//	upper	limit	of	the	adaptive	cache	size
+bool	page_buffering;	//	the	page_	fields	are	valid	only	if	set
+size_t	page_buffer_size;
+unsigned	page_accesses[2],	page_hits[2],	page_misses[2],	page_evictions[2],	page_bypasses[2];	//	[0]	metadata,	[1]	raw	data
+
+FileCacheStats()	:	mdc_hit_rate(0.),	mdc_max_size(0),	mdc_min_clean_size(0),	mdc_cur_size(0),	mdc_num_entries(0),	mdc_config_max_size(0),	page_buffering(false),	page_buffer_size(0)
+{
+for	(int	i=0;	i<2;	++i)
+page_accesses[i]	=	page_hits[i]	=	page_misses[i]	=	page_evictions[i]	=	page_bypasses[i]	=	0;
+}
+
+//	kind	0	=	metadata,	1	=	raw	data
+double	page_hit_rate(int	kind)	const
+{
+return	page_accesses[kind]	?	double(page_hits[kind])	/	page_accesses[kind]	:	1.;
+}
+};
+
+//	chunk	layout	and	chunk	cache	settings	of	a	dataset,	see	Dataset::io_stats
+struct	DatasetIoStats
+{
+bool	chunked;
+int	rank;
+hsize_t	dims[H5S_MAX_RANK],	chunk_dims[H5S_MAX_RANK];
+size_t	chunk_bytes;	//	uncompressed
+hsize_t	allocated_chunks;	//	chunks	with	storage,	only	known	with	HDF5	>=	1.10.5
+size_t	chunk_cache_slots,	chunk_cache_bytes;
+double	chunk_cache_w0;
+hsize_t	storage_bytes,	logical_bytes;
+
+DatasetIoStats()	:	chunked(false),	rank(0),	chunk_bytes(0),	allocated_chunks(0),	chunk_cache_slots(0),	chunk_cache_bytes(0),	chunk_cache_w0(0.),	storage_bytes(0),	logical_bytes(0)	{}
+
+double	compression_ratio()	const
+{
+return	storage_bytes	?	double(logical_bytes)	/	storage_bytes	:	1.;
+}
+};
+
+
+/*--------------------------------------------------
+*	direct	I/O
+*	------------------------------------------------	*/
+
+namespace	internal
+{
+
+inline	void	*aligned_malloc(size_t	alignment,	size_t	bytes)
+{
+#ifdef	_MSC_VER
+return	_aligned_malloc(bytes,	alignment);
+#else
+void	*p	=	NULL;
+return	posix_memalign(&p,	alignment,	bytes)	==	0	?	p	:	NULL;
+#endif
+}
+
+inline	void	aligned_free(void	*p)
+{
+#ifdef	_MSC_VER
+_aligned_free(p);
+#else
+free(p);
+#endif
+}
+
+}	//	namespace	internal
+
+/*
+Allocates	memory	aligned	to	Alignment	bytes,	in	whole	multiples	of	it,	as
+O_DIRECT	transfers	need.	E.g.	std::vector<float,	AlignedAllocator<float>	>	can
+be	used	with	read_dataset	and	create_dataset.
+*/
+template<class	T,	size_t	Alignment	=	HDF_WRAPPER_DIRECT_IO_ALIGNMENT>
+struct	AlignedAllocator
+{
+typedef	T	value_type;
+template<class	U>
+struct	rebind	{	typedef	AlignedAllocator<U,	Alignment>	other;	};
+
+AlignedAllocator()	{}
+template<class	U>
+AlignedAllocator(const	AlignedAllocator<U,	Alignment>	&)	{}
+
+T	*allocate(size_t	n)
+{
+if	(n	>	(std::numeric_limits<size_t>::max()	-	Alignment)	/	sizeof(T))
+throw	std::bad_alloc();
+size_t	bytes	=	std::max<size_t>(1,	(n	*	sizeof(T)	+	Alignment	-	1)	/	Alignment)	*	Alignment;
+void	*p	=	internal::aligned_malloc(Alignment,	bytes);
+if	(!p)
+throw	std::bad_alloc();
+return	static_cast<T*>(p);
+}
+
+void	deallocate(T	*p,	size_t)
+{
+internal::aligned_free(p);
+}
+
+template<class	U>
+bool	operator==(const	AlignedAllocator<U,	Alignment>	&)	const	{	return	true;	}
+template<class	U>
+bool	operator!=(const	AlignedAllocator<U,	Alignment>	&)	const	{	return	false;	}
+};
+
+
+/*--------------------------------------------------
+*	io_uring	file	driver
+*	------------------------------------------------	*/
+
+#ifdef	HDF_WRAPPER_HAS_IO_URING
+
+#ifndef	__NR_io_uring_setup
+#define	__NR_io_uring_setup	425
+#endif
+#ifndef	__NR_io_uring_enter
+#define	__NR_io_uring_enter	426
+#endif
+#ifndef	__NR_io_uring_register
+#define	__NR_io_uring_register	427
+#endif
+
+//	value	of	the	io_uring	driver	in	H5FD_class_t,	HDF5	>=	1.14;	from	the	range	for	drivers	in	testing
+#ifndef	HDF_WRAPPER_IO_URING_VFD_VALUE
+#define	HDF_WRAPPER_IO_URING_VFD_VALUE	301
+#endif
+
+//	settings	of	the	io_uring	file	driver,	see	File::io_uring
+struct	IoUringOptions
+{
+unsigned	int	queue_depth;	//	requests	in	flight	at	once
+size_t	segment_bytes;	//	larger	transfers	are	split	into	segments	of	this	size,	which	run	in	parallel
+size_t	fixed_buffer_bytes;	//	smaller	transfers	go	through	buffers	registered	with	the	kernel,	0	=	none
+
+IoUringOptions()	:	queue_depth(32),	segment_bytes(256	<<	10),	fixed_buffer_bytes(16	<<	10)	{}
+};
+
+namespace	internal
+{
+
+//	an	io_uring	instance,	set	up	with	the	raw	system	calls	(no	liburing)
+class	IoUring
+{
+int	fd;
+unsigned	int	entries,	to_submit,	sq_local_tail;
+void	*sq_ring,	*cq_ring;
+size_t	sq_ring_bytes,	cq_ring_bytes,	sqes_bytes;
+io_uring_sqe	*sqes;
+unsigned	int	*sq_tail,	*sq_mask,	*sq_array,	*cq_head,	*cq_tail,	*cq_mask;
+io_uring_cqe	*cqes;
+
+IoUring(const	IoUring	&);
+IoUring&	operator=(const	IoUring	&);
+public:
+IoUring()	:	fd(-1),	entries(0),	to_submit(0),	sq_local_tail(0),	sq_ring(MAP_FAILED),	cq_ring(MAP_FAILED),	sq_ring_bytes(0),	cq_ring_bytes(0),	sqes_bytes(0),	sqes(static_cast<io_uring_sqe*>(MAP_FAILED))	{}
+~IoUring()	{	close();	}
+
+bool	is_open()	const	{	return	fd	>=	0;	}
+unsigned	int	size()	const	{	return	entries;	}
+unsigned	int	pending()	const	{	return	to_submit;	}	//	prepared,	not	yet	submitted
+
+//	false	if	io_uring	is	not	available,	e.g.	on	old	kernels	or	when	blocked	by	seccomp
+bool	open(unsigned	int	n)
+{
+io_uring_params	p;
+std::memset(&p,	0,	sizeof(p));
+fd	=	int(syscall(__NR_io_uring_setup,	n,	&p));
+if	(fd	<	0)
+return	false;
+sq_ring_bytes	=	p.sq_off.array	+	p.sq_entries	*	sizeof(unsigned	int);
+cq_ring_bytes	=	p.cq_off.cqes	+	p.cq_entries	*	sizeof(io_uring_cqe);
+const	bool	single_mmap	=	(p.features	&	IORING_FEAT_SINGLE_MMAP)	!=	0;
+if	(single_mmap)
+sq_ring_bytes	=	cq_ring_bytes	=	std::max(sq_ring_bytes,	cq_ring_bytes);
+sq_ring	=	mmap(NULL,	sq_ring_bytes,	PROT_READ	|	PROT_WRITE,	MAP_SHARED	|	MAP_POPULATE,	fd,	IORING_OFF_SQ_RING);
+cq_ring	=	single_mmap	?	sq_ring	:	mmap(NULL,	cq_ring_bytes,	PROT_READ	|	PROT_WRITE,	MAP_SHARED	|	MAP_POPULATE,	fd,	IORING_OFF_CQ_RING);
+sqes_bytes	=	p.sq_entries	*	sizeof(io_uring_sqe);
+sqes	=	static_cast<io_uring_sqe*>(mmap(NULL,	sqes_bytes,	PROT_READ	|	PROT_WRITE,	MAP_SHARED	|	MAP_POPULATE,	fd,	IORING_OFF_SQES));
+if	(sq_ring	==	MAP_FAILED	||	cq_ring	==	MAP_FAILED	||	sqes	==	MAP_FAILED)
+{
+close();
+return	false;
+}
+char	*sq	=	static_cast<char*>(sq_ring),	*cq	=	static_cast<char*>(cq_ring);
+sq_tail	=	reinterpret_cast<unsigned	int*>(sq	+	p.sq_off.tail);
+sq_mask	=	reinterpret_cast<unsigned	int*>(sq	+	p.sq_off.ring_mask);
+sq_array	=	reinterpret_cast<unsigned	int*>(sq	+	p.sq_off.array);
+cq_head	=	reinterpret_cast<unsigned	int*>(cq	+	p.cq_off.head);
+cq_tail	=	reinterpret_cast<unsigned	int*>(cq	+	p.cq_off.tail);
+cq_mask	=	reinterpret_cast<unsigned	int*>(cq	+	p.cq_off.ring_mask);
+cqes	=	reinterpret_cast<io_uring_cqe*>(cq	+	p.cq_off.cqes);
+entries	=	p.sq_entries;
+sq_local_tail	=	*sq_tail;
+return	true;
+}
+
+void	close()
+{
+if	(sqes	!=	MAP_FAILED)
+munmap(sqes,	sqes_bytes);
+if	(cq_ring	!=	MAP_FAILED	&&	cq_ring	!=	sq_ring)
+munmap(cq_ring,	cq_ring_bytes);
+if	(sq_ring	!=	MAP_FAILED)
+munmap(sq_ring,	sq_ring_bytes);
+if	(fd	>=	0)
+::close(fd);
+fd	=	-1;
+to_submit	=	0;
+sq_ring	=	cq_ring	=	MAP_FAILED;
+sqes	=	static_cast<io_uring_sqe*>(MAP_FAILED);
+}
+
+bool	register_buffers(const	iovec	*iov,	unsigned	int	n)
+{
+return	syscall(__NR_io_uring_register,	fd,	IORING_REGISTER_BUFFERS,	iov,	n)	==	0;
+}
+
+//	the	next	submission	queue	entry,	cleared;	at	most	size()	may	be	in	flight
+io_uring_sqe	*prepare()
+{
+unsigned	int	idx	=	sq_local_tail++	&	*sq_mask;
+sq_array[idx]	=	idx;
+++to_submit;
+io_uring_sqe	*sqe	=	&sqes[idx];
+std::memset(sqe,	0,	sizeof(*sqe));
+return	sqe;
+}
+
+//	submits	the	prepared	entries	and	waits	for	at	least	wait_nr	completions;	false	with	errno	on	errors
+bool	submit(unsigned	int	wait_nr)
+{
+__atomic_store_n(sq_tail,	sq_local_tail,	__ATOMIC_RELEASE);
+for	(;;)
+{
+long	r	=	syscall(__NR_io_uring_enter,	fd,	to_submit,	wait_nr,	wait_nr	?	IORING_ENTER_GETEVENTS	:	0,	NULL,	0);
+if	(r	>=	0)
+{
+to_submit	-=	unsigned(r);
+if	(to_submit	==	0)
+return	true;
+}
+else	if	(errno	!=	EINTR	&&	errno	!=	EAGAIN	&&	errno	!=	EBUSY)
+return	false;
+}
+}
+
+bool	next_completion(io_uring_cqe	&cqe)
+{
+unsigned	int	head	=	*cq_head;
+if	(head	==	__atomic_load_n(cq_tail,	__ATOMIC_ACQUIRE))
+return	false;
+cqe	=	cqes[head	&	*cq_mask];
+__atomic_store_n(cq_head,	head	+	1,	__ATOMIC_RELEASE);
+return	true;
+}
+};
+
+//	a	file	of	the	io_uring	driver
+struct	IoUringDriverFile
+{
+H5FD_t	pub;	//	must	come	first,	the	library	only	sees	this
+int	fd;
+dev_t	device;
+ino_t	inode;
+haddr_t	eoa,	eof;
+IoUringOptions	options;
+IoUring	ring;
+unsigned	char	*fixed_buffers;	//	queue_depth	registered	buffers	of	options.fixed_buffer_bytes
+std::vector<unsigned	int>	free_fixed;
+
+IoUringDriverFile()	:	fd(-1),	device(0),	inode(0),	eoa(0),	eof(0),	fixed_buffers(NULL)
+{
+std::memset(&pub,	0,	sizeof(pub));
+}
+
+~IoUringDriverFile()
+{
+ring.close();	//	unregisters	the	buffers
+aligned_free(fixed_buffers);
+if	(fd	>=	0)
+::close(fd);
+}
+
+void	setup_ring()
+{
+if	(!ring.open(std::max(1u,	options.queue_depth)))
+return;
+if	(options.fixed_buffer_bytes	==	0)
+return;
+fixed_buffers	=	static_cast<unsigned	char*>(aligned_malloc(4096,	ring.size()	*	options.fixed_buffer_bytes));
+std::vector<iovec>	iov(ring.size());
+for	(unsigned	int	i=0;	i<ring.size();	++i)
+{
+iov[i].iov_base	=	fixed_buffers	+	i	*	options.fixed_buffer_bytes;
+iov[i].iov_len	=	options.fixed_buffer_bytes;
+free_fixed.push_back(i);
+}
+if	(!fixed_buffers	||	!ring.register_buffers(iov.data(),	ring.size()))
+{
+options.fixed_buffer_bytes	=	0;	//	e.g.	RLIMIT_MEMLOCK	too	small
+free_fixed.clear();
+}
+}
+
+struct	Request
+{
+uint64_t	offset;
+size_t	size;
+unsigned	char	*buf;
+};
+
+//	with	pread/pwrite,	when	io_uring	isn't	available
+bool	transfer_sync(bool	write,	const	Request	&r)
+{
+size_t	done	=	0;
+while	(done	<	r.size)
+{
+ssize_t	n	=	write	?	pwrite(fd,	r.buf	+	done,	r.size	-	done,	off_t(r.offset	+	done))	:	pread(fd,	r.buf	+	done,	r.size	-	done,	off_t(r.offset	+	done));
+if	(n	<	0	&&	errno	==	EINTR)
+continue;
+if	(n	<	0)
+return	false;
+if	(n	==	0)
+{
+if	(write)
+return	false;
+std::memset(r.buf	+	done,	0,	r.size	-	done);	//	beyond	the	end	of	the	file
+break;
+}
+done	+=	size_t(n);
+}
+return	true;
+}
+
+/*
+Cuts	the	requests	into	segments	of	at	most	segment_bytes	and	keeps	up	to
+queue_depth	of	them	in	flight.	Small	requests	use	registered	buffers.	Short
+transfers	are	resubmitted	for	the	rest,	reads	beyond	the	end	of	the	file	give
+zeros.	Returns	false	with	errno	set,	after	all	submitted	segments	completed.
+*/
+bool	transfer(bool	write,	const	Request	*requests,	size_t	n)
+{
+if	(!ring.is_open())
+{
+for	(size_t	i=0;	i<n;	++i)
+if	(!transfer_sync(write,	requests[i]))
+return	false;
+return	true;
+}
+struct	Segment
+{
+uint64_t	offset;
+size_t	size,	done;
+unsigned	char	*buf;
+int	fixed;	//	index	of	the	registered	buffer,	-1	for	none
+iovec	iov;
+};
+std::vector<Segment>	segments;
+const	size_t	segment_bytes	=	std::max<size_t>(4096,	options.segment_bytes);
+for	(size_t	i=0;	i<n;	++i)
+for	(size_t	pos=0;	pos<requests[i].size;	pos+=segment_bytes)
+{
+Segment	s;
+s.offset	=	requests[i].offset	+	pos;
+s.size	=	std::min(segment_bytes,	requests[i].size	-	pos);
+s.done	=	0;
+s.buf	=	requests[i].buf	+	pos;
+s.fixed	=	-1;
+segments.push_back(s);
+}
+std::vector<size_t>	todo;	//	indices	of	segments	to	submit,	last	first
+for	(size_t	i=segments.size();	i-->0;	)
+todo.push_back(i);
+unsigned	int	in_flight	=	0;
+int	error	=	0;
+while	(in_flight	>	0	||	(!todo.empty()	&&	!error))
+{
+while	(!todo.empty()	&&	!error	&&	in_flight	<	ring.size())
+{
+const	size_t	i	=	todo.back();
+todo.pop_back();
+Segment	&s	=	segments[i];
+if	(s.fixed	<	0	&&	s.done	==	0	&&	s.size	<=	options.fixed_buffer_bytes	&&	!free_fixed.empty())
+{
+s.fixed	=	int(free_fixed.back());
+free_fixed.pop_back();
+if	(write)
+std::memcpy(fixed_buffers	+	s.fixed	*	options.fixed_buffer_bytes,	s.buf,	s.size);
+}
+io_uring_sqe	*sqe	=	ring.prepare();
+sqe->fd	=	fd;
+sqe->off	=	s.offset	+	s.done;
+sqe->user_data	=	i;
+if	(s.fixed	>=	0)
+{
+sqe->opcode	=	write	?	IORING_OP_WRITE_FIXED	:	IORING_OP_READ_FIXED;
+sqe->addr	=	uintptr_t(fixed_buffers	+	s.fixed	*	options.fixed_buffer_bytes	+	s.done);
+sqe->len	=	unsigned(s.size	-	s.done);
+sqe->buf_index	=	uint16_t(s.fixed);
+}
+else
+{
+s.iov.iov_base	=	s.buf	+	s.done;
+s.iov.iov_len	=	s.size	-	s.done;
+sqe->opcode	=	write	?	IORING_OP_WRITEV	:	IORING_OP_READV;
+sqe->addr	=	uintptr_t(&s.iov);
+sqe->len	=	1;
+}
+++in_flight;
+}
+if	(!ring.submit(1))
+{
+//	the	ring	is	unusable:	wait	for	the	submitted	segments,	then	do	it	all	again	with	pread/pwrite
+unsigned	int	submitted	=	in_flight	-	ring.pending();
+io_uring_cqe	cqe;
+while	(submitted	>	0)
+{
+if	(ring.next_completion(cqe))
+--submitted;
+else
+sched_yield();
+}
+ring.close();
+return	transfer(write,	requests,	n);
+}
+io_uring_cqe	cqe;
+while	(ring.next_completion(cqe))
+{
+--in_flight;
+Segment	&s	=	segments[cqe.user_data];
+if	(cqe.res	==	-EINTR	||	cqe.res	==	-EAGAIN)
+{
+todo.push_back(cqe.user_data);
+continue;
+}
+if	(cqe.res	<	0	||	(cqe.res	==	0	&&	write))
+{
+error	=	cqe.res	<	0	?	-cqe.res	:	EIO;
+continue;
+}
+if	(cqe.res	==	0)	//	end	of	the	file
+std::memset((s.fixed	>=	0	?	fixed_buffers	+	s.fixed	*	options.fixed_buffer_bytes	:	s.buf)	+	s.done,	0,	s.size	-	s.done);
+else
+s.done	+=	size_t(cqe.res);
+if	(cqe.res	>	0	&&	s.done	<	s.size)
+{
+todo.push_back(cqe.user_data);
+continue;
+}
+if	(s.fixed	>=	0)
+{
+if	(!write)
+std::memcpy(s.buf,	fixed_buffers	+	s.fixed	*	options.fixed_buffer_bytes,	s.size);
+free_fixed.push_back(unsigned(s.fixed));
+}
+}
+}
+if	(error)
+{
+//	registered	buffers	of	unfinished	segments
+for	(size_t	i=0;	i<segments.size();	++i)
+if	(segments[i].fixed	>=	0	&&	std::find(free_fixed.begin(),	free_fixed.end(),	unsigned(segments[i].fixed))	==	free_fixed.end())
+free_fixed.push_back(unsigned(segments[i].fixed));
+errno	=	error;
+return	false;
+}
+return	true;
+}
+};
+
+inline	void	push_vfd_error(const	char	*func,	H5E_minor_t	minor,	const	char	*msg)
+{
+H5Epush2(H5E_DEFAULT,	__FILE__,	func,	__LINE__,	H5E_ERR_CLS,	H5E_VFL,	minor,	"%s",	msg);
+}
+
+inline	H5FD_t	*io_uring_open(const	char	*name,	unsigned	int	flags,	hid_t	fapl,	haddr_t)
+{
+int	o	=	flags	&	H5F_ACC_RDWR	?	O_RDWR	:	O_RDONLY;
+if	(flags	&	H5F_ACC_TRUNC)
+o	|=	O_TRUNC;
+if	(flags	&	H5F_ACC_CREAT)
+o	|=	O_CREAT;
+if	(flags	&	H5F_ACC_EXCL)
+o	|=	O_EXCL;
+int	fd	=	::open(name,	o	|	O_CLOEXEC,	0666);
+struct	stat	st;
+if	(fd	<	0	||	fstat(fd,	&st)	!=	0)
+{
+if	(fd	>=	0)
+::close(fd);
+push_vfd_error("io_uring_open",	H5E_CANTOPENFILE,	strerror(errno));
+return	NULL;
+}
+try
+{
+IoUringDriverFile	*f	=	new	IoUringDriverFile();
+f->fd	=	fd;
+f->device	=	st.st_dev;
+f->inode	=	st.st_ino;
+f->eof	=	haddr_t(st.st_size);
+const	IoUringOptions	*options	=	static_cast<const	IoUringOptions*>(H5Pget_driver_info(fapl));
+if	(options)
+f->options	=	*options;
+f->setup_ring();
+return	&f->pub;
+}
+catch	(const	std::exception	&e)
+{
+::close(fd);
+push_vfd_error("io_uring_open",	H5E_CANTOPENFILE,	e.what());
+return	NULL;
+}
+}
+
+inline	herr_t	io_uring_close(H5FD_t	*file)
+{
+delete	reinterpret_cast<IoUringDriverFile*>(file);
+return	0;
+}
+
+inline	int	io_uring_cmp(const	H5FD_t	*f1,	const	H5FD_t	*f2)
+{
+const	IoUringDriverFile	*a	=	reinterpret_cast<const	IoUringDriverFile*>(f1),	*b	=	reinterpret_cast<const	IoUringDriverFile*>(f2);
+if	(a->device	!=	b->device)
+return	a->device	<	b->device	?	-1	:	1;
+if	(a->inode	!=	b->inode)
+return	a->inode	<	b->inode	?	-1	:	1;
+return	0;
+}
+
+inline	herr_t	io_uring_query(const	H5FD_t	*,	unsigned	long	*flags)
+{
+*flags	=	H5FD_FEAT_AGGREGATE_METADATA	|	H5FD_FEAT_ACCUMULATE_METADATA	|	H5FD_FEAT_DATA_SIEVE	|	H5FD_FEAT_AGGREGATE_SMALLDATA;
+#ifdef	H5FD_FEAT_POSIX_COMPAT_HANDLE
+*flags	|=	H5FD_FEAT_POSIX_COMPAT_HANDLE;
+#endif
+#ifdef	H5FD_FEAT_DEFAULT_VFD_COMPATIBLE
+*flags	|=	H5FD_FEAT_DEFAULT_VFD_COMPATIBLE;
+#endif
+return	0;
+}
+
+inline	void	*io_uring_fapl_get(H5FD_t	*file)
+{
+return	new	(std::nothrow)	IoUringOptions(reinterpret_cast<IoUringDriverFile*>(file)->options);
+}
+
+inline	void	*io_uring_fapl_copy(const	void	*fapl)
+{
+return	new	(std::nothrow)	IoUringOptions(*static_cast<const	IoUringOptions*>(fapl));
+}
+
+inline	herr_t	io_uring_fapl_free(void	*fapl)
+{
+delete	static_cast<IoUringOptions*>(fapl);
+return	0;
+}
+
+inline	haddr_t	io_uring_get_eoa(const	H5FD_t	*file,	H5FD_mem_t)
+{
+return	reinterpret_cast<const	IoUringDriverFile*>(file)->eoa;
+}
+
+inline	herr_t	io_uring_set_eoa(H5FD_t	*file,	H5FD_mem_t,	haddr_t	addr)
+{
+reinterpret_cast<IoUringDriverFile*>(file)->eoa	=	addr;
+return	0;
+}
+
+inline	haddr_t	io_uring_get_eof(const	H5FD_t	*file,	H5FD_mem_t)
+{
+return	reinterpret_cast<const	IoUringDriverFile*>(file)->eof;
+}
+
+inline	herr_t	io_uring_get_handle(H5FD_t	*file,	hid_t,	void	**handle)
+{
+*handle	=	&reinterpret_cast<IoUringDriverFile*>(file)->fd;
+return	0;
+}
+
+inline	herr_t	io_uring_transfer(H5FD_t	*file,	bool	write,	size_t	n,	const	haddr_t	*addrs,	const	size_t	*sizes,	void	*const	*bufs)
+{
+IoUringDriverFile	*f	=	reinterpret_cast<IoUringDriverFile*>(file);
+try
+{
+std::vector<IoUringDriverFile::Request>	requests(n);
+for	(size_t	i=0;	i<n;	++i)
+{
+if	(addrs[i]	==	HADDR_UNDEF	||	addrs[i]	+	sizes[i]	>	f->eoa)
+{
+push_vfd_error("io_uring_transfer",	H5E_OVERFLOW,	"address	beyond	the	end	of	the	allocated	space");
+return	-1;
+}
+requests[i].offset	=	addrs[i];
+requests[i].size	=	sizes[i];
+requests[i].buf	=	static_cast<unsigned	char*>(bufs[i]);
+}
+if	(!f->transfer(write,	requests.data(),	n))
+{
+push_vfd_error("io_uring_transfer",	write	?	H5E_WRITEERROR	:	H5E_READERROR,	strerror(errno));
+return	-1;
+}
+if	(write)
+for	(size_t	i=0;	i<n;	++i)
+f->eof	=	std::max(f->eof,	addrs[i]	+	sizes[i]);
+return	0;
+}
+catch	(const	std::exception	&e)
+{
+push_vfd_error("io_uring_transfer",	write	?	H5E_WRITEERROR	:	H5E_READERROR,	e.what());
+return	-1;
+}
+}
+
+inline	herr_t	io_uring_read(H5FD_t	*file,	H5FD_mem_t,	hid_t,	haddr_t	addr,	size_t	size,	void	*buf)
+{
+return	io_uring_transfer(file,	false,	1,	&addr,	&size,	&buf);
+}
+
+inline	herr_t	io_uring_write(H5FD_t	*file,	H5FD_mem_t,	hid_t,	haddr_t	addr,	size_t	size,	const	void	*buf)
+{
+void	*b	=	const_cast<void*>(buf);
+return	io_uring_transfer(file,	true,	1,	&addr,	&size,	&b);
+}
+
+#ifdef	H5FD_CLASS_VERSION
+//	a	size	of	0	means	the	previous	size	for	all	remaining	requests
+inline	herr_t	io_uring_vector(H5FD_t	*file,	bool	write,	uint32_t	count,	const	haddr_t	*addrs,	const	size_t	*sizes,	void	*const	*bufs)
+{
+std::vector<size_t>	all_sizes(sizes,	sizes	+	count);
+for	(uint32_t	i=1;	i<count;	++i)
+if	(all_sizes[i]	==	0)
+all_sizes[i]	=	all_sizes[i-1];
+return	io_uring_transfer(file,	write,	count,	addrs,	all_sizes.data(),	bufs);
+}
+
+inline	herr_t	io_uring_read_vector(H5FD_t	*file,	hid_t,	uint32_t	count,	H5FD_mem_t	*,	haddr_t	*addrs,	size_t	*sizes,	void	**bufs)
+{
+return	io_uring_vector(file,	false,	count,	addrs,	sizes,	bufs);
+}
+
+inline	herr_t	io_uring_write_vector(H5FD_t	*file,	hid_t,	uint32_t	count,	H5FD_mem_t	*,	haddr_t	*addrs,	size_t	*sizes,	const	void	**bufs)
+{
+return	io_uring_vector(file,	true,	count,	addrs,	sizes,	const_cast<void**>(bufs));
+}
+#endif
+
+inline	herr_t	io_uring_truncate(H5FD_t	*file,	hid_t,	hbool_t)
+{
+IoUringDriverFile	*f	=	reinterpret_cast<IoUringDriverFile*>(file);
+if	(f->eoa	==	f->eof)
+return	0;
+if	(ftruncate(f->fd,	off_t(f->eoa))	!=	0)
+{
+push_vfd_error("io_uring_truncate",	H5E_SEEKERROR,	strerror(errno));
+return	-1;
+}
+f->eof	=	f->eoa;
+return	0;
+}
+
+inline	herr_t	io_uring_lock(H5FD_t	*file,	hbool_t	rw)
+{
+if	(flock(reinterpret_cast<IoUringDriverFile*>(file)->fd,	(rw	?	LOCK_EX	:	LOCK_SH)	|	LOCK_NB)	!=	0	&&	errno	!=	ENOSYS)
+{
+push_vfd_error("io_uring_lock",	H5E_CANTLOCKFILE,	strerror(errno));
+return	-1;
+}
+return	0;
+}
+
+inline	herr_t	io_uring_unlock(H5FD_t	*file)
+{
+if	(flock(reinterpret_cast<IoUringDriverFile*>(file)->fd,	LOCK_UN)	!=	0	&&	errno	!=	ENOSYS)
+{
+push_vfd_error("io_uring_unlock",	H5E_CANTUNLOCKFILE,	strerror(errno));
+return	-1;
+}
+return	0;
+}
+
+//	registered	once,	the	id	is	never	closed
+inline	hid_t	io_uring_driver_id()
+{
+static	const	hid_t	id	=	[]()
+{
+//	assigned	by	name,	the	layout	of	H5FD_class_t	differs	between	library	versions
+H5FD_class_t	c;
+std::memset(&c,	0,	sizeof(c));
+#ifdef	H5FD_CLASS_VERSION
+c.version	=	H5FD_CLASS_VERSION;
+c.value	=	HDF_WRAPPER_IO_URING_VFD_VALUE;
+c.read_vector	=	io_uring_read_vector;
+c.write_vector	=	io_uring_write_vector;
+#endif
+c.name	=	"h5cpp_io_uring";
+c.maxaddr	=	haddr_t(std::numeric_limits<off_t>::max());
+c.fc_degree	=	H5F_CLOSE_WEAK;
+c.fapl_size	=	sizeof(IoUringOptions);
+c.fapl_get	=	io_uring_fapl_get;
+c.fapl_copy	=	io_uring_fapl_copy;
+c.fapl_free	=	io_uring_fapl_free;
+c.open	=	io_uring_open;
+c.close	=	io_uring_close;
+c.cmp	=	io_uring_cmp;
+c.query	=	io_uring_query;
+c.get_eoa	=	io_uring_get_eoa;
+c.set_eoa	=	io_uring_set_eoa;
+c.get_eof	=	io_uring_get_eof;
+c.get_handle	=	io_uring_get_handle;
+c.read	=	io_uring_read;
+c.write	=	io_uring_write;
+c.truncate	=	io_uring_truncate;
+c.lock	=	io_uring_lock;
+c.unlock	=	io_uring_unlock;
+const	H5FD_mem_t	fl_map[H5FD_MEM_NTYPES]	=	H5FD_FLMAP_DICHOTOMY;
+std::copy(fl_map,	fl_map	+	H5FD_MEM_NTYPES,	c.fl_map);
+return	H5FDregister(&c);
+}();
+if	(id	<	0)
+throw	Exception("cannot	register	the	io_uring	file	driver");
+return	id;
+}
+
+}	//	namespace	internal
+
+//	whether	io_uring	works	on	this	system;	if	not,	the	io_uring	driver	uses	pread	and	pwrite
+inline	bool	io_uring_available()
+{
+static	const	bool	available	=	internal::IoUring().open(2);
+return	available;
+}
+
+#endif	//	HDF_WRAPPER_HAS_IO_URING
+
+
+/*--------------------------------------------------
+*	I/O	tracing
+*	------------------------------------------------	*/
+
+//	value	of	the	tracing	driver	in	H5FD_class_t,	HDF5	>=	1.14;	from	the	range	for	drivers	in	testing
+#ifndef	HDF_WRAPPER_TRACE_VFD_VALUE
+#define	HDF_WRAPPER_TRACE_VFD_VALUE	302
+#endif
+
+//	a	read	or	write	of	the	file	driver,	see	IoTrace
+struct	IoTraceRecord
+{
+uint64_t	offset,	size;
+uint64_t	start_ns;	//	since	the	trace	was	created
+uint32_t	latency_ns;
+uint8_t	type;	//	H5FD_mem_t;	H5FD_MEM_DRAW	is	raw	data,	the	others	are	metadata
+uint8_t	write;	//	1	for	writes,	0	for	reads
+uint16_t	file;	//	files	opened	with	the	same	trace	are	numbered	from	0
+};
+
+/*
+Ring	buffer	of	the	reads	and	writes	of	files	opened	with	File::traced,	which
+overwrites	the	oldest	records	when	full.	See	analyze_io_trace.
+*/
+class	IoTrace
+{
+mutable	std::mutex	mutex;
+std::vector<IoTraceRecord>	ring;
+uint64_t	total;	//	records	ever	added
+std::vector<std::string>	files;	//	names,	by	IoTraceRecord::file
+std::chrono::steady_clock::time_point	start;
+
+IoTrace(const	IoTrace	&);
+IoTrace&	operator=(const	IoTrace	&);
+public:
+explicit	IoTrace(size_t	capacity	=	1	<<	16)	:	ring(std::max<size_t>(1,	capacity)),	total(0),	start(std::chrono::steady_clock::now())	{}
+
+uint64_t	now_ns()	const
+{
+return	uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now()	-	start).count());
+}
+
+uint16_t	add_file(const	std::string	&name)
+{
+std::lock_guard<std::mutex>	lock(mutex);
+files.push_back(name);
+return	uint16_t(files.size()	-	1);
+}
+
+//	the	names	the	files	were	opened	with,	indexed	by	IoTraceRecord::file
+std::vector<std::string>	file_names()	const
+{
+std::lock_guard<std::mutex>	lock(mutex);
+return	files;
+}
+
+void	add(const	IoTraceRecord	&r)
+{
+std::lock_guard<std::mutex>	lock(mutex);
+ring[total	%	ring.size()]	=	r;
+++total;
+}
+
+//	the	retained	records,	oldest	first
+std::vector<IoTraceRecord>	records()	const
+{
+std::lock_guard<std::mutex>	lock(mutex);
+std::vector<IoTraceRecord>	ret;
+const	uint64_t	first	=	total	>	ring.size()	?	total	-	ring.size()	:	0;
+ret.reserve(size_t(total	-	first));
+for	(uint64_t	i=first;	i<total;	++i)
+ret.push_back(ring[i	%	ring.size()]);
+return	ret;
+}
+
+//	number	of	records	which	were	overwritten
+uint64_t	dropped()	const
+{
+std::lock_guard<std::mutex>	lock(mutex);
+return	total	>	ring.size()	?	total	-	ring.size()	:	0;
+}
+
+void	clear()
+{
+std::lock_guard<std::mutex>	lock(mutex);
+total	=	0;
+}
+
+//	writes	the	retained	records	as	they	are	in	memory,	oldest	first
+void	save(const	std::string	&path)	const
+{
+std::vector<IoTraceRecord>	r	=	records();
+FILE	*f	=	fopen(path.c_str(),	"wb");
+if	(!f)
+throw	Exception("cannot	open	"	+	path);
+const	bool	ok	=	fwrite(r.data(),	sizeof(IoTraceRecord),	r.size(),	f)	==	r.size();
+if	(fclose(f)	!=	0	||	!ok)
+throw	Exception("cannot	write	"	+	path);
+}
+
+static	std::vector<IoTraceRecord>	load(const	std::string	&path)
+{
+FILE	*f	=	fopen(path.c_str(),	"rb");
+if	(!f)
+throw	Exception("cannot	open	"	+	path);
+std::vector<IoTraceRecord>	r;
+IoTraceRecord	buf[256];
+size_t	n;
+while	((n	=	fread(buf,	sizeof(IoTraceRecord),	256,	f))	>	0)
+r.insert(r.end(),	buf,	buf	+	n);
+fclose(f);
+return	r;
+}
+};
+
+namespace	internal
+{
+
+//	driver	info	of	the	tracing	driver:	the	trace	and	the	file	access	properties	of	the	traced	driver
+struct	TraceDriverInfo
+{
+IoTrace	*trace;
+hid_t	fapl;
+};
+
+struct	TraceDriverFile
+{
+H5FD_t	pub;	//	must	come	first
+H5FD_t	*inner;
+IoTrace	*trace;
+hid_t	fapl;
+uint16_t	index;
+};
+
+inline	TraceDriverFile	*trace_file(const	H5FD_t	*f)
+{
+return	reinterpret_cast<TraceDriverFile*>(const_cast<H5FD_t*>(f));
+}
+
+inline	void	*trace_fapl_copy(const	void	*info)
+{
+const	TraceDriverInfo	*from	=	static_cast<const	TraceDriverInfo*>(info);
+TraceDriverInfo	*to	=	new	(std::nothrow)	TraceDriverInfo;
+if	(!to)
+return	NULL;
+to->trace	=	from->trace;
+to->fapl	=	H5Pcopy(from->fapl);
+if	(to->fapl	<	0)
+{
+delete	to;
+return	NULL;
+}
+return	to;
+}
+
+inline	herr_t	trace_fapl_free(void	*info)
+{
+TraceDriverInfo	*i	=	static_cast<TraceDriverInfo*>(info);
+herr_t	err	=	H5Pclose(i->fapl);
+delete	i;
+return	err;
+}
+
+inline	void	*trace_fapl_get(H5FD_t	*file)
+{
+TraceDriverInfo	info	=	{	trace_file(file)->trace,	trace_file(file)->fapl	};
+return	trace_fapl_copy(&info);
+}
+
+inline	H5FD_t	*trace_open(const	char	*name,	unsigned	int	flags,	hid_t	fapl,	haddr_t)
+{
+const	TraceDriverInfo	*info	=	static_cast<const	TraceDriverInfo*>(H5Pget_driver_info(fapl));
+if	(!info)
+return	NULL;
+TraceDriverFile	*f	=	new	(std::nothrow)	TraceDriverFile();
+if	(!f)
+return	NULL;
+f->fapl	=	H5Pcopy(info->fapl);
+{
+//	the	library	probes	whether	files	exist	by	failing	opens,	which	must	not	be	reported
+AutoErrorReportingGuard	guard;
+guard.disableReporting();
+f->inner	=	f->fapl	<	0	?	NULL	:	H5FDopen(name,	flags,	f->fapl,	HADDR_UNDEF);	//	with	the	maximum	address	of	the	traced	driver
+}
+if	(!f->inner)
+{
+if	(f->fapl	>=	0)
+H5Pclose(f->fapl);
+delete	f;
+return	NULL;
+}
+f->trace	=	info->trace;
+f->index	=	f->trace->add_file(name);
+return	&f->pub;
+}
+
+inline	herr_t	trace_close(H5FD_t	*file)
+{
+TraceDriverFile	*f	=	trace_file(file);
+herr_t	err	=	H5FDclose(f->inner);
+H5Pclose(f->fapl);
+delete	f;
+return	err;
+}
+
+inline	int	trace_cmp(const	H5FD_t	*a,	const	H5FD_t	*b)
+{
+return	H5FDcmp(trace_file(a)->inner,	trace_file(b)->inner);
+}
+
+inline	herr_t	trace_query(const	H5FD_t	*file,	unsigned	long	*flags)
+{
+*flags	=	0;
+return	file	?	H5FDquery(trace_file(file)->inner,	flags)	:	0;
+}
+
+inline	haddr_t	trace_get_eoa(const	H5FD_t	*file,	H5FD_mem_t	type)
+{
+return	H5FDget_eoa(trace_file(file)->inner,	type);
+}
+
+inline	herr_t	trace_set_eoa(H5FD_t	*file,	H5FD_mem_t	type,	haddr_t	addr)
+{
+return	H5FDset_eoa(trace_file(file)->inner,	type,	addr);
+}
+
+inline	haddr_t	trace_get_eof(const	H5FD_t	*file,	H5FD_mem_t	type)
+{
+return	H5FDget_eof(trace_file(file)->inner,	type);
+}
+
+inline	herr_t	trace_get_handle(H5FD_t	*file,	hid_t	fapl,	void	**handle)
+{
+return	H5FDget_vfd_handle(trace_file(file)->inner,	fapl,	handle);
+}
+
+inline	void	trace_record(TraceDriverFile	*f,	bool	write,	H5FD_mem_t	type,	haddr_t	addr,	size_t	size,	uint64_t	start_ns)
+{
+IoTraceRecord	r;
+r.offset	=	addr;
+r.size	=	size;
+r.start_ns	=	start_ns;
+r.latency_ns	=	uint32_t(std::min<uint64_t>(f->trace->now_ns()	-	start_ns,	std::numeric_limits<uint32_t>::max()));
+r.type	=	uint8_t(type);
+r.write	=	write;
+r.file	=	f->index;
+f->trace->add(r);
+}
+
+inline	herr_t	trace_read(H5FD_t	*file,	H5FD_mem_t	type,	hid_t	dxpl,	haddr_t	addr,	size_t	size,	void	*buf)
+{
+TraceDriverFile	*f	=	trace_file(file);
+const	uint64_t	start	=	f->trace->now_ns();
+herr_t	err	=	H5FDread(f->inner,	type,	dxpl,	addr,	size,	buf);
+trace_record(f,	false,	type,	addr,	size,	start);
+return	err;
+}
+
+inline	herr_t	trace_write(H5FD_t	*file,	H5FD_mem_t	type,	hid_t	dxpl,	haddr_t	addr,	size_t	size,	const	void	*buf)
+{
+TraceDriverFile	*f	=	trace_file(file);
+const	uint64_t	start	=	f->trace->now_ns();
+herr_t	err	=	H5FDwrite(f->inner,	type,	dxpl,	addr,	size,	buf);
+trace_record(f,	true,	type,	addr,	size,	start);
+return	err;
+}
+
+inline	herr_t	trace_flush(H5FD_t	*file,	hid_t	dxpl,	hbool_t	closing)
+{
+return	H5FDflush(trace_file(file)->inner,	dxpl,	closing);
+}
+
+inline	herr_t	trace_truncate(H5FD_t	*file,	hid_t	dxpl,	hbool_t	closing)
+{
+return	H5FDtruncate(trace_file(file)->inner,	dxpl,	closing);
+}
+
+inline	herr_t	trace_lock(H5FD_t	*file,	hbool_t	rw)
+{
+return	H5FDlock(trace_file(file)->inner,	rw);
+}
+
+inline	herr_t	trace_unlock(H5FD_t	*file)
+{
+return	H5FDunlock(trace_file(file)->inner);
+}
+
+//	registered	once,	the	id	is	never	closed
+inline	hid_t	trace_driver_id()
+{
+static	const	hid_t	id	=	[]()
+{
+//	assigned	by	name,	the	layout	of	H5FD_class_t	differs	between	library	versions
+H5FD_class_t	c;
+std::memset(&c,	0,	sizeof(c));
+#ifdef	H5FD_CLASS_VERSION
+c.version	=	H5FD_CLASS_VERSION;
+c.value	=	HDF_WRAPPER_TRACE_VFD_VALUE;
+#endif
+c.name	=	"h5cpp_trace";
+c.maxaddr	=	HADDR_MAX;
+c.fc_degree	=	H5F_CLOSE_WEAK;
+c.fapl_size	=	sizeof(TraceDriverInfo);
+c.fapl_get	=	trace_fapl_get;
+c.fapl_copy	=	trace_fapl_copy;
+c.fapl_free	=	trace_fapl_free;
+c.open	=	trace_open;
+c.close	=	trace_close;
+c.cmp	=	trace_cmp;
+c.query	=	trace_query;
+c.get_eoa	=	trace_get_eoa;
+c.set_eoa	=	trace_set_eoa;
+c.get_eof	=	trace_get_eof;
+c.get_handle	=	trace_get_handle;
+c.read	=	trace_read;
+c.write	=	trace_write;
+c.flush	=	trace_flush;
+c.truncate	=	trace_truncate;
+c.lock	=	trace_lock;
+c.unlock	=	trace_unlock;
+const	H5FD_mem_t	fl_map[H5FD_MEM_NTYPES]	=	H5FD_FLMAP_DICHOTOMY;
+std::copy(fl_map,	fl_map	+	H5FD_MEM_NTYPES,	c.fl_map);
+return	H5FDregister(&c);
+}();
+if	(id	<	0)
+throw	Exception("cannot	register	the	tracing	file	driver");
+return	id;
+}
+
+/*
+Have	the	operating	system	write	a	flushed	file	to	the	disk	(fsync),	since
+H5Fflush	only	hands	the	data	to	the	OS.	Done	for	the	sec2	(default),	stdio,
+direct	and	io_uring	drivers;	the	MPI-IO	driver	syncs	on	flush	itself,	other
+drivers	are	left	alone.
+*/
+inline	void	sync_to_disk(hid_t	file_id)
+{
+Properties	fapl(H5Fget_access_plist(file_id),	internal::NoIncRC());
+hid_t	driver	=	H5Pget_driver(fapl.get_id());
+bool	posix_fd	=	driver	==	H5FD_SEC2;
+#ifdef	H5_HAVE_DIRECT
+posix_fd	=	posix_fd	||	driver	==	H5FD_DIRECT;
+#endif
+#ifdef	HDF_WRAPPER_HAS_IO_URING
+posix_fd	=	posix_fd	||	driver	==	io_uring_driver_id();
+#endif
+if	(!posix_fd	&&	driver	!=	H5FD_STDIO)
+return;
+void	*handle	=	NULL;
+if	(H5Fget_vfd_handle(file_id,	fapl.get_id(),	&handle)	<	0)
+throw	Exception("unable	to	get	file	handle");
+int	fd;
+if	(posix_fd)
+fd	=	*static_cast<int*>(handle);
+else
+{
+FILE	*stream	=	*static_cast<FILE**>(handle);
+if	(fflush(stream)	!=	0)
+throw	Exception("unable	to	flush	file");
+#ifdef	_MSC_VER
+fd	=	_fileno(stream);
+#else
+fd	=	fileno(stream);
+#endif
+}
+#ifdef	_MSC_VER
+if	(_commit(fd)	!=	0)
+#else
+if	(fsync(fd)	!=	0)
+#endif
+throw	Exception("unable	to	sync	file	to	disk");
+}
+
+}	//	namespace	internal
+
+
+class	File	:	public	Object
+{
+File(hid_t	id,	internal::NoIncRC)	:	Object(id)	{}	//	takes	a	file	handle	that	needs	to	be	closed.
+friend	class	Object;	//	because	Object	need	to	construct	File	using	the	above	constructor.
+
+void	open_file(const	std::string	&name,	const	std::string	&openmode,	hid_t	fapl_id)
+{
+register_shuffle_lz_filter();	//	so	datasets	using	it	can	be	read
+#if	defined(HDF_WRAPPER_X86_SIMD)	&&	!defined(HDF_WRAPPER_NO_FAST_CONVERSIONS)
+register_fast_conversions();
+#endif
+#ifndef	HDF_WRAPPER_NO_FAST_CONVERSIONS
+register_half_conversions();
+#endif
+bool	call_open	=	true;
+unsigned	int	flags;
+if	(openmode	==	"w")
+{
+flags	=	H5F_ACC_TRUNC;
+call_open	=	false;
+}
+else	if	(openmode	==	"a")	//	append	at	existing	file	or	create	new	file
+{
+if	(H5Fis_hdf5(name.c_str())>0)	//	file	exists,	so	open
+{
+call_open	=	true;
+flags	=	H5F_ACC_RDWR;
+}
+else	//	create	file
+{
+call_open	=	false;
+flags	=	H5F_ACC_TRUNC;
+}
+}
+else	if	(openmode	==	"w-")
+{
+flags	=	H5F_ACC_EXCL;
+call_open	=	false;
+}
+else	if	(openmode	==	"r")
+flags	=	H5F_ACC_RDONLY;
+else	if	(openmode	==	"r+")
+flags	=	H5F_ACC_RDWR;
+else
+throw	Exception("bad	openmode:	"	+	openmode);
+internal::HandleCache	&cache	=	internal::HandleCache::files();
+std::string	key	=	name	+	'\n'	+	(flags	==	H5F_ACC_RDONLY	?	"r"	:	"r+");
+//	only	plain	opens	of	existing	files	are	shared;	anything	else	must	not	find	the	file	open
+if	(cache.enabled()	&&	call_open	&&	fapl_id	==	H5P_DEFAULT	&&	(this->id	=	cache.get(key))	>=	0)
+{
+this->inc_ref();
+return;
+}
+if	(cache.enabled()	||	internal::HandleCache::objects().enabled())
+internal::invalidate_file_handles(name);	//	cached	objects	keep	their	file	open,	too
+if	(call_open)
+this->id	=	H5Fopen(name.c_str(),	flags	,	fapl_id);
+else
+this->id	=	H5Fcreate(name.c_str(),	flags	,	H5P_DEFAULT,	fapl_id);
+if	(this->id	<	0)
+throw	Exception("unable	to	open	file:	"	+	name);
+if	(call_open	&&	fapl_id	==	H5P_DEFAULT)
+cache.put(key,	this->id);
+}
+public:
+explicit	File(hid_t	id)	:	Object()	{	this->inc_ref();	}	//	a	logical	copy	of	the	original	given	by	id,
+
+/*
+w	=	create	or	truncate	existing	file
+a	=	append	to	file	or	create	new	file
+r	=	read	only;	file	must	exist
+w-	=	new	file;	file	must	not	already	exist
+r+	=	read/write;	file	must	exist
+*/
+File(const	std::string	&name,	const	std::string	openmode	=	"w")	:	Object()
+{
+open_file(name,	openmode,	H5P_DEFAULT);
+}
+
+//	with	file	access	properties,	e.g.	Properties(H5P_FILE_ACCESS).mpio(comm)
+File(const	std::string	&name,	const	std::string	openmode,	const	Properties	&fapl)	:	Object()
+{
+open_file(name,	openmode,	fapl.get_id());
+}
+
+#ifdef	HDF_WRAPPER_HAS_MPI
+//	collective	open/create;	all	processes	of	comm	must	call	this	with	the	same	arguments
+static	File	parallel(const	std::string	&name,	const	std::string	openmode,	MPI_Comm	comm,	MPI_Info	info	=	MPI_INFO_NULL)
+{
+Properties	fapl(H5P_FILE_ACCESS);
+fapl.mpio(comm,	info);
+return	File(name,	openmode,	fapl);
+}
+#endif
+
+/*
+Opens	the	file	with	the	direct	driver	(O_DIRECT),	which	bypasses	the	page
+cache,	and	objects	of	at	least	alignment	bytes	aligned	to	it	in	the	file.
+Falls	back	to	the	default	driver,	with	the	same	alignment,	if	the	HDF5	library
+was	built	without	the	direct	driver	or	the	file	system	refuses	O_DIRECT	(e.g.
+tmpfs);	*is_direct	tells	which	one	is	used.	Only	contiguous	datasets	are
+transferred	without	copies,	and	only	from	and	to	aligned	buffers,	see
+AlignedAllocator;	chunks	always	go	through	the	chunk	cache.
+*/
+static	File	direct(const	std::string	&name,	const	std::string	openmode	=	"w",	size_t	alignment	=	HDF_WRAPPER_DIRECT_IO_ALIGNMENT,	bool	*is_direct	=	NULL)
+{
+#ifdef	H5_HAVE_DIRECT
+try
+{
+Properties	fapl(H5P_FILE_ACCESS);
+fapl.alignment(alignment,	alignment).direct(alignment,	alignment);
+AutoErrorReportingGuard	guard;
+guard.disableReporting();
+File	f(name,	openmode,	fapl);
+if	(is_direct)	*is_direct	=	true;
+return	f;
+}
+catch	(const	Exception	&)
+{
+}
+#endif
+if	(is_direct)	*is_direct	=	false;
+Properties	fapl(H5P_FILE_ACCESS);
+fapl.alignment(alignment,	alignment);
+return	File(name,	openmode,	fapl);
+}
+
+#ifdef	HDF_WRAPPER_HAS_IO_URING
+/*
+Opens	the	file	with	the	io_uring	driver.	Transfers	larger	than
+options.segment_bytes	are	split	into	segments	which	are	in	flight	together,
+small	ones	use	buffers	registered	with	the	kernel;	with	HDF5	>=	1.14,	vector
+requests	are	submitted	as	one	batch.	Without	io_uring	(old	kernels,	seccomp)
+the	driver	falls	back	to	pread	and	pwrite,	see	io_uring_available.	Other	file
+access	settings	can	be	given	in	fapl.
+*/
+static	File	io_uring(const	std::string	&name,	const	std::string	openmode	=	"w",	const	IoUringOptions	&options	=	IoUringOptions(),	const	Properties	&fapl	=	Properties(H5P_FILE_ACCESS))
+{
+Properties	p(H5Pcopy(fapl.get_id()),	internal::NoIncRC());
+if	(H5Pset_driver(p.get_id(),	internal::io_uring_driver_id(),	&options)	<	0)
+throw	Exception("error	setting	io_uring	file	driver");
+return	File(name,	openmode,	p);
+}
+#endif
+
+/*
+Opens	the	file	with	a	driver	which	records	every	read	and	write	in	trace	and
+passes	it	on	to	the	driver	of	fapl,	by	default	sec2;	see	analyze_io_trace.	The
+trace	must	outlive	the	file.
+*/
+static	File	traced(const	std::string	&name,	const	std::string	openmode,	IoTrace	&trace,	const	Properties	&fapl	=	Properties(H5P_FILE_ACCESS))
+{
+Properties	p(H5Pcopy(fapl.get_id()),	internal::NoIncRC());
+internal::TraceDriverInfo	info	=	{	&trace,	fapl.get_id()	};
+if	(H5Pset_driver(p.get_id(),	internal::trace_driver_id(),	&info)	<	0)
+throw	Exception("error	setting	tracing	file	driver");
+return	File(name,	openmode,	p);
+}
+
+File()	:	Object()	{}
+
+void	open(const	std::string	&name,	const	std::string	openmode	=	"w")
+{
+this->~File();
+new	(this)	File(name,	openmode);
+}
+
+void	close()
+{
+if	(this->id	==	-1)	return;
+if	(internal::HandleCache::files().enabled()	||	internal::HandleCache::objects().enabled())
+internal::invalidate_file_handles(internal::file_name_of(this->id));	//	so	the	file	really	closes
+herr_t	err	=	H5Fclose(this->id);
+this->id	=	-1;
+if	(err	<	0)
+throw	Exception("unable	to	close	file");
+}
+
+Group	root()
+{
+return	Group(internal::cached_open(this->id,	"/",	'G',	Group::open_group_id),	internal::NoIncRC());
+}
+
+//	H5F_SCOPE_GLOBAL	also	flushes	files	mounted	on	this	one
+void	flush(H5F_scope_t	scope	=	H5F_SCOPE_LOCAL)
+{
+herr_t	err	=	H5Fflush(this->id,	scope);
+if	(err	<	0)
+throw	Exception("unable	to	flush	file");
+}
+
+//	flush(),	then	fsync	the	file,	see	internal::sync_to_disk
+void	sync()
+{
+flush();
+internal::sync_to_disk(this->id);
+}
+
+FileCacheStats	cache_stats()	const
+{
+FileCacheStats	s;
+if	(H5Fget_mdc_hit_rate(this->id,	&s.mdc_hit_rate)	<	0)
+throw	Exception("cannot	get	metadata	cache	hit	rate");
+if	(H5Fget_mdc_size(this->id,	&s.mdc_max_size,	&s.mdc_min_clean_size,	&s.mdc_cur_size,	&s.mdc_num_entries)	<	0)
+throw	Exception("cannot	get	metadata	cache	size");
+H5AC_cache_config_t	config;
+config.version	=	H5AC__CURR_CACHE_CONFIG_VERSION;
+if	(H5Fget_mdc_config(this->id,	&config)	<	0)
+throw	Exception("cannot	get	metadata	cache	configuration");
+s.mdc_config_max_size	=	config.max_size;
+#if	H5_VERSION_GE(1,	10,	1)
+Object	fapl(H5Fget_access_plist(this->id));
+if	(H5Pget_page_buffer_size(fapl.get_id(),	&s.page_buffer_size,	NULL,	NULL)	>=	0	&&	s.page_buffer_size	>	0)
+{
+s.page_buffering	=	H5Fget_page_buffering_stats(this->id,	s.page_accesses,	s.page_hits,	s.page_misses,	s.page_evictions,	s.page_bypasses)	>=	0;
+}
+#endif
+return	s;
+}
+
+void	reset_cache_stats()
+{
+if	(H5Freset_mdc_hit_rate_stats(this->id)	<	0)
+throw	Exception("cannot	reset	metadata	cache	statistics");
+#if	H5_VERSION_GE(1,	10,	1)
+if	(cache_stats().page_buffering	&&	H5Freset_page_buffering_stats(this->id)	<	0)
+throw	Exception("cannot	reset	page	buffer	statistics");
+#endif
+}
+
+//	upper	limit	of	the	metadata	cache	size;	the	cache	is	resized	adaptively	below	it
+void	set_mdc_max_size(size_t	max_size)
+{
+H5AC_cache_config_t	config;
+config.version	=	H5AC__CURR_CACHE_CONFIG_VERSION;
+if	(H5Fget_mdc_config(this->id,	&config)	<	0)
+throw	Exception("cannot	get	metadata	cache	configuration");
+config.max_size	=	max_size;
+config.min_size	=	std::min(config.min_size,	max_size);
+config.initial_size	=	std::min(std::max(config.initial_size,	config.min_size),	max_size);
+config.set_initial_size	=	true;
+if	(H5Fset_mdc_config(this->id,	&config)	<	0)
+throw	Exception("cannot	set	metadata	cache	configuration");
+}
+
+#if	H5_VERSION_GE(1,	10,	0)
+//	requires	a	file	opened	with	Properties::mdc_logging
+void	start_mdc_logging()
+{
+if	(H5Fstart_mdc_logging(this->id)	<	0)
+throw	Exception("unable	to	start	metadata	cache	logging");
+}
+
+void	stop_mdc_logging()
+{
+if	(H5Fstop_mdc_logging(this->id)	<	0)
+throw	Exception("unable	to	stop	metadata	cache	logging");
+}
+#endif
+};
+
+
+
+inline	File	Object::get_file()	const
+{
+hid_t	fid	=	H5Iget_file_id(id);	//	it	seems	to	increase	the	reference	count	by	its	own.	(The	returned	id
+//	https://www.hdfgroup.org/HDF5/doc/RM/RM_H5I.html#Identify-GetFileId
+if	(fid	<	0)
+throw	Exception("cannot	get	file	id	from	object");
+return	File(fid,	internal::NoIncRC());
+}
+
+
+//	datasets	with	CREATE_DS_COMPACT_SMALL	up	to	this	size	are	stored	in	the	object	header
+#ifndef	HDF_WRAPPER_COMPACT_DS_MAX_BYTES
+#define	HDF_WRAPPER_COMPACT_DS_MAX_BYTES	4096
+#endif
+
+enum	DsCreationFlags
+{
+CREATE_DS_0	=	0,
+CREATE_DS_COMPRESSED	=	1,
+CREATE_DS_CHUNKED	=	2,
+CREATE_DS_NO_FILL	=	4,	//	no	fill	values	are	written,	storage	is	allocated	when	data	is	written
+CREATE_DS_COMPACT_SMALL	=	8,	//	compact	layout	for	small	datasets,	overriding	the	flags	above
+CREATE_DS_SHUFFLE	=	16,	//	byte	shuffle	before	compression,	helps	with	floating	point	data
+CREATE_DS_SHUFFLE_LZ	=	32,	//	the	built-in	shuffle	+	LZ	filter,	see	Properties::shuffle_lz
+CREATE_DS_FLOAT16	=	64,	//	floating	point	data	is	stored	as	IEEE	half	precision	floats
+CREATE_DS_BFLOAT16	=	128,	//	floating	point	data	is	stored	as	bfloat16
+#ifndef	HDF_WRAPPER_DS_CREATION_DEFAULT_FLAGS
+#ifdef	H5_HAVE_FILTER_DEFLATE
+CREATE_DS_DEFAULT	=	CREATE_DS_COMPRESSED
+#else
+CREATE_DS_DEFAULT	=	CREATE_DS_0
+#endif
+#else
+CREATE_DS_DEFAULT	=	HDF_WRAPPER_DS_CREATION_DEFAULT_FLAGS
+#endif
+};
+
+namespace	internal
+{
+
+//	the	disk	type	with	floating	point	types	replaced	according	to	CREATE_DS_FLOAT16	or	CREATE_DS_BFLOAT16
+inline	Datatype	apply_disktype_flags(const	Datatype	&dtype,	DsCreationFlags	flags)
+{
+if	(!(flags	&	(CREATE_DS_FLOAT16	|	CREATE_DS_BFLOAT16))	||	dtype.get_class()	!=	H5T_FLOAT)
+return	dtype;
+return	flags	&	CREATE_DS_FLOAT16	?	Datatype::createFloat16()	:	Datatype::createBFloat16();
+}
+
+}	//	namespace	internal
+
+
+
+
+
+class	Dataset	:	public	Object
+{
+friend	class	Group;
+private:
+Dataset(hid_t	loc_id,	const	std::string	&name,	hid_t	dapl_id,	internal::TagOpen)
+{
+this->id	=	H5Dopen2(loc_id,	name.c_str(),	dapl_id);
+if	(this->id	<	0)
+throw	Exception("unable	to	open	dataset:	"+name);
+}
+
+static	hid_t	open_dataset_id(hid_t	loc_id,	const	std::string	&name)
+{
+hid_t	id	=	H5Dopen2(loc_id,	name.c_str(),	H5P_DEFAULT);
+if	(id	<	0)
+throw	Exception("unable	to	open	dataset:	"+name);
+return	id;
+}
+
+template<class	T>
+void	write(Dataspace	memspace,	hid_t	disk_space_id,	const	T*	data,	hid_t	xfer_id	=	H5P_DEFAULT)
+{
+Datatype	memtype	=	get_memtype<T>();
+RWdataset	rw(get_id(),	memtype.get_id(),	memspace.get_id(),	disk_space_id,	xfer_id);
+h5traits_of<T>::type::write(rw,	memtype,	memspace,	data);
+}
+
+template<class	T>
+void	read(Dataspace	memspace,	hid_t	disk_space_id,	T*	data,	hid_t	xfer_id	=	H5P_DEFAULT)	const
+{
+Datatype	memtype	=	get_memtype<T>();
+RWdataset	rw(get_id(),	memtype.get_id(),	memspace.get_id(),	disk_space_id,	xfer_id);
+h5traits_of<T>::type::read(rw,	memtype,	memspace,	data);
+}
+
+//	in	a	collective	transfer	every	process	has	to	call	H5Dread/H5Dwrite,	even	with	nothing	selected
+static	bool	is_collective(hid_t	xfer_id)
+{
+#ifdef	HDF_WRAPPER_HAS_MPI
+H5FD_mpio_xfer_t	mode;
+return	xfer_id	!=	H5P_DEFAULT	&&	H5Pget_dxpl_mpio(xfer_id,	&mode)	>=	0	&&	mode	==	H5FD_MPIO_COLLECTIVE;
+#else
+(void)xfer_id;
+return	false;
+#endif
+}
+
+template<class	T>
+void	read_selection(const	Selection	&sel,	T	*data,	hid_t	xfer_id)	const
+{
+if	(sel.size()	==	0	&&	!is_collective(xfer_id))	return;
+Dataspace	file_space,	mem_space;
+sel.get_dataspaces(get_dataspace(),	file_space,	mem_space);
+read(mem_space,	file_space.get_id(),	data,	xfer_id);
+}
+
+template<class	T>
+void	write_selection(const	Selection	&sel,	const	T	*data,	hid_t	xfer_id)
+{
+if	(sel.size()	==	0	&&	!is_collective(xfer_id))	return;
+Dataspace	file_space,	mem_space;
+sel.get_dataspaces(get_dataspace(),	file_space,	mem_space);
+write(mem_space,	file_space.get_id(),	data,	xfer_id);
+}
+
+Dataset(hid_t	id,	internal::NoIncRC)	:	Object(id)	{}	//	we	get	an	existing	reference,	no	need	to	increase	the	ref
+
+public:
+Dataset()	:	Object()	{}
+explicit	Dataset(hid_t	id)	:	Object(id)	{	Object::inc_ref();	}	//	we	manage	the	new	reference
+
+static	Dataset	create(Group	group,	const	std::string	&name,	const	Datatype&	dtype,	const	Dataspace	&space,	const	Properties	&prop)
+{
+hid_t	id	=	H5Dcreate2(group.get_id(),	name.c_str(),
+dtype.get_id(),	space.get_id(),
+H5P_DEFAULT,	prop.get_id(),	H5P_DEFAULT);
+if	(id	<	0)
+throw	Exception("error	creating	dataset:	"+name);
+return	Dataset(id,	internal::NoIncRC());
+}
+
+static	Dataset	create(Group	group,	const	std::string	&name,	const	Datatype&	dtype,	const	Dataspace	&space,	const	Properties	&prop,	const	Properties	&access)
+{
+hid_t	id	=	H5Dcreate2(group.get_id(),	name.c_str(),
+dtype.get_id(),	space.get_id(),
+H5P_DEFAULT,	prop.get_id(),	access.get_id());
+if	(id	<	0)
+throw	Exception("error	creating	dataset:	"+name);
+return	Dataset(id,	internal::NoIncRC());
+}
+
+template<class	T>
+static	Dataset	create(Group	group,	const	std::string	&name,	const	Dataspace	&space,	DsCreationFlags	flags	=	CREATE_DS_DEFAULT)
+{
+Datatype	dtype	=	internal::apply_disktype_flags(get_disktype<T>(),	flags);
+return	Dataset::create(group,	name,	dtype,	space,	create_creation_properties(space,	flags,	dtype));
+}
+
+template<class	T>
+void	write(const	Dataspace	&mem_space,	const	Dataspace	&file_space,	const	T*	data)
+{
+write(mem_space,	file_space.get_id(),	data);
+}
+
+template<class	T>
+void	read(const	Dataspace	&mem_space,	const	Dataspace	&file_space,	T*	data)	const
+{
+read(mem_space,	file_space.get_id(),	data);
+}
+
+template<class	T>
+void	write(const	T*	data)
+{
+Dataspace	ds	=	get_dataspace();
+write(ds,	H5S_ALL,	data);
+}
+
+static	Properties	create_creation_properties(const	Dataspace	&sp,	DsCreationFlags	flags)
+{
+return	create_creation_properties(sp,	flags,	Datatype());
+}
+
+//	dtype	is	needed	to	determine	the	size	for	CREATE_DS_COMPACT_SMALL
+static	Properties	create_creation_properties(const	Dataspace	&sp,	DsCreationFlags	flags,	const	Datatype	&dtype)
+{
+Properties	prop(H5P_DATASET_CREATE);
+if	(flags	&	CREATE_DS_NO_FILL)
+prop.fill_time(H5D_FILL_TIME_NEVER);
+if	(flags	&	CREATE_DS_COMPACT_SMALL	&&	dtype.is_valid()	&&	prop.compact_if_smaller(sp,	dtype,	HDF_WRAPPER_COMPACT_DS_MAX_BYTES))
+return	prop;
+if	(flags	&	CREATE_DS_SHUFFLE)
+prop.shuffle();
+if	(flags	&	CREATE_DS_COMPRESSED)
+prop.deflate();
+if	(flags	&	CREATE_DS_SHUFFLE_LZ)
+prop.shuffle_lz();
+if	(flags	&	CREATE_DS_CHUNKED	||	flags	&	CREATE_DS_COMPRESSED	||	flags	&	CREATE_DS_SHUFFLE	||	flags	&	CREATE_DS_SHUFFLE_LZ)
+prop.chunked_with_estimated_size(sp);
+else	if	(flags	&	CREATE_DS_NO_FILL)
+prop.alloc_time(H5D_ALLOC_TIME_LATE);	//	chunked	datasets	keep	the	library's	incremental	allocation
+return	prop;
+}
+
+DatasetIoStats	io_stats()	const
+{
+DatasetIoStats	s;
+Dataspace	sp	=	get_dataspace();
+s.rank	=	sp.get_dims(s.dims);
+Datatype	dtype	=	get_datatype();
+s.logical_bytes	=	H5Sget_simple_extent_npoints(sp.get_id())	*	dtype.get_size();
+s.storage_bytes	=	H5Dget_storage_size(this->id);
+Object	dcpl(H5Dget_create_plist(this->id));
+s.chunked	=	H5Pget_layout(dcpl.get_id())	==	H5D_CHUNKED;
+if	(s.chunked)
+{
+H5Pget_chunk(dcpl.get_id(),	H5S_MAX_RANK,	s.chunk_dims);
+s.chunk_bytes	=	dtype.get_size();
+for	(int	d=0;	d<s.rank;	++d)
+s.chunk_bytes	*=	s.chunk_dims[d];
+#if	H5_VERSION_GE(1,	10,	5)
+if	(H5Dget_num_chunks(this->id,	sp.get_id(),	&s.allocated_chunks)	<	0)
+throw	Exception("cannot	get	number	of	chunks");
+#endif
+Object	dapl(H5Dget_access_plist(this->id));
+if	(H5Pget_chunk_cache(dapl.get_id(),	&s.chunk_cache_slots,	&s.chunk_cache_bytes,	&s.chunk_cache_w0)	<	0)
+throw	Exception("cannot	get	chunk	cache	settings");
+}
+return	s;
+}
+
+//	a	copy	of	the	creation	properties
+Properties	get_creation_properties()	const
+{
+hid_t	id	=	H5Dget_create_plist(this->id);
+if	(id	<	0)
+throw	Exception("cannot	get	dataset	creation	properties");
+return	Properties(id,	internal::NoIncRC());
+}
+Attributes	attrs()
+{
+return	Attributes(*this);
+}
+
+Dataspace	get_dataspace()	const
+{
+hid_t	id	=	H5Dget_space(this->id);
+if	(id	<	0)
+throw	Exception("unable	to	get	dataspace	of	dataset");
+return	Dataspace(id,	internal::NoIncRC());
+}
+
+Datatype	get_datatype()	const
+{
+hid_t	type_id	=	H5Dget_type(this->id);
+if	(type_id<0)
+throw	Exception("unable	to	get	type	of	Attribute");
+return	Datatype(type_id);
+}
+
+//	change	the	current	dimensions,	within	the	maximum	dimensions	given	at	creation
+void	set_extent(const	hsize_t	*dims)
+{
+herr_t	err	=	H5Dset_extent(this->id,	dims);
+if	(err	<	0)
+throw	Exception("unable	to	change	extent	of	dataset");
+}
+
+template<class	T>
+void	read(T	*data)	const
+{
+Dataspace	ds	=	get_dataspace();
+read(ds,	H5S_ALL,	data);
+}
+
+//	elements	within	range,	using	the	zone	map	if	there	is	one;	see	build_zone_map
+template<class	T>
+void	read_where(const	ValueRange	&range,	std::vector<hsize_t>	&indices,	std::vector<T>	&values)	const;
+
+/*
+Transfer	the	elements	of	a	selection.	The	memory	buffer	holds	sel.size()	index
+tuples	times	the	trailing	dimensions,	in	ascending	index	order.
+*/
+template<class	T>
+void	read(const	Selection	&sel,	T	*data)	const
+{
+read_selection(sel,	data,	H5P_DEFAULT);
+}
+
+template<class	T>
+void	write(const	Selection	&sel,	const	T	*data)
+{
+write_selection(sel,	data,	H5P_DEFAULT);
+}
+
+/*
+Overloads	with	data	transfer	properties,	e.g.	Properties(H5P_DATASET_XFER).collective()
+for	collective	MPI-IO.
+*/
+template<class	T>
+void	read(T	*data,	const	Properties	&xfer)	const
+{
+read(get_dataspace(),	H5S_ALL,	data,	xfer.get_id());
+}
+
+template<class	T>
+void	write(const	T	*data,	const	Properties	&xfer)
+{
+write(get_dataspace(),	H5S_ALL,	data,	xfer.get_id());
+}
+
+template<class	T>
+void	read(const	Dataspace	&mem_space,	const	Dataspace	&file_space,	T	*data,	const	Properties	&xfer)	const
+{
+read(mem_space,	file_space.get_id(),	data,	xfer.get_id());
+}
+
+template<class	T>
+void	write(const	Dataspace	&mem_space,	const	Dataspace	&file_space,	const	T	*data,	const	Properties	&xfer)
+{
+write(mem_space,	file_space.get_id(),	data,	xfer.get_id());
+}
+
+template<class	T>
+void	read(const	Selection	&sel,	T	*data,	const	Properties	&xfer)	const
+{
+read_selection(sel,	data,	xfer.get_id());
+}
+
+template<class	T>
+void	write(const	Selection	&sel,	const	T	*data,	const	Properties	&xfer)
+{
+write_selection(sel,	data,	xfer.get_id());
+}
+};
+
+
+
+
+
+inline	Dataset	Group::open_dataset(const	std::string	&name)
+{
+return	Dataset(internal::cached_open(this->id,	name,	'D',	Dataset::open_dataset_id),	internal::NoIncRC());
+}
+
+inline	Dataset	Group::open_dataset(const	std::string	&name,	const	Properties	&dapl)
+{
+return	Dataset(this->id,	name,	dapl.get_id(),	internal::TagOpen());
+}
+
+#ifdef	HDF_WRAPPER_HAS_BOOST
+inline	boost::optional<Dataset>	Group::try_open_dataset(const	std::string	&name)
+{
+hid_t	id;
+{
+AutoErrorReportingGuard	guard;
+guard.disableReporting();
+id	=	H5Dopen2(this->id,	name.c_str(),	H5P_DEFAULT);
+}
+if	(id	<	0)
+{
+if	(exists(name))	//	well	so	the	dataset	exists	but	for	some	reason	it	cannot	be	opened	->	error
+throw	Exception("unable	to	open	existing	item	as	dataset:	"+name);
+else
+return	boost::optional<Dataset>();	//	no	dataset	under	this	name
+}
+else	return	boost::optional<Dataset>(Dataset(id,	internal::NoIncRC()));
+}
+#endif
+
+
+/*
+A	batch	of	dataset	transfers	which	is	issued	in	one	library	call	with
+H5Dread_multi/H5Dwrite_multi,	if	the	HDF5	library	provides	them	(1.14	and	up).
+Otherwise	the	transfers	are	performed	one	after	another	in	the	order	they	were
+added.	Buffers	must	stay	valid	until	read()	or	write()	is	called.	Elements	are
+transferred	without	conversion	by	the	wrapper,	therefore	only	plain	types	can	be
+batched,	e.g.	no	std::string.
+*/
+class	DatasetBatch
+{
+std::vector<Dataset>	datasets;
+std::vector<Datatype>	memtypes;
+std::vector<Dataspace>	spaces;	//	keeps	the	ids	below	alive
+std::vector<hid_t>	dset_ids,	mem_type_ids,	mem_space_ids,	file_space_ids;
+std::vector<const	void*>	buffers;
+bool	has_const_buffers;
+
+template<class	T>
+void	add(const	Dataset	&ds,	const	Dataspace	&mem_space,	hid_t	file_space_id,	const	T	*data)
+{
+static_assert(std::is_trivially_copyable<T>::value	&&	!std::is_array<T>::value,	"batched	transfers	need	plain	element	types");
+Datatype	memtype	=	get_memtype<T>();
+datasets.push_back(ds);
+memtypes.push_back(memtype);
+spaces.push_back(mem_space);
+dset_ids.push_back(ds.get_id());
+mem_type_ids.push_back(memtype.get_id());
+mem_space_ids.push_back(mem_space.get_id());
+file_space_ids.push_back(file_space_id);
+buffers.push_back(data);
+}
+
+public:
+DatasetBatch()	:	has_const_buffers(false)	{}
+
+//	the	entire	dataset
+template<class	T>
+void	add(const	Dataset	&ds,	T	*data)
+{
+has_const_buffers	|=	std::is_const<T>::value;
+add<typename	std::remove_cv<T>::type>(ds,	ds.get_dataspace(),	H5S_ALL,	data);
+}
+
+template<class	T>
+void	add(const	Dataset	&ds,	const	Selection	&sel,	T	*data)
+{
+has_const_buffers	|=	std::is_const<T>::value;
+//	empty	selections	are	kept,	in	a	collective	transfer	every	process	has	to	take	part
+Dataspace	file_space,	mem_space;
+sel.get_dataspaces(ds.get_dataspace(),	file_space,	mem_space);
+spaces.push_back(file_space);
+add<typename	std::remove_cv<T>::type>(ds,	mem_space,	file_space.get_id(),	data);
+}
+
+size_t	size()	const	{	return	dset_ids.size();	}
+
+void	clear()
+{
+datasets.clear();	memtypes.clear();	spaces.clear();
+dset_ids.clear();	mem_type_ids.clear();	mem_space_ids.clear();	file_space_ids.clear();
+buffers.clear();
+has_const_buffers	=	false;
+}
+
+void	read(const	Properties	&xfer)
+{
+read(xfer.get_id());
+}
+
+void	write(const	Properties	&xfer)
+{
+write(xfer.get_id());
+}
+
+void	read(hid_t	xfer_id	=	H5P_DEFAULT)
+{
+if	(has_const_buffers)
+throw	Exception("cannot	read	into	const	buffers");
+if	(dset_ids.empty())	return;
+#if	H5_VERSION_GE(1,	14,	0)
+std::vector<void*>	bufs(buffers.size());
+for	(size_t	i=0;	i<buffers.size();	++i)	bufs[i]	=	const_cast<void*>(buffers[i]);
+herr_t	err	=	H5Dread_multi(dset_ids.size(),	dset_ids.data(),	mem_type_ids.data(),	mem_space_ids.data(),	file_space_ids.data(),	xfer_id,	bufs.data());
+if	(err	<	0)
+throw	Exception("error	reading	from	multiple	datasets");
+#else
+for	(size_t	i=0;	i<dset_ids.size();	++i)
+{
+RWdataset	rw(dset_ids[i],	mem_type_ids[i],	mem_space_ids[i],	file_space_ids[i],	xfer_id);
+rw.read(const_cast<void*>(buffers[i]));
+}
+#endif
+}
+
+void	write(hid_t	xfer_id	=	H5P_DEFAULT)
+{
+if	(dset_ids.empty())	return;
+#if	H5_VERSION_GE(1,	14,	0)
+for	(size_t	i=0;	i<dset_ids.size();	++i)
+internal::invalidate_zone_map(dset_ids[i]);
+herr_t	err	=	H5Dwrite_multi(dset_ids.size(),	dset_ids.data(),	mem_type_ids.data(),	mem_space_ids.data(),	file_space_ids.data(),	xfer_id,	buffers.data());
+if	(err	<	0)
+throw	Exception("error	writing	to	multiple	datasets");
+#else
+for	(size_t	i=0;	i<dset_ids.size();	++i)
+{
+RWdataset	rw(dset_ids[i],	mem_type_ids[i],	mem_space_ids[i],	file_space_ids[i],	xfer_id);
+rw.write(buffers[i]);
+}
+#endif
+}
+};
+
+
+/*
+Builds	a	virtual	dataset	(VDS),	which	stitches	regions	of	other	datasets,
+usually	in	other	files,	into	one	logical	dataset	without	copying	data.
+Each	mapping	relates	a	selection	of	the	virtual	extent	to	a	selection	of
+a	source	dataset.	A	source	file	name	of	"."	refers	to	the	file	containing
+the	virtual	dataset.	Reading	works	through	the	normal	read	functions.	Regions
+without	available	source	data	read	as	the	fill	value.
+E.g.	one	dataset	per	rank,	stacked	along	the	first	dimension:
+
+hsize_t	dims[2]	=	{	nranks	*	n,	m	},	src_dims[2]	=	{	n,	m	};
+VirtualDataset	vds(Dataspace::simple(2,	dims));
+for	(int	i=0;	i<nranks;	++i)
+{
+hsize_t	offset[2]	=	{	i	*	n,	0	};
+vds.map(offset,	"rank"+std::to_string(i)+".h5",	"/data",	src_dims);
+}
+vds.create<float>(file.root(),	"data");
+*/
+class	VirtualDataset
+{
+Dataspace	vspace;
+Properties	dcpl;
+
+public:
+//	virtual_space	may	have	unlimited	maximum	dimensions,	for	unlimited	mappings
+explicit	VirtualDataset(const	Dataspace	&virtual_space)	:	vspace(virtual_space),	dcpl(H5P_DATASET_CREATE)	{}
+
+VirtualDataset&	map(const	Dataspace	&virtual_selection,	const	std::string	&src_file,	const	std::string	&src_dataset,	const	Dataspace	&src_selection)
+{
+herr_t	err	=	H5Pset_virtual(dcpl.get_id(),	virtual_selection.get_id(),	src_file.c_str(),	src_dataset.c_str(),	src_selection.get_id());
+if	(err	<	0)
+throw	Exception("error	adding	virtual	dataset	mapping	for	"+src_file+":"+src_dataset);
+return	*this;
+}
+
+//	an	entire	source	dataset	with	dimensions	src_dims,	placed	at	offset
+VirtualDataset&	map(const	hsize_t	*offset,	const	std::string	&src_file,	const	std::string	&src_dataset,	const	hsize_t	*src_dims)
+{
+int	rank	=	vspace.get_rank();
+hsize_t	count[H5S_MAX_RANK];
+std::fill(count,	count	+	rank,	1);
+Dataspace	vsel	=	vspace.copy();
+vsel.select_hyperslab(offset,	NULL,	count,	src_dims);
+return	map(vsel,	src_file,	src_dataset,	Dataspace::simple(rank,	src_dims));
+}
+
+/*
+Printf-style	mapping	of	an	unbounded	series	of	source	datasets	with	dimensions
+src_dims.	The	file	or	dataset	name	contains	"%b",	which	is	replaced	by	the
+block	number	0,	1,	2,	...	Block	i	is	placed	at	offset	+	i	*	src_dims[dim]	along
+dimension	dim.	The	virtual	extent	must	be	unlimited	along	dim.	Use
+virtual_printf_gap	in	the	access	properties	to	tolerate	missing	blocks.
+*/
+VirtualDataset&	map_pattern(int	dim,	const	hsize_t	*offset,	const	std::string	&src_file_pattern,	const	std::string	&src_dataset_pattern,	const	hsize_t	*src_dims)
+{
+int	rank	=	vspace.get_rank();
+hsize_t	start[H5S_MAX_RANK],	stride[H5S_MAX_RANK],	count[H5S_MAX_RANK],	block[H5S_MAX_RANK];
+for	(int	i=0;	i<rank;	++i)
+{
+start[i]	=	offset[i];
+stride[i]	=	src_dims[i];
+count[i]	=	i	==	dim	?	H5S_UNLIMITED	:	1;
+block[i]	=	src_dims[i];
+}
+Dataspace	vsel	=	vspace.copy();
+vsel.select_hyperslab(start,	stride,	count,	block);
+return	map(vsel,	src_file_pattern,	src_dataset_pattern,	Dataspace::simple(rank,	src_dims));
+}
+
+/*
+Mapping	of	a	source	dataset	which	grows	along	dimension	dim.	Everything	the
+source	contains	along	dim	is	visible	in	the	virtual	dataset,	starting	at
+offset.	src_dims	gives	the	fixed	size	of	the	other	dimensions.
+*/
+VirtualDataset&	map_unlimited(int	dim,	const	hsize_t	*offset,	const	std::string	&src_file,	const	std::string	&src_dataset,	const	hsize_t	*src_dims)
+{
+int	rank	=	vspace.get_rank();
+hsize_t	start[H5S_MAX_RANK],	count[H5S_MAX_RANK],	block[H5S_MAX_RANK],	maxdims[H5S_MAX_RANK];
+for	(int	i=0;	i<rank;	++i)
+{
+start[i]	=	0;
+count[i]	=	1;
+block[i]	=	i	==	dim	?	H5S_UNLIMITED	:	src_dims[i];
+maxdims[i]	=	i	==	dim	?	H5S_UNLIMITED	:	src_dims[i];
+}
+Dataspace	src	=	Dataspace::simple(rank,	src_dims,	maxdims);
+src.select_hyperslab(start,	NULL,	count,	block);
+Dataspace	vsel	=	vspace.copy();
+vsel.select_hyperslab(offset,	NULL,	count,	block);
+return	map(vsel,	src_file,	src_dataset,	src);
+}
+
+//	value	of	regions	without	source	data
+template<class	T>
+VirtualDataset&	fill_value(const	T	&value)
+{
+dcpl.fill_value(value);
+return	*this;
+}
+
+Properties&	creation_properties()	{	return	dcpl;	}
+
+/*
+Access	properties	for	opening	the	virtual	dataset,	see	Group::open_dataset.
+H5D_VDS_LAST_AVAILABLE	extends	unlimited	dimensions	to	the	largest	source,
+H5D_VDS_FIRST_MISSING	stops	at	the	first	missing	data.
+*/
+static	Properties	access_properties(H5D_vds_view_t	view	=	H5D_VDS_LAST_AVAILABLE,	hsize_t	printf_gap	=	0)
+{
+Properties	dapl(H5P_DATASET_ACCESS);
+dapl.virtual_view(view);
+dapl.virtual_printf_gap(printf_gap);
+return	dapl;
+}
+
+Dataset	create(Group	group,	const	std::string	&name,	const	Datatype	&dtype,	const	Properties	&access	=	Properties(H5P_DATASET_ACCESS))
+{
+return	Dataset::create(group,	name,	dtype,	vspace,	dcpl,	access);
+}
+
+template<class	T>
+Dataset	create(Group	group,	const	std::string	&name,	const	Properties	&access	=	Properties(H5P_DATASET_ACCESS))
+{
+return	create(group,	name,	get_disktype<T>(),	access);
+}
+};
+
+
+
+
+namespace	internal
+{
+
+/*	This	section	deals	with	creation	of	Datatype	objects	for	basic	data	types.
+Copy	is	used	on	HDF	API	constants	like	"H5T_NATIVE_INT"	because	Datatype
+object	cannot	handle	these	constants.	This	is	because	H5T_NATIVE_INT,	etc.
+are	apparently	not	real	objects,	i.e.	H5O_isvalid	indicates	false.	Some	special
+case	handling	for	these	constants	might	be	needed	instead.
+*/
+template<class	T>
+inline	Datatype	get_memtype()
+{
+//	writing	sizeof(T)==0	seems	to	work	for	gcc.	just	writing	false	always	causes	an	error????!
+static_assert	(sizeof(T)==0,	"specialize	me!");
+return	Datatype();
+}
+
+template<class	T>
+inline	Datatype	get_disktype()
+{
+static_assert	(sizeof(T)==0,	"specialize	me!");
+return	Datatype();
+}
+
+
+#define	HDF5_WRAPPER_SPECIALIZE_TYPE(T,	tid,	dtid)	\
+template<>	inline	Datatype	get_memtype<T>()	\
+{	\
+return	Datatype::copy(tid);	\
+}	\
+template<>	inline	Datatype	get_disktype<T>()	\
+{	\
+return	Datatype::copy(dtid);	\
+}
+
+
+HDF5_WRAPPER_SPECIALIZE_TYPE(int,	H5T_NATIVE_INT,	H5T_STD_I32LE)
+HDF5_WRAPPER_SPECIALIZE_TYPE(unsigned	int,	H5T_NATIVE_UINT,	H5T_STD_U32LE)
+HDF5_WRAPPER_SPECIALIZE_TYPE(unsigned	long	long,	H5T_NATIVE_ULLONG,	H5T_STD_U64LE)
+HDF5_WRAPPER_SPECIALIZE_TYPE(long	long,	H5T_NATIVE_LLONG,	H5T_STD_I64LE)
+HDF5_WRAPPER_SPECIALIZE_TYPE(char,	H5T_NATIVE_CHAR,	H5T_STD_I8LE)
+HDF5_WRAPPER_SPECIALIZE_TYPE(unsigned	char,	H5T_NATIVE_UCHAR,	H5T_STD_U8LE)
+HDF5_WRAPPER_SPECIALIZE_TYPE(float,	H5T_NATIVE_FLOAT,	H5T_IEEE_F32LE)
+HDF5_WRAPPER_SPECIALIZE_TYPE(double,	H5T_NATIVE_DOUBLE,	H5T_IEEE_F64LE)
+HDF5_WRAPPER_SPECIALIZE_TYPE(bool,	H5T_NATIVE_CHAR,	H5T_STD_U8LE)
+HDF5_WRAPPER_SPECIALIZE_TYPE(unsigned	long,	H5T_NATIVE_ULONG,	H5T_STD_U64LE)
+HDF5_WRAPPER_SPECIALIZE_TYPE(long,	H5T_NATIVE_LONG,	H5T_STD_I64LE)
+
+#ifdef	__FLT16_MAX__	//	the	compiler	has	_Float16
+template<>	inline	Datatype	get_memtype<_Float16>()
+{
+return	Datatype::createFloat16(H5Tget_order(H5T_NATIVE_FLOAT));
+}
+template<>	inline	Datatype	get_disktype<_Float16>()
+{
+return	Datatype::createFloat16();
+}
+#endif
+
+
+template<>	inline	Datatype	get_memtype<const	char	*>()
+{
+Datatype	dt	=	Datatype::copy(H5T_C_S1);
+dt.set_variable_size();
+return	dt;
+}
+template<>	inline	Datatype	get_disktype<const	char	*>()
+{
+return	get_memtype<const	char*>();
+}
+
+template<>	inline	Datatype	get_memtype<char*>()
+{
+return	get_memtype<const	char*>();
+}
+
+template<>	inline	Datatype	get_disktype<char	*>()
+{
+return	get_memtype<char*>();
+}
+
+}	//	namespace	internal
+
+
+
+
+template<class	T>
+struct	h5traits
+{
+static	inline	Datatype	get_memtype()
+{
+return	internal::get_memtype<T>();
+}
+
+static	inline	Datatype	get_disktype()
+{
+return	internal::get_disktype<T>();
+}
+
+template<class	RWT>
+static	inline	void	write(RWT	&rw,	const	Datatype	&memtype,	const	Dataspace	&memspace,	const	T	*values)
+{
+rw.write(values);
+}
+
+template<class	RWT>
+static	inline	void	read(RWT	&rw,	const	Datatype	&memtype,	const	Dataspace	&memspace,	T	*values)
+{
+rw.read(values);
+}
+};
+
+
+template<>
+struct	h5traits<std::string>
+{
+static	inline	Datatype	get_memtype()
+{
+return	internal::get_memtype<char*>();
+}
+
+static	inline	Datatype	get_disktype()
+{
+return	internal::get_disktype<char*>();
+}
+
+template<class	RWT>
+static	inline	void	write(RWT	&rw,	const	Datatype	&memtype,	const	Dataspace	&memspace,	const	std::string	*values)
+{
+hssize_t	n	=	memspace.get_npoints();
+assert(n	>=	1);
+std::vector<const	char*>	s(n);
+for	(int	i=0;	i<n;	++i)	s[i]	=	values[i].c_str();
+rw.write(&s[0]);
+}
+
+template<class	RWT>
+static	inline	void	read(RWT	&rw,	const	Datatype	&memtype,	const	Dataspace	&memspace,	std::string	*values)
+{
+hssize_t	n	=	memspace.get_npoints();
+assert(n	>=	1);
+assert(H5Tis_variable_str(memtype.get_id()));
+
+//	see	https://www.hdfgroup.org/HDF5/doc1.6/UG/11_Datatypes.html
+//	variable	data	sets.	string	types	(char*,	char[n],	std::string)	are	mapped	by	default	to	variable	length	data	types
+
+std::vector<char*>	buffers(n);
+rw.read(&buffers[0]);
+for	(hssize_t	i	=	0;	i	<	n;	++i)
+{
+values[i].assign(buffers[i]);
+}
+//	release	the	stuff	that	hdf5	allocated
+H5Dvlen_reclaim(memtype.get_id(),	memspace.get_id(),	H5P_DEFAULT,	&buffers[0]);
+}
+};
+
+
+template<size_t	n>
+struct	h5traits<char[n]>
+{
+typedef	char	CharArray[n];
+
+static	inline	Datatype	get_memtype()
+{
+return	internal::get_memtype<char*>();
+}
+
+static	inline	Datatype	get_disktype()
+{
+return	internal::get_disktype<char*>();
+}
+
+template<class	RWT>
+static	inline	void	write(RWT	&rw,	const	Datatype	&memtype,	const	Dataspace	&memspace,	const	CharArray	*values)
+{
+std::vector<const	char*>	s(memspace.get_npoints());
+for	(int	i=0;	i<s.size();	++i)	s[i]	=	values[i];	//	because	i	don't	know	how	to	deal	with	an
+rw.write(&s[0]);
+}
+};
+
+
+template<>
+struct	h5traits	<	char*	>
+{
+static	inline	Datatype	get_memtype()
+{
+return	internal::get_memtype<char*>();
+}
+
+static	inline	Datatype	get_disktype()
+{
+return	internal::get_disktype<char*>();
+}
+
+template<class	RWT>
+static	inline	void	write(RWT	&rw,	const	Datatype	&memtype,	const	Dataspace	&memspace,	const	char	*const	*values)
+{
+rw.write(values);
+}
+//	TODO:	enable	reading.	Needs	treatment	similar	to	std::string.	Don't	want	references	to	memory	allocated	by	HDF5	lib
+};
+
+
+/*
+std::array<T,	N>	maps	to	an	H5T_ARRAY	type	of	N	elements.	To	store	the
+elements	along	an	extra	trailing	dimension	instead,	use	create_dataset	with
+ARRAY_AS_DIMENSION.	read_dataset	handles	both	layouts.
+*/
+template<class	T,	size_t	N>
+struct	h5traits<std::array<T,	N>>
+{
+static_assert(std::is_trivially_copyable<T>::value	&&	sizeof(std::array<T,	N>)	==	N	*	sizeof(T),	"std::array	needs	plain,	unpadded	elements");
+
+static	inline	Datatype	get_memtype()
+{
+int	dims[1]	=	{	(int)N	};
+return	Datatype::createArray(h5cpp::get_memtype<T>(),	1,	dims);
+}
+
+static	inline	Datatype	get_disktype()
+{
+int	dims[1]	=	{	(int)N	};
+return	Datatype::createArray(h5cpp::get_disktype<T>(),	1,	dims);
+}
+
+template<class	RWT>
+static	inline	void	write(RWT	&rw,	const	Datatype	&memtype,	const	Dataspace	&memspace,	const	std::array<T,	N>	*values)
+{
+rw.write(values);
+}
+
+template<class	RWT>
+static	inline	void	read(RWT	&rw,	const	Datatype	&memtype,	const	Dataspace	&memspace,	std::array<T,	N>	*values)
+{
+rw.read(values);
+}
+};
+
+
+
+
+/*
+std::vector<T>	maps	to	a	variable	length	sequence	of	T,	so	a	dataset	of
+std::vector<T>	holds	rows	of	different	lengths.	See	also	RaggedArray,	which
+keeps	all	rows	in	one	contiguous	buffer.
+*/
+template<class	T>
+struct	h5traits<std::vector<T>>
+{
+static_assert(std::is_trivially_copyable<T>::value,	"variable	length	sequences	need	plain	elements");
+
+static	inline	Datatype	get_memtype()
+{
+return	Datatype::createVlen(h5cpp::get_memtype<T>());
+}
+
+static	inline	Datatype	get_disktype()
+{
+return	Datatype::createVlen(h5cpp::get_disktype<T>());
+}
+
+template<class	RWT>
+static	inline	void	write(RWT	&rw,	const	Datatype	&memtype,	const	Dataspace	&memspace,	const	std::vector<T>	*values)
+{
+hssize_t	n	=	memspace.get_select_npoints();
+std::vector<hvl_t>	s(n);
+for	(hssize_t	i=0;	i<n;	++i)
+{
+s[i].len	=	values[i].size();
+s[i].p	=	const_cast<T*>(values[i].data());
+}
+rw.write(s.data());
+}
+
+template<class	RWT>
+static	inline	void	read(RWT	&rw,	const	Datatype	&memtype,	const	Dataspace	&memspace,	std::vector<T>	*values)
+{
+hssize_t	n	=	memspace.get_select_npoints();
+std::vector<hvl_t>	s(n);
+rw.read(s.data());
+for	(hssize_t	i=0;	i<n;	++i)
+{
+const	T	*p	=	static_cast<const	T*>(s[i].p);
+values[i].assign(p,	p	+	s[i].len);
+}
+//	release	the	stuff	that	hdf5	allocated
+H5Dvlen_reclaim(memtype.get_id(),	memspace.get_id(),	H5P_DEFAULT,	s.data());
+}
+};
+//	std::complex<T>	maps	to	a	compound	type	with	members	"r"	and	"i",	like	h5py	and	others	use
+template<class	T>
+struct	h5traits<std::complex<T>>
+{
+static	inline	Datatype	get_memtype()
+{
+Datatype	dt	=	Datatype::createCompound(sizeof(std::complex<T>));
+dt.insert("r",	0,	h5cpp::get_memtype<T>());
+dt.insert("i",	sizeof(T),	h5cpp::get_memtype<T>());
+return	dt;
+}
+
+static	inline	Datatype	get_disktype()
+{
+Datatype	t	=	h5cpp::get_disktype<T>();
+size_t	s	=	t.get_size();
+Datatype	dt	=	Datatype::createCompound(2	*	s);
+dt.insert("r",	0,	t);
+dt.insert("i",	s,	t);
+return	dt;
+}
+
+template<class	RWT>
+static	inline	void	write(RWT	&rw,	const	Datatype	&memtype,	const	Dataspace	&memspace,	const	std::complex<T>	*values)
+{
+rw.write(values);
+}
+
+template<class	RWT>
+static	inline	void	read(RWT	&rw,	const	Datatype	&memtype,	const	Dataspace	&memspace,	std::complex<T>	*values)
+{
+rw.read(values);
+}
+};
+
+
+//	the	rest	of	the	api	uses	h5traits_of	to	get	rid	of	const	and	volatile	qualifiers
+template<class	T>
+struct	h5traits_of
+{
+typedef	typename	std::remove_cv<T>::type	stripped_type;
+typedef	h5traits<stripped_type>	type;	//	the	resulting	"clean"	traits	type
+};
+
+
+/*
+Here	is	this	super	ugly	code	which	caches	the	result	of	the	construction	of	HDF5
+types	in	static,	i.e.	global	variables.	The	mechanism	uses	hid_t	as	static
+variable	type,	because	using	Datatype	would	result	in	destructor	calls,
+and	concomitant	api	calls	when	the	hdf	lib	is	unloaded	already.
+*/
+namespace	internal
+{
+
+inline	hid_t	prep_type_cache(Datatype	dt)
+{
+dt.lock();
+dt.inc_ref();
+return	dt.get_id();
+}
+
+}
+
+//	wrap	complicated	things	in	neat	api	functions
+template<class	T>
+inline	Datatype	get_disktype()
+{
+static	hid_t	id	=	internal::prep_type_cache(h5traits_of<T>::type::get_disktype());
+return	Datatype(id,	internal::IncRC());
+}
+
+template<class	T>
+inline	Datatype	get_memtype()
+{
+static	hid_t	id	=	internal::prep_type_cache(h5traits_of<T>::type::get_memtype());
+return	Datatype(id,	internal::IncRC());
+}
+
+}	//	namespace	h5cpp
+
+
+
+namespace	h5cpp
+{
+
+/*==================================================
+*	some	free	functions
+*===================================================*/
+
+#if	0
+template<class	iterator>
+inline	Dataspace	create_dataspace_from_iter(iterator	begin,	iterator	end)
+{
+hsize_t	dims[H5S_MAX_RANK];
+int	i	=	0;
+for	(;	begin	!=	end;	++begin)
+{
+dims[i++]	=	*begin;
+
+if	(i	>=	H5S_MAX_RANK)
+throw	Exception("error	creating	dataspace:	provided	range	is	too	large");
+}
+return	Dataspace::simple(i,	dims);
+}
+
+template<class	T,	class	A>
+inline	Dataspace	create_dataspace_simple(const	std::vector<T,	A>	&dims)
+{
+assert(dims.size()	>	0);
+return	Dataspace::simple(dims.size(),	&dims[0]);
+}
+
+
+template<class	T,	class	A>
+inline	void	get_dims(const	Dataspace	&sp,	std::vector<T,	A>	&ret)
+{
+hsize_t	dims[H5S_MAX_RANK];
+int	r	=	sp.get_dims(dims);
+ret.resize(r);
+std::copy(dims,	dims	+	r,	ret.begin());
+}
+#endif
+/*--------------------------------------------------
+*	datasets
+*	------------------------------------------------	*/
+
+
+
+template<class	T>
+inline	Dataset	create_dataset(Group	group,	const	std::string	&name,	const	Dataspace	&sp,	const	T*	data	=	nullptr,	DsCreationFlags	flags	=
+{
+Datatype	dtype	=	internal::apply_disktype_flags(get_disktype<T>(),	flags);
+Dataset	ds	=	Dataset::create(group,	name,	dtype,	sp,	Dataset::create_creation_properties(sp,	flags,	dtype));
+if	(data	!=	nullptr)
+ds.write<T>(data);
+return	ds;
+}
+
+template<class	T>
+inline	Dataset	create_dataset_scalar(Group	group,	const	std::string	&name,	const	T&	data)
+{
+Dataspace	sp	=	Dataspace::scalar();
+Dataset	ds	=	Dataset::create(group,	name,	get_disktype<T>(),	sp,	Dataset::create_creation_properties(sp,	CREATE_DS_0));
+ds.write<T>(&data);
+return	ds;
+}
+
+
+template<class	T,	class	A>
+inline	Dataset	create_dataset(Group	group,	const	std::string	&name,	const	std::vector<T,	A>	&data,	DsCreationFlags	flags	=	CREATE_DS_DEFAULT)
+{
+return	create_dataset(group,	name,	Dataspace::simple_dims(data.size()),	&data[0],	flags);
+}
+
+
+template<class	T,	class	A>
+inline	void	read_dataset(const	Dataset	ds,	std::vector<T,	A>	&ret)
+{
+Dataspace	sp	=	ds.get_dataspace();
+ret.resize(sp.get_npoints());
+ds.read(&ret[0]);
+}
+
+template<class	T,	class	A>
+inline	void	read_dataset(const	Dataset	ds,	const	Selection	&sel,	std::vector<T,	A>	&ret)
+{
+Dataspace	file_space,	mem_space;
+sel.get_dataspaces(ds.get_dataspace(),	file_space,	mem_space);
+ret.resize(sel.size()	==	0	?	0	:	mem_space.get_npoints());
+ds.read(sel,	ret.data());
+}
+
+
+//	how	create_dataset	stores	std::array	elements
+enum	ArrayMapping
+{
+ARRAY_AS_TYPE,	//	H5T_ARRAY	element	type
+ARRAY_AS_DIMENSION	//	extra	trailing	dimension	of	size	N,	plain	element	type
+};
+
+template<class	T,	size_t	N,	class	A>
+inline	Dataset	create_dataset(Group	group,	const	std::string	&name,	const	std::vector<std::array<T,	N>,	A>	&data,	DsCreationFlags	flags	=	CREATE_DS_DEFAULT,	ArrayMapping	mapping	=	ARRAY_AS_TYPE)
+{
+hsize_t	dims[2]	=	{	data.size(),	N	};
+if	(mapping	==	ARRAY_AS_TYPE)
+return	create_dataset(group,	name,	Dataspace::simple(1,	dims),	data.empty()	?	nullptr	:	data.data(),	flags);	//	simple_dims	would	make	0	the	rank
+return	create_dataset(group,	name,	Dataspace::simple(2,	dims),	data.empty()	?	nullptr	:	data[0].data(),	flags);
+}
+
+//	reads	both	layouts	of	ArrayMapping
+template<class	T,	size_t	N,	class	A>
+inline	void	read_dataset(const	Dataset	ds,	std::vector<std::array<T,	N>,	A>	&ret)
+{
+Dataspace	sp	=	ds.get_dataspace();
+hssize_t	n	=	H5Sget_simple_extent_npoints(sp.get_id());	//	unlike	get_npoints,	allows	empty	extents
+if	(n	<	0)
+throw	Exception("unable	to	determine	number	of	elements	in	dataspace");
+if	(ds.get_datatype().get_class()	==	H5T_ARRAY)
+{
+ret.resize(n);
+if	(!ret.empty())
+ds.read(ret.data());
+return;
+}
+hsize_t	dims[H5S_MAX_RANK];
+int	r	=	sp.get_dims(dims);
+if	(r	<	1	||	dims[r-1]	!=	N)
+throw	Exception("last	dimension	of	dataset	does	not	match	size	of	std::array");
+ret.resize(n	/	N);
+if	(ret.empty())
+return;
+ds.read(ret[0].data());
+}
+
+
+/*--------------------------------------------------
+*	typed	dataset	handles
+*	------------------------------------------------	*/
+
+/*
+Dataset	handle	with	element	type	and	rank	fixed	at	compile	time.	It	caches	the
+memory	type,	the	extent	and	the	dataspaces,	so	repeated	reads	and	writes	of
+blocks	with	the	same	shape	only	change	the	hyperslab	selection	before	calling
+H5Dread/H5Dwrite.	The	cached	extent	is	not	updated	when	the	dataset	is
+resized	through	another	handle;	call	refresh()	then.
+*/
+template<class	T,	int	Rank>
+class	TypedDataset
+{
+static_assert(Rank	>=	1,	"TypedDataset	needs	a	rank	of	at	least	1");
+public:
+typedef	std::array<hsize_t,	Rank>	Index;
+
+private:
+typedef	typename	h5traits_of<T>::type	traits;
+Dataset	ds;
+Datatype	memtype;
+Index	extent;
+Dataspace	full_space;	//	whole	extent,	everything	selected
+Dataspace	file_space;	//	whole	extent,	selection	of	the	last	block
+Dataspace	mem_space;	//	shape	of	the	last	block
+Index	mem_count;
+
+void	init_spaces()
+{
+full_space	=	ds.get_dataspace();
+if	(full_space.get_rank()	!=	Rank)
+throw	Exception("dataset	rank	does	not	match	TypedDataset	rank");
+full_space.get_dims(extent.data());
+file_space	=	full_space.copy();
+mem_count	=	extent;
+mem_space	=	Dataspace::simple(Rank,	mem_count.data());
+}
+
+void	select(const	Index	&offset,	const	Index	&count)
+{
+if	(count	!=	mem_count)
+{
+if	(H5Sset_extent_simple(mem_space.get_id(),	Rank,	count.data(),	NULL)	<	0)
+throw	Exception("cannot	change	extent	of	memory	dataspace");
+mem_count	=	count;
+}
+file_space.select_hyperslab(offset.data(),	NULL,	count.data(),	NULL);
+}
+
+public:
+TypedDataset()	{}
+
+explicit	TypedDataset(const	Dataset	&ds_)	:	ds(ds_),	memtype(get_memtype<T>())
+{
+init_spaces();
+}
+
+static	TypedDataset	open(Group	group,	const	std::string	&name)
+{
+return	TypedDataset(group.open_dataset(name));
+}
+
+static	TypedDataset	create(Group	group,	const	std::string	&name,	const	Index	&dims,	DsCreationFlags	flags	=	CREATE_DS_DEFAULT)
+{
+return	TypedDataset(Dataset::create<T>(group,	name,	Dataspace::simple(Rank,	dims.data()),	flags));
+}
+
+const	Dataset&	dataset()	const	{	return	ds;	}
+const	Index&	dims()	const	{	return	extent;	}
+
+hsize_t	size()	const
+{
+hsize_t	n	=	1;
+for	(int	d=0;	d<Rank;	++d)
+n	*=	extent[d];
+return	n;
+}
+
+//	re-read	the	extent,	after	the	dataset	was	resized	through	another	handle
+void	refresh()
+{
+init_spaces();
+}
+
+void	set_extent(const	Index	&dims)
+{
+ds.set_extent(dims.data());
+init_spaces();
+}
+
+void	write(const	T	*data)
+{
+RWdataset	rw(ds.get_id(),	memtype.get_id(),	H5S_ALL,	H5S_ALL);
+traits::write(rw,	memtype,	full_space,	data);
+}
+
+void	read(T	*data)	const
+{
+RWdataset	rw(ds.get_id(),	memtype.get_id(),	H5S_ALL,	H5S_ALL);
+traits::read(rw,	memtype,	full_space,	data);
+}
+
+//	the	block	[offset,	offset+count),	stored	contiguously	in	data
+void	write(const	Index	&offset,	const	Index	&count,	const	T	*data)
+{
+select(offset,	count);
+RWdataset	rw(ds.get_id(),	memtype.get_id(),	mem_space.get_id(),	file_space.get_id());
+traits::write(rw,	memtype,	mem_space,	data);
+}
+
+void	read(const	Index	&offset,	const	Index	&count,	T	*data)
+{
+select(offset,	count);
+RWdataset	rw(ds.get_id(),	memtype.get_id(),	mem_space.get_id(),	file_space.get_id());
+traits::read(rw,	memtype,	mem_space,	data);
+}
+};
+
+
+/*--------------------------------------------------
+*	parallel	reading	of	filtered	chunks
+*	------------------------------------------------	*/
+
+namespace	internal
+{
+
+struct	ChunkFilter
+{
+H5Z_filter_t	id;
+std::vector<unsigned	int>	cd_values;
+};
+
+//	the	filter	pipeline,	in	the	order	in	which	the	filters	are	applied	when	writing
+inline	std::vector<ChunkFilter>	get_filters(hid_t	dcpl_id)
+{
+int	n	=	H5Pget_nfilters(dcpl_id);
+if	(n	<	0)
+throw	Exception("cannot	get	number	of	filters");
+std::vector<ChunkFilter>	filters(n);
+for	(int	i=0;	i<n;	++i)
+{
+const	size_t	MAX_CD_VALUES	=	16;
+unsigned	int	flags,	config,	cd_values[MAX_CD_VALUES];
+size_t	num_cd_values	=	MAX_CD_VALUES;
+H5Z_filter_t	f	=	H5Pget_filter2(dcpl_id,	i,	&flags,	&num_cd_values,	cd_values,	0,	NULL,	&config);
+if	(f	<	0)
+throw	Exception("cannot	get	filter");
+filters[i].id	=	f;
+filters[i].cd_values.assign(cd_values,	cd_values	+	std::min(num_cd_values,	MAX_CD_VALUES));
+}
+return	filters;
+}
+
+//	same	as	H5_checksum_fletcher32	in	the	HDF5	library
+inline	uint32_t	fletcher32(const	unsigned	char	*data,	size_t	len)
+{
+uint32_t	sum1	=	0,	sum2	=	0;
+size_t	words	=	len	/	2;
+while	(words)
+{
+size_t	n	=	words	>	360	?	360	:	words;
+words	-=	n;
+do
+{
+sum1	+=	(uint32_t)((data[0]	<<	8)	|	data[1]);
+data	+=	2;
+sum2	+=	sum1;
+}	while	(--n);
+sum1	=	(sum1	&	0xffff)	+	(sum1	>>	16);
+sum2	=	(sum2	&	0xffff)	+	(sum2	>>	16);
+}
+if	(len	%	2)
+{
+sum1	+=	(uint32_t)(data[0]	<<	8);
+sum2	+=	sum1;
+sum1	=	(sum1	&	0xffff)	+	(sum1	>>	16);
+sum2	=	(sum2	&	0xffff)	+	(sum2	>>	16);
+}
+sum1	=	(sum1	&	0xffff)	+	(sum1	>>	16);
+sum2	=	(sum2	&	0xffff)	+	(sum2	>>	16);
+return	(sum2	<<	16)	|	sum1;
+}
+
+//	true	if	all	filters	can	be	undone	by	decode_chunk
+inline	bool	can_decode(const	std::vector<ChunkFilter>	&filters)
+{
+for	(size_t	i=0;	i<filters.size();	++i)
+{
+switch	(filters[i].id)
+{
+case	H5Z_FILTER_SHUFFLE:
+case	H5Z_FILTER_FLETCHER32:
+case	HDF_WRAPPER_SHUFFLE_LZ_FILTER_ID:
+break;
+#ifdef	HDF_WRAPPER_HAS_ZLIB
+case	H5Z_FILTER_DEFLATE:
+break;
+#endif
+default:
+return	false;
+}
+}
+return	true;
+}
+
+/*
+Undo	the	filters	of	a	raw	chunk	in	place.	Bit	i	of	the	mask	is	set	if	filter
+i	was	skipped	for	this	chunk.	Runs	in	worker	threads,	so	it	must	not	call	into
+the	HDF5	library,	including	construction	of	Exception	objects.
+*/
+inline	void	decode_chunk(const	std::vector<ChunkFilter>	&filters,	unsigned	int	mask,	size_t	chunk_bytes,	std::vector<unsigned	char>	&buf,	std::vector<unsigned	char>	&tmp)
+{
+for	(int	i=(int)filters.size()-1;	i>=0;	--i)
+{
+if	(mask	&	(1u	<<	i))
+continue;
+const	ChunkFilter	&f	=	filters[i];
+if	(f.id	==	H5Z_FILTER_FLETCHER32)
+{
+if	(buf.size()	<	4)
+throw	std::runtime_error("chunk	too	small	for	checksum");
+size_t	n	=	buf.size()	-	4;
+uint32_t	stored	=	buf[n]	|	(buf[n+1]	<<	8)	|	(buf[n+2]	<<	16)	|	((uint32_t)buf[n+3]	<<	24);
+uint32_t	sum	=	fletcher32(&buf[0],	n);
+uint32_t	reversed	=	((sum	&	0x00ff00ff)	<<	8)	|	((sum	>>	8)	&	0x00ff00ff);	//	written	by	old	library	versions
+if	(stored	!=	sum	&&	stored	!=	reversed)
+throw	std::runtime_error("chunk	checksum	mismatch");
+buf.resize(n);
+}
+else	if	(f.id	==	H5Z_FILTER_SHUFFLE)
+{
+size_t	elem_size	=	f.cd_values.empty()	?	1	:	f.cd_values[0];
+tmp.resize(buf.size());
+unshuffle(buf.data(),	tmp.data(),	buf.size(),	elem_size);
+buf.swap(tmp);
+}
+else	if	(f.id	==	HDF_WRAPPER_SHUFFLE_LZ_FILTER_ID)
+{
+std::vector<unsigned	char>	out;
+if	(!shuffle_lz_decode(buf.data(),	buf.size(),	out,	tmp))
+throw	std::runtime_error("malformed	shuffle+lz	chunk");
+buf.swap(out);
+}
+#ifdef	HDF_WRAPPER_HAS_ZLIB
+else	if	(f.id	==	H5Z_FILTER_DEFLATE)
+{
+uLongf	n	=	chunk_bytes	+	64;
+for	(;;)
+{
+tmp.resize(n);
+int	r	=	uncompress(tmp.data(),	&n,	buf.data(),	buf.size());
+if	(r	==	Z_OK)
+break;
+if	(r	!=	Z_BUF_ERROR)
+throw	std::runtime_error("error	inflating	chunk");
+n	=	2	*	tmp.size();
+}
+tmp.resize(n);
+buf.swap(tmp);
+}
+#endif
+else
+throw	std::runtime_error("unsupported	filter");
+}
+if	(buf.size()	!=	chunk_bytes)
+throw	std::runtime_error("decoded	chunk	has	wrong	size");
+}
+
+//	copy	the	part	of	a	chunk	which	lies	inside	the	box	[offset,	offset+count)	into	the	buffer	of	the	box
+inline	void	scatter_chunk(int	rank,	const	hsize_t	*chunk_offset,	const	hsize_t	*chunk_dims,	const	hsize_t	*offset,	const	hsize_t	*count,	size_t	elem_size,	const	unsigned	char	*chunk,	unsigned	char	*dst)
+{
+hsize_t	lo[H5S_MAX_RANK],	hi[H5S_MAX_RANK],	idx[H5S_MAX_RANK];
+for	(int	d=0;	d<rank;	++d)
+{
+lo[d]	=	std::max(chunk_offset[d],	offset[d]);
+hi[d]	=	std::min(chunk_offset[d]	+	chunk_dims[d],	offset[d]	+	count[d]);
+if	(lo[d]	>=	hi[d])
+return;
+idx[d]	=	lo[d];
+}
+const	size_t	run	=	(hi[rank-1]	-	lo[rank-1])	*	elem_size;
+for	(;;)
+{
+hsize_t	src	=	0,	dst_pos	=	0;
+for	(int	d=0;	d<rank;	++d)
+{
+src	=	src	*	chunk_dims[d]	+	(idx[d]	-	chunk_offset[d]);
+dst_pos	=	dst_pos	*	count[d]	+	(idx[d]	-	offset[d]);
+}
+std::memcpy(dst	+	dst_pos	*	elem_size,	chunk	+	src	*	elem_size,	run);
+int	d	=	rank	-	2;
+for	(;	d>=0;	--d)
+{
+if	(++idx[d]	<	hi[d])
+break;
+idx[d]	=	lo[d];
+}
+if	(d	<	0)
+break;
+}
+}
+
+/*
+Reads	the	box	[offset,	offset+count)	of	a	chunked	dataset.	The	calling	thread
+fetches	raw	chunks	with	H5Dread_chunk,	since	the	library	must	only	be	used	by
+one	thread.	Worker	threads	undo	the	filters	and	copy	the	results	into	place.
+Returns	false,	without	reading	anything,	if	the	dataset	doesn't	qualify:	it	must
+be	chunked,	have	filters	which	decode_chunk	can	undo,	and	its	type	must	equal
+the	memory	type	so	no	conversion	is	needed.
+*/
+inline	bool	read_chunks_parallel(const	Dataset	&ds,	const	Datatype	&memtype,	const	hsize_t	*offset,	const	hsize_t	*count,	void	*data,	int	num_threads)
+{
+#if	H5_VERSION_GE(1,	10,	5)
+Object	dcpl(H5Dget_create_plist(ds.get_id()));
+if	(H5Pget_layout(dcpl.get_id())	!=	H5D_CHUNKED)
+return	false;
+std::vector<ChunkFilter>	filters	=	get_filters(dcpl.get_id());
+if	(filters.empty()	||	!can_decode(filters))
+return	false;
+if	(!ds.get_datatype().is_equal(memtype)	||	H5Tdetect_class(memtype.get_id(),	H5T_VLEN)	!=	0	||	H5Tis_variable_str(memtype.get_id())	!=	0)
+return	false;
+
+hsize_t	chunk_dims[H5S_MAX_RANK];
+const	int	rank	=	H5Pget_chunk(dcpl.get_id(),	H5S_MAX_RANK,	chunk_dims);
+if	(rank	!=	ds.get_dataspace().get_rank())
+throw	Exception("cannot	get	chunk	dimensions");
+const	size_t	elem_size	=	H5Tget_size(memtype.get_id());
+size_t	chunk_bytes	=	elem_size;
+hsize_t	first[H5S_MAX_RANK],	last[H5S_MAX_RANK],	idx[H5S_MAX_RANK];
+for	(int	d=0;	d<rank;	++d)
+{
+if	(count[d]	==	0)
+return	true;
+chunk_bytes	*=	chunk_dims[d];
+first[d]	=	offset[d]	/	chunk_dims[d];
+last[d]	=	(offset[d]	+	count[d]	-	1)	/	chunk_dims[d];
+idx[d]	=	first[d];
+}
+std::vector<unsigned	char>	fill_chunk;	//	for	chunks	which	were	never	written
+bool	no_fill	=	false;	//	fill	value	undefined	or	never	written;	then,	as	with	H5Dread,	their	part	of	dst	is	left	untouched
+unsigned	char	*dst	=	static_cast<unsigned	char*>(data);
+
+if	(num_threads	<=	0)
+num_threads	=	std::max(1u,	std::thread::hardware_concurrency());
+
+struct	Job
+{
+hsize_t	chunk_offset[H5S_MAX_RANK];
+uint32_t	mask;
+std::vector<unsigned	char>	raw;
+};
+std::vector<Job>	queue;
+std::mutex	mutex;
+std::condition_variable	cv_work,	cv_space;
+bool	finished	=	false;
+std::string	error;
+const	size_t	max_queued	=	2	*	num_threads;	//	bounds	the	memory	used	for	raw	chunks
+
+auto	work	=	[&]()
+{
+std::vector<unsigned	char>	tmp;
+for	(;;)
+{
+Job	job;
+{
+std::unique_lock<std::mutex>	lock(mutex);
+cv_work.wait(lock,	[&]()	{	return	!queue.empty()	||	finished;	});
+if	(queue.empty())
+return;
+std::swap(job,	queue.back());
+queue.pop_back();
+}
+cv_space.notify_one();
+try
+{
+decode_chunk(filters,	job.mask,	chunk_bytes,	job.raw,	tmp);
+scatter_chunk(rank,	job.chunk_offset,	chunk_dims,	offset,	count,	elem_size,	job.raw.data(),	dst);
+}
+catch	(const	std::exception	&e)
+{
+std::lock_guard<std::mutex>	lock(mutex);
+if	(error.empty())
+error	=	e.what();
+}
+}
+};
+
+std::vector<std::thread>	workers;
+try
+{
+for	(int	i=0;	i<num_threads;	++i)
+workers.push_back(std::thread(work));
+for	(;;)
+{
+Job	job;
+for	(int	d=0;	d<rank;	++d)
+job.chunk_offset[d]	=	idx[d]	*	chunk_dims[d];
+unsigned	int	mask	=	0;
+haddr_t	addr	=	HADDR_UNDEF;
+hsize_t	nbytes	=	0;
+if	(H5Dget_chunk_info_by_coord(ds.get_id(),	job.chunk_offset,	&mask,	&addr,	&nbytes)	<	0)
+throw	Exception("cannot	get	chunk	info");
+if	(addr	==	HADDR_UNDEF)
+{
+if	(fill_chunk.empty()	&&	!no_fill)
+{
+H5D_fill_value_t	status;
+H5D_fill_time_t	fill_time;
+if	(H5Pfill_value_defined(dcpl.get_id(),	&status)	<	0	||	H5Pget_fill_time(dcpl.get_id(),	&fill_time)	<	0)
+throw	Exception("cannot	get	fill	value");
+no_fill	=	status	==	H5D_FILL_VALUE_UNDEFINED	||	fill_time	==	H5D_FILL_TIME_NEVER;
+if	(!no_fill)
+{
+fill_chunk.resize(chunk_bytes);
+if	(H5Pget_fill_value(dcpl.get_id(),	memtype.get_id(),	&fill_chunk[0])	<	0)
+throw	Exception("cannot	get	fill	value");
+for	(size_t	i=elem_size;	i<chunk_bytes;	i+=elem_size)
+std::memcpy(&fill_chunk[i],	&fill_chunk[0],	elem_size);
+}
+}
+if	(!no_fill)
+scatter_chunk(rank,	job.chunk_offset,	chunk_dims,	offset,	count,	elem_size,	fill_chunk.data(),	dst);
+}
+else
+{
+job.raw.resize(nbytes);
+if	(H5Dread_chunk(ds.get_id(),	H5P_DEFAULT,	job.chunk_offset,	&job.mask,	job.raw.data())	<	0)
+throw	Exception("error	reading	raw	chunk");
+std::unique_lock<std::mutex>	lock(mutex);
+cv_space.wait(lock,	[&]()	{	return	queue.size()	<	max_queued	||	!error.empty();	});
+if	(!error.empty())
+break;
+queue.push_back(std::move(job));
+lock.unlock();
+cv_work.notify_one();
+}
+//	next	chunk	in	row	major	order
+int	d	=	rank	-	1;
+for	(;	d>=0;	--d)
+{
+if	(++idx[d]	<=	last[d])
+break;
+idx[d]	=	first[d];
+}
+if	(d	<	0)
+break;
+}
+}
+catch	(...)
+{
+{
+std::lock_guard<std::mutex>	lock(mutex);
+finished	=	true;
+queue.clear();
+}
+cv_work.notify_all();
+for	(size_t	i=0;	i<workers.size();	++i)
+workers[i].join();
+throw;
+}
+{
+std::lock_guard<std::mutex>	lock(mutex);
+finished	=	true;
+}
+cv_work.notify_all();
+for	(size_t	i=0;	i<workers.size();	++i)
+workers[i].join();
+if	(!error.empty())
+throw	Exception("error	decoding	chunk	of	dataset:	"	+	error);
+return	true;
+#else
+return	false;
+#endif
+}
+
+}	//	namespace	internal
+
+
+/*
+Read	the	box	[offset,	offset+count)	of	a	dataset	into	a	contiguous	buffer.	For	chunked
+datasets	with	deflate	(needs	HDF_WRAPPER_HAS_ZLIB),	shuffle	and	fletcher32	filters,
+chunks	are	decompressed	concurrently	by	num_threads	threads	(0	=	one	per	core).
+Everything	else	is	read	normally.	The	result	is	the	same	either	way.
+*/
+template<class	T>
+inline	void	read_chunks_parallel(const	Dataset	&ds,	const	hsize_t	*offset,	const	hsize_t	*count,	T	*data,	int	num_threads	=	0)
+{
+Dataspace	file_space	=	ds.get_dataspace();
+if	(file_space.get_rank()	==	0)
+{
+ds.read(data);
+return;
+}
+Datatype	memtype	=	get_memtype<T>();
+bool	plain	=	std::is_trivially_copyable<T>::value	&&	!std::is_array<T>::value;
+if	(plain	&&	internal::read_chunks_parallel(ds,	memtype,	offset,	count,	data,	num_threads))
+return;
+file_space.select_hyperslab(offset,	NULL,	count,	NULL);
+ds.read(Dataspace::simple(file_space.get_rank(),	count),	file_space,	data);
+}
+
+template<class	T,	class	A>
+inline	void	read_dataset_parallel(const	Dataset	ds,	std::vector<T,	A>	&ret,	int	num_threads	=	0)
+{
+Dataspace	sp	=	ds.get_dataspace();
+hsize_t	offset[H5S_MAX_RANK]	=	{	0	},	dims[H5S_MAX_RANK];
+sp.get_dims(dims);
+ret.resize(sp.get_npoints());
+read_chunks_parallel(ds,	offset,	dims,	ret.data(),	num_threads);
+}
+
+/*--------------------------------------------------
+*	lossy	storage	of	floating	point	data
+*	------------------------------------------------	*/
+
+/*
+Precision	to	which	float	or	double	data	is	reduced	before	it	is	written.
+The	discarded	mantissa	bits	become	runs	of	zeros	(or,	with	grooming,
+alternating	zeros	and	ones),	which	shuffle	+	deflate	compress	much	better
+than	noise.	The	precision	is	recorded	in	attributes	of	the	dataset.
+*/
+struct	FloatPrecision
+{
+enum	Mode
+{
+BIT_ROUND,	//	round	to	the	nearest	value	with	significant_bits	mantissa	bits
+BIT_GROOM,	//	alternately	shave	and	set	the	discarded	bits,	which	is	unbiased	on	average
+ABS_ERROR	//	keep	as	many	bits	as	needed	for	an	absolute	error	of	at	most	abs_error
+};
+Mode	mode;
+int	significant_bits;
+double	abs_error;
+
+FloatPrecision(Mode	mode_	=	BIT_ROUND,	int	significant_bits_	=	0,	double	abs_error_	=	0.)	:	mode(mode_),	significant_bits(significant_bits_),	abs_error(abs_error_)	{}
+
+//	e.g.	bits(12)	for	about	3.6	significant	decimal	digits
+static	FloatPrecision	bits(int	n)	{	return	FloatPrecision(BIT_ROUND,	n);	}
+static	FloatPrecision	groomed_bits(int	n)	{	return	FloatPrecision(BIT_GROOM,	n);	}
+static	FloatPrecision	absolute(double	err)	{	return	FloatPrecision(ABS_ERROR,	0,	err);	}
+
+//	bound	of	|x	-	stored|	/	|x|,	for	the	bit	based	modes
+double	max_relative_error()	const
+{
+return	std::ldexp(1.,	mode	==	BIT_GROOM	?	-significant_bits	:	-significant_bits-1);
+}
+
+void	write_attributes(Attributes	attrs)	const
+{
+if	(mode	==	ABS_ERROR)
+{
+attrs.set<std::string>("lossy_mode",	"abs_error");
+attrs.set("lossy_abs_error",	abs_error);
+}
+else
+{
+attrs.set<std::string>("lossy_mode",	mode	==	BIT_ROUND	?	"bit_round"	:	"bit_groom");
+attrs.set("lossy_significant_bits",	significant_bits);
+attrs.set("lossy_max_rel_error",	max_relative_error());
+}
+}
+
+//	throws	NameLookupError	if	the	data	was	not	stored	lossy
+static	FloatPrecision	read_attributes(Attributes	attrs)
+{
+std::string	m	=	attrs.get<std::string>("lossy_mode");
+if	(m	==	"abs_error")
+return	absolute(attrs.get<double>("lossy_abs_error"));
+FloatPrecision	p(m	==	"bit_groom"	?	BIT_GROOM	:	BIT_ROUND,	attrs.get<int>("lossy_significant_bits"));
+return	p;
+}
+};
+
+
+namespace	internal
+{
+
+template<class	T>
+struct	float_bits;
+
+template<>
+struct	float_bits<float>
+{
+typedef	uint32_t	uint_type;
+enum	{	MANTISSA	=	23,	EXPONENT_BIAS	=	127	};
+};
+
+template<>
+struct	float_bits<double>
+{
+typedef	uint64_t	uint_type;
+enum	{	MANTISSA	=	52,	EXPONENT_BIAS	=	1023	};
+};
+
+//	in	place;	infinities	and	NaNs	are	left	alone
+template<class	T>
+inline	void	quantize(T	*data,	size_t	n,	const	FloatPrecision	&p)
+{
+typedef	typename	float_bits<T>::uint_type	U;
+const	int	M	=	float_bits<T>::MANTISSA;
+const	U	exp_mask	=	((U(1)	<<	(sizeof(U)	*	8	-	1	-	M))	-	1)	<<	M;
+const	double	log2_err	=	p.mode	==	FloatPrecision::ABS_ERROR	?	std::log2(p.abs_error)	:	0.;
+if	(p.mode	==	FloatPrecision::ABS_ERROR	&&	!(p.abs_error	>	0.))
+throw	Exception("absolute	error	bound	must	be	positive");
+int	keep	=	std::max(0,	std::min(M,	p.significant_bits));
+for	(size_t	i=0;	i<n;	++i)
+{
+U	bits;
+std::memcpy(&bits,	data	+	i,	sizeof(U));
+U	e	=	bits	&	exp_mask;
+if	(e	==	exp_mask)
+continue;
+if	(p.mode	==	FloatPrecision::ABS_ERROR)
+{
+//	rounding	error	is	at	most	2^(exponent	-	keep	-	1)
+int	exponent	=	(int)(e	>>	M)	-	float_bits<T>::EXPONENT_BIAS;
+keep	=	std::max(0,	std::min(M,	(int)std::ceil(exponent	-	1	-	log2_err)));
+}
+const	int	drop	=	M	-	keep;
+if	(drop	<=	0)
+continue;
+const	U	mask	=	(U(1)	<<	drop)	-	1;
+if	(p.mode	==	FloatPrecision::BIT_GROOM)
+{
+if	((bits	&	~(U(1)	<<	(sizeof(U)	*	8	-	1)))	==	0)
+continue;	//	keep	zeros
+if	(i	&	1)
+bits	|=	mask;
+else
+bits	&=	~mask;
+}
+else
+{
+U	rounded	=	(bits	+	(mask	>>	1)	+	((bits	>>	drop)	&	1))	&	~mask;	//	round	half	to	even
+bits	=	(rounded	&	exp_mask)	==	exp_mask	?	bits	&	~mask	:	rounded;	//	don't	round	up	to	infinity
+}
+std::memcpy(data	+	i,	&bits,	sizeof(U));
+}
+}
+
+}	//	namespace	internal
+
+
+/*
+Writes	data	reduced	to	the	given	precision	and	records	the	precision	in	attributes
+of	the	dataset.	data	itself	is	not	modified;	it	is	processed	in	blocks	along	the
+first	dimension	to	limit	the	memory	used	for	the	copies.
+*/
+template<class	T>
+inline	void	write_quantized(Dataset	ds,	const	T	*data,	const	FloatPrecision	&precision)
+{
+static_assert(std::is_same<T,	float>::value	||	std::is_same<T,	double>::value,	"only	float	and	double	can	be	quantized");
+Dataspace	sp	=	ds.get_dataspace();
+hsize_t	dims[H5S_MAX_RANK];
+int	rank	=	sp.get_dims(dims);
+std::vector<T>	buf;
+if	(rank	==	0)
+{
+buf.assign(data,	data	+	1);
+internal::quantize(buf.data(),	1,	precision);
+ds.write(buf.data());
+}
+else
+{
+hsize_t	row	=	1;
+for	(int	i=1;	i<rank;	++i)	row	*=	dims[i];
+const	hsize_t	rows_per_block	=	std::max<hsize_t>(1,	(1	<<	20)	/	std::max<hsize_t>(row,	1));
+hsize_t	offset[H5S_MAX_RANK]	=	{	0	},	count[H5S_MAX_RANK];
+std::copy(dims,	dims	+	rank,	count);
+for	(hsize_t	r=0;	r<dims[0];	r+=rows_per_block)
+{
+offset[0]	=	r;
+count[0]	=	std::min(rows_per_block,	dims[0]	-	r);
+buf.assign(data	+	r	*	row,	data	+	(r	+	count[0])	*	row);
+internal::quantize(buf.data(),	buf.size(),	precision);
+Dataspace	file_space	=	sp.copy();
+file_space.select_hyperslab(offset,	NULL,	count,	NULL);
+ds.write(Dataspace::simple(rank,	count),	file_space,	buf.data());
+}
+}
+precision.write_attributes(ds.attrs());
+}
+
+template<class	T>
+inline	Dataset	create_dataset_quantized(Group	group,	const	std::string	&name,	const	Dataspace	&sp,	const	T*	data,	const	FloatPrecision	&precision,	DsCreationFlags	flags	=	DsCreationFlags(CREATE_DS_DEFAULT	|	CREATE_DS_SHUFFLE))
+{
+Dataset	ds	=	create_dataset<T>(group,	name,	sp,	nullptr,	flags);
+if	(data	!=	nullptr)
+write_quantized(ds,	data,	precision);
+else
+precision.write_attributes(ds.attrs());
+return	ds;
+}
+
+template<class	T,	class	A>
+inline	Dataset	create_dataset_quantized(Group	group,	const	std::string	&name,	const	std::vector<T,	A>	&data,	const	FloatPrecision	&precision,	DsCreationFlags	flags	=	DsCreationFlags(CREATE_DS_DEFAULT	|	CREATE_DS_SHUFFLE))
+{
+return	create_dataset_quantized(group,	name,	Dataspace::simple_dims(data.size()),	data.data(),	precision,	flags);
+}
+
+
+/*--------------------------------------------------
+*	ragged	arrays
+*	------------------------------------------------	*/
+
+/*
+Append	rows	along	the	first	dimension	of	a	dataset	with	unlimited	maximum	size
+in	that	dimension.	data	holds	rows	times	the	trailing	dimensions.
+*/
+template<class	T>
+inline	void	append_dataset(Dataset	ds,	const	T	*data,	hsize_t	rows)
+{
+Dataspace	sp	=	ds.get_dataspace();
+hsize_t	dims[H5S_MAX_RANK],	offset[H5S_MAX_RANK]	=	{	0	};
+int	rank	=	sp.get_dims(dims);
+if	(rank	<	1)
+throw	Exception("cannot	append	to	scalar	dataset");
+if	(rows	==	0)
+return;
+offset[0]	=	dims[0];
+dims[0]	+=	rows;
+ds.set_extent(dims);
+dims[0]	=	rows;
+Dataspace	file_space	=	ds.get_dataspace();
+file_space.select_hyperslab(offset,	NULL,	dims,	NULL);
+ds.write(Dataspace::simple(rank,	dims),	file_space,	data);
+}
+
+
+/*
+When	a	WriteBehindBuffer	writes	its	staged	rows	to	the	dataset.	Staged	data	is
+written	once	it	exceeds	max_bytes,	or	on	the	first	write	after	it	was	held
+for	longer	than	max_age_seconds	(0	=	no	time	limit);	there	is	no	background
+thread.	With	align_to_chunks,	size	triggered	writes	end	at	chunk	boundaries
+and	the	partial	chunk	stays	staged.	cork_metadata	keeps	the	dataset's	metadata
+in	the	cache	between	checkpoints,	see	Object::cork.
+*/
+struct	WriteBehindPolicy
+{
+size_t	max_bytes;
+double	max_age_seconds;
+bool	align_to_chunks;
+bool	cork_metadata;
+WriteBehindPolicy()	:	max_bytes(4	<<	20),	max_age_seconds(0.),	align_to_chunks(true),	cork_metadata(false)	{}
+};
+
+
+/*
+Stages	writes	of	rows	along	the	first	dimension	of	a	dataset	in	memory	and
+merges	adjacent	and	overlapping	ones,	so	that	many	small	writes	become	few
+large	ones.	Rows	beyond	the	current	extent	grow	the	dataset	on	flush,	which
+then	needs	an	unlimited	maximum	size	in	the	first	dimension.
+Data	is	durable	only	after	checkpoint().	The	destructor	flushes,	but	swallows
+errors;	call	flush()	or	checkpoint()	to	see	them.
+*/
+template<class	T>
+class	WriteBehindBuffer
+{
+typedef	std::chrono::steady_clock	Clock;
+Dataset	ds;
+WriteBehindPolicy	policy;
+int	rank;
+hsize_t	dims[H5S_MAX_RANK];	//	current	extent	of	the	dataset
+size_t	row_size;	//	elements	per	row
+hsize_t	chunk_rows;	//	0	if	not	chunked
+std::map<hsize_t,	std::vector<T>	>	runs;	//	first	row	->	data,	disjoint	and	not	adjacent
+size_t	staged;	//	elements
+Clock::time_point	oldest;
+bool	corked;
+
+hsize_t	run_end(typename	std::map<hsize_t,	std::vector<T>	>::const_iterator	it)	const
+{
+return	it->first	+	it->second.size()	/	row_size;
+}
+
+//	write	rows	[first,	last)	of	the	run	at	it,	keep	the	rest	staged
+void	write_run(typename	std::map<hsize_t,	std::vector<T>	>::iterator	it,	hsize_t	last)
+{
+hsize_t	first	=	it->first,	end	=	run_end(it);
+hsize_t	offset[H5S_MAX_RANK]	=	{	0	},	count[H5S_MAX_RANK];
+std::copy(dims,	dims	+	rank,	count);
+offset[0]	=	first;
+count[0]	=	last	-	first;
+Dataspace	file_space	=	ds.get_dataspace();
+file_space.select_hyperslab(offset,	NULL,	count,	NULL);
+ds.write(Dataspace::simple(rank,	count),	file_space,	it->second.data());
+staged	-=	count[0]	*	row_size;
+if	(last	<	end)
+{
+std::vector<T>	rest(it->second.begin()	+	count[0]	*	row_size,	it->second.end());
+runs.erase(it);
+runs[last].swap(rest);
+}
+else
+runs.erase(it);
+}
+
+void	write_staged(bool	aligned)
+{
+if	(runs.empty())
+return;
+hsize_t	end	=	run_end(std::prev(runs.end()));
+if	(aligned	&&	chunk_rows	>	0)
+end	-=	end	%	chunk_rows;
+if	(end	>	dims[0])
+{
+hsize_t	new_dims[H5S_MAX_RANK];
+std::copy(dims,	dims	+	rank,	new_dims);
+new_dims[0]	=	end;
+ds.set_extent(new_dims);
+dims[0]	=	end;
+}
+for	(typename	std::map<hsize_t,	std::vector<T>	>::iterator	it	=	runs.begin();	it	!=	runs.end();)
+{
+typename	std::map<hsize_t,	std::vector<T>	>::iterator	next	=	std::next(it);
+hsize_t	last	=	run_end(it);
+if	(aligned	&&	chunk_rows	>	0)
+last	-=	last	%	chunk_rows;
+if	(last	>	it->first)
+write_run(it,	last);
+it	=	next;
+}
+oldest	=	Clock::now();
+}
+
+void	maybe_write()
+{
+if	(staged	*	sizeof(T)	>=	policy.max_bytes)
+write_staged(policy.align_to_chunks);
+else	if	(policy.max_age_seconds	>	0	&&	std::chrono::duration<double>(Clock::now()	-	oldest).count()	>=	policy.max_age_seconds)
+write_staged(false);
+}
+
+public:
+WriteBehindBuffer(Dataset	ds_,	const	WriteBehindPolicy	&policy_	=	WriteBehindPolicy())
+:	ds(ds_),	policy(policy_),	row_size(1),	chunk_rows(0),	staged(0),	corked(false)
+{
+rank	=	ds.get_dataspace().get_dims(dims);
+if	(rank	<	1)
+throw	Exception("write	behind	buffering	needs	a	dataset	of	rank	>=	1");
+for	(int	i	=	1;	i	<	rank;	++i)
+row_size	*=	dims[i];
+Object	dcpl(H5Dget_create_plist(ds.get_id()));
+hsize_t	chunk_dims[H5S_MAX_RANK];
+if	(H5Pget_layout(dcpl.get_id())	==	H5D_CHUNKED	&&	H5Pget_chunk(dcpl.get_id(),	H5S_MAX_RANK,	chunk_dims)	>	0)
+chunk_rows	=	chunk_dims[0];
+#if	H5_VERSION_GE(1,	10,	0)
+if	(policy.cork_metadata)
+{
+ds.cork();
+corked	=	true;
+}
+#endif
+}
+
+~WriteBehindBuffer()
+{
+try
+{
+flush();
+#if	H5_VERSION_GE(1,	10,	0)
+if	(corked)
+ds.uncork();
+#endif
+}
+catch	(...)	{}
+}
+
+WriteBehindBuffer(const	WriteBehindBuffer&)	=	delete;
+WriteBehindBuffer&	operator=(const	WriteBehindBuffer&)	=	delete;
+
+//	stage	rows	times	the	trailing	dimensions	of	the	dataset,	starting	at	first_row
+void	write_rows(hsize_t	first_row,	const	T	*data,	hsize_t	rows)
+{
+if	(rows	==	0)
+return;
+if	(runs.empty())
+oldest	=	Clock::now();
+hsize_t	first	=	first_row,	last	=	first_row	+	rows;
+//	runs	that	overlap	or	touch	[first,	last)	are	merged	into	one
+typename	std::map<hsize_t,	std::vector<T>	>::iterator	begin	=	runs.upper_bound(first),	end	=	runs.upper_bound(last);
+if	(begin	!=	runs.begin()	&&	run_end(std::prev(begin))	>=	first)
+--begin;
+if	(begin	!=	end)
+{
+first	=	std::min(first,	begin->first);
+last	=	std::max(last,	run_end(std::prev(end)));
+}
+//	extend	the	run	the	rows	start	in	where	possible,	so	appending	row	by	row	is	linear
+typename	std::map<hsize_t,	std::vector<T>	>::iterator	rest	=	begin;
+std::vector<T>	merged;
+if	(begin	!=	end	&&	begin->first	==	first)
+{
+merged.swap(begin->second);
+staged	-=	merged.size();
+++rest;
+}
+merged.resize((last	-	first)	*	row_size);
+for	(typename	std::map<hsize_t,	std::vector<T>	>::iterator	it	=	rest;	it	!=	end;	++it)
+{
+std::copy(it->second.begin(),	it->second.end(),	merged.begin()	+	(it->first	-	first)	*	row_size);
+staged	-=	it->second.size();
+}
+runs.erase(rest,	end);
+std::copy(data,	data	+	rows	*	row_size,	merged.begin()	+	(first_row	-	first)	*	row_size);
+staged	+=	merged.size();
+runs[first].swap(merged);
+maybe_write();
+}
+
+//	stage	rows	after	the	last	row	of	the	dataset	or	of	the	staged	data,	whatever	is	further
+void	append(const	T	*data,	hsize_t	rows)
+{
+hsize_t	end	=	dims[0];
+if	(!runs.empty())
+end	=	std::max(end,	run_end(std::prev(runs.end())));
+write_rows(end,	data,	rows);
+}
+
+//	rows	of	the	dataset	including	staged	rows	beyond	its	current	extent
+hsize_t	rows()	const
+{
+return	runs.empty()	?	dims[0]	:	std::max(dims[0],	run_end(std::prev(runs.end())));
+}
+
+size_t	staged_bytes()	const
+{
+return	staged	*	sizeof(T);
+}
+
+//	write	all	staged	data	to	the	library;	it	may	still	be	in	HDF5's	caches
+void	flush()
+{
+write_staged(false);
+}
+
+/*
+Write	all	staged	data	and	sync	the	file,	so	the	data	is	on	disk	when	this
+returns	(for	the	drivers	File::sync	supports).	Corked	metadata	is	written	too.
+*/
+void	checkpoint()
+{
+write_staged(false);
+#if	H5_VERSION_GE(1,	10,	0)
+if	(corked)
+ds.uncork();
+#endif
+herr_t	err	=	H5Fflush(ds.get_id(),	H5F_SCOPE_LOCAL);
+#if	H5_VERSION_GE(1,	10,	0)
+if	(corked)
+ds.cork();
+#endif
+if	(err	<	0)
+throw	Exception("unable	to	flush	file");
+internal::sync_to_disk(ds.get_file().get_id());
+}
+};
+
+
+/*
+Rows	of	different	lengths	in	one	contiguous	buffer.	Row	i	is
+values[offsets[i]]	...	values[offsets[i+1]-1].
+*/
+template<class	T>
+struct	RaggedArray
+{
+std::vector<T>	values;
+std::vector<hsize_t>	offsets;
+
+RaggedArray()	:	offsets(1,	0)	{}
+
+size_t	size()	const	{	return	offsets.size()	-	1;	}
+size_t	row_size(size_t	i)	const	{	return	offsets[i+1]	-	offsets[i];	}
+const	T*	row(size_t	i)	const	{	return	values.data()	+	offsets[i];	}
+T*	row(size_t	i)	{	return	values.data()	+	offsets[i];	}
+
+void	push_back(const	T	*row,	size_t	n)
+{
+values.insert(values.end(),	row,	row	+	n);
+offsets.push_back(values.size());
+}
+
+void	clear()
+{
+values.clear();
+offsets.assign(1,	0);
+}
+};
+
+
+namespace	internal
+{
+
+/*
+Allocator	for	the	variable	length	data	read	by	the	library.	Allocations
+are	served	from	one	buffer	that	is	sized	beforehand	with	H5Dvlen_get_buf_size.
+*/
+struct	VlenArena
+{
+char	*base;
+size_t	size,	used;
+};
+
+inline	void*	vlen_arena_alloc(size_t	n,	void	*info)
+{
+VlenArena	*a	=	static_cast<VlenArena*>(info);
+if	(a->used	+	n	>	a->size)
+return	NULL;
+void	*p	=	a->base	+	a->used;
+a->used	+=	n;
+return	p;
+}
+
+inline	void	vlen_arena_free(void*,	void*)
+{
+}
+
+//	read	the	selected	rows	of	a	variable	length	dataset	into	ret
+template<class	T>
+inline	void	read_ragged(const	Dataset	&ds,	const	Dataspace	&mem_space,	hid_t	file_space_id,	RaggedArray<T>	&ret)
+{
+Datatype	memtype	=	h5cpp::get_memtype<std::vector<T>>();
+hid_t	selected_space_id	=	file_space_id	==	H5S_ALL	?	mem_space.get_id()	:	file_space_id;	//	for	H5S_ALL	mem_space	is	the	dataset's	space
+hsize_t	nbytes	=	0;
+if	(H5Dvlen_get_buf_size(ds.get_id(),	memtype.get_id(),	selected_space_id,	&nbytes)	<	0)
+throw	Exception("cannot	determine	size	of	variable	length	data");
+hssize_t	n	=	mem_space.get_select_npoints();
+std::vector<hvl_t>	seqs(n);
+std::vector<T>	values(nbytes	/	sizeof(T));
+VlenArena	arena	=	{	reinterpret_cast<char*>(values.data()),	values.size()	*	sizeof(T),	0	};
+Properties	xfer(H5P_DATASET_XFER);
+if	(H5Pset_vlen_mem_manager(xfer.get_id(),	vlen_arena_alloc,	&arena,	vlen_arena_free,	NULL)	<	0)
+throw	Exception("cannot	set	memory	manager	for	variable	length	data");
+RWdataset	rw(ds.get_id(),	memtype.get_id(),	mem_space.get_id(),	file_space_id,	xfer.get_id());
+rw.read(seqs.data());
+
+ret.offsets.resize(n	+	1);
+ret.offsets[0]	=	0;
+bool	in_order	=	true;
+for	(hssize_t	i=0;	i<n;	++i)
+{
+ret.offsets[i+1]	=	ret.offsets[i]	+	seqs[i].len;
+if	(seqs[i].len	>	0	&&	seqs[i].p	!=	values.data()	+	ret.offsets[i])
+in_order	=	false;
+}
+if	(in_order)
+{
+values.resize(ret.offsets[n]);
+ret.values.swap(values);
+}
+else
+{
+ret.values.resize(ret.offsets[n]);
+for	(hssize_t	i=0;	i<n;	++i)
+std::copy(static_cast<const	T*>(seqs[i].p),	static_cast<const	T*>(seqs[i].p)	+	seqs[i].len,	ret.values.begin()	+	ret.offsets[i]);
+}
+}
+
+}	//	namespace	internal
+
+
+//	stores	the	rows	as	variable	length	sequences;	without	rows	the	dataset	is	empty	and	extendible
+template<class	T>
+inline	Dataset	create_dataset(Group	group,	const	std::string	&name,	const	RaggedArray<T>	&data,	DsCreationFlags	flags	=	CREATE_DS_DEFAULT)
+{
+Datatype	dtype	=	Datatype::createVlen(internal::apply_disktype_flags(get_disktype<T>(),	flags));
+hsize_t	n	=	data.size(),	unlimited	=	H5S_UNLIMITED;
+if	(n	==	0)
+{
+Dataspace	sp	=	Dataspace::simple(1,	&n,	&unlimited);
+return	Dataset::create(group,	name,	dtype,	sp,	Dataset::create_creation_properties(sp,	DsCreationFlags(flags	|	CREATE_DS_CHUNKED),	dtype));
+}
+Dataspace	sp	=	Dataspace::simple(1,	&n);
+Dataset	ds	=	Dataset::create(group,	name,	dtype,	sp,	Dataset::create_creation_properties(sp,	flags));
+std::vector<hvl_t>	seqs(data.size());
+for	(size_t	i=0;	i<seqs.size();	++i)
+{
+seqs[i].len	=	data.row_size(i);
+seqs[i].p	=	const_cast<T*>(data.row(i));
+}
+Datatype	memtype	=	get_memtype<std::vector<T>>();
+RWdataset	rw(ds.get_id(),	memtype.get_id(),	H5S_ALL,	H5S_ALL);
+rw.write(seqs.data());
+return	ds;
+}
+
+//	reads	a	variable	length	dataset;	all	rows	end	up	in	one	buffer	without	further	allocations
+template<class	T>
+inline	void	read_dataset(const	Dataset	ds,	RaggedArray<T>	&ret)
+{
+Dataspace	sp	=	ds.get_dataspace();
+internal::read_ragged(ds,	sp,	H5S_ALL,	ret);
+}
+
+template<class	T>
+inline	void	read_dataset(const	Dataset	ds,	const	Selection	&sel,	RaggedArray<T>	&ret)
+{
+if	(sel.size()	==	0)
+{
+ret.clear();
+return;
+}
+Dataspace	file_space,	mem_space;
+sel.get_dataspaces(ds.get_dataspace(),	file_space,	mem_space);
+internal::read_ragged(ds,	mem_space,	file_space.get_id(),	ret);
+}
+
+
+/*
+Ragged	array	stored	as	two	plain	datasets	in	a	group:	"values",	all	rows
+concatenated,	and	"offsets",	where	row	i	spans	[offsets[i],	offsets[i+1]).
+Unlike	variable	length	data,	single	rows	can	be	read	with	two	small	reads	and
+the	values	compress	well.	Both	datasets	are	chunked	and	can	be	appended	to.
+*/
+template<class	T>
+class	RaggedDataset
+{
+Group	group;
+Dataset	values,	offsets;
+
+explicit	RaggedDataset(Group	g)	:	group(g),	values(g.open_dataset("values")),	offsets(g.open_dataset("offsets"))	{}
+
+public:
+RaggedDataset()	{}
+
+static	RaggedDataset	create(Group	parent,	const	std::string	&name,	hsize_t	chunk_size	=	1	<<	16,	DsCreationFlags	flags	=	CREATE_DS_DEFAULT)
+{
+Group	g	=	parent.create_group(name);
+hsize_t	zero	=	0,	one	=	1,	unlimited	=	H5S_UNLIMITED;
 Properties	prop(H5P_DATASET_CREATE);
+if	(flags	&	CREATE_DS_SHUFFLE)
+prop.shuffle();
 if	(flags	&	CREATE_DS_COMPRESSED)
 prop.deflate();
-if	(flags	&	CREATE_DS_CHUNKED	||	flags	&	CREATE_DS_COMPRESSED)
-prop.chunked_with_estimated_size(sp);
-return	prop;
+prop.chunked(1,	&chunk_size);
+Dataset::create(g,	"values",	internal::apply_disktype_flags(get_disktype<T>(),	flags),	Dataspace::simple(1,	&zero,	&unlimited),	prop);
+Dataset	o	=	Dataset::create(g,	"offsets",	get_disktype<hsize_t>(),	Dataspace::simple(1,	&one,	&unlimited),	prop);
+o.write(&zero);
+return	RaggedDataset(g);
+}
+
+static	RaggedDataset	open(Group	parent,	const	std::string	&name)
+{
+return	RaggedDataset(parent.open_group(name));
+}
+
+//	number	of	rows
+hsize_t	size()	const
+{
+return	offsets.get_dataspace().get_npoints()	-	1;
+}
+
+void	append(const	T	*row,	size_t	n)
+{
+hsize_t	end;
+read_offsets(size(),	1,	&end);
+append_dataset(values,	row,	n);
+end	+=	n;
+append_dataset(offsets,	&end,	1);
+}
+
+void	append(const	RaggedArray<T>	&rows)
+{
+if	(rows.size()	==	0)
+return;
+hsize_t	end;
+read_offsets(size(),	1,	&end);
+std::vector<hsize_t>	o(rows.offsets.begin()	+	1,	rows.offsets.end());
+for	(size_t	i=0;	i<o.size();	++i)
+o[i]	+=	end	-	rows.offsets[0];
+append_dataset(values,	rows.values.data()	+	rows.offsets[0],	rows.offsets.back()	-	rows.offsets[0]);
+append_dataset(offsets,	o.data(),	o.size());
+}
+
+void	read_row(hsize_t	i,	std::vector<T>	&ret)	const
+{
+hsize_t	o[2];
+read_offsets(i,	2,	o);
+ret.resize(o[1]	-	o[0]);
+read_values(o[0],	o[1]	-	o[0],	ret.data());
+}
+
+//	rows	[first,	first+count)
+void	read_rows(hsize_t	first,	hsize_t	count,	RaggedArray<T>	&ret)	const
+{
+ret.offsets.resize(count	+	1);
+read_offsets(first,	count	+	1,	ret.offsets.data());
+hsize_t	begin	=	ret.offsets[0];
+for	(size_t	i=0;	i<ret.offsets.size();	++i)
+ret.offsets[i]	-=	begin;
+ret.values.resize(ret.offsets.back());
+read_values(begin,	ret.offsets.back(),	ret.values.data());
+}
+
+void	read(RaggedArray<T>	&ret)	const
+{
+read_rows(0,	size(),	ret);
+}
+
+Group	get_group()	const	{	return	group;	}
+
+private:
+void	read_offsets(hsize_t	first,	hsize_t	count,	hsize_t	*dst)	const
+{
+if	(first	+	count	>	size()	+	1)
+throw	Exception("ragged	array	row	index	out	of	range");
+Dataspace	fs	=	offsets.get_dataspace();
+fs.select_hyperslab(&first,	NULL,	&count,	NULL);
+offsets.read(Dataspace::simple(1,	&count),	fs,	dst);
+}
+
+void	read_values(hsize_t	first,	hsize_t	count,	T	*dst)	const
+{
+if	(count	==	0)
+return;
+Dataspace	fs	=	values.get_dataspace();
+fs.select_hyperslab(&first,	NULL,	&count,	NULL);
+values.read(Dataspace::simple(1,	&count),	fs,	dst);
+}
+};
+
+
+/*--------------------------------------------------
+*	ingestion	queue
+*	------------------------------------------------	*/
+
+struct	IngestOptions
+{
+size_t	ring_records;	//	capacity	of	each	producer's	ring,	rounded	up	to	a	power	of	2
+size_t	batch_bytes;	//	staged	data	of	a	dataset	is	appended	once	it	exceeds	this,	ending	at	a	chunk	boundary
+double	max_latency_seconds;	//	staged	data	older	than	this	is	appended	anyway,	0	=	only	on	size	and	on	stop
+bool	block_when_full;	//	producers	wait	for	space	in	their	ring;	otherwise	push	fails
+double	poll_seconds;	//	how	long	the	idle	writer	sleeps
+
+IngestOptions()	:	ring_records(4096),	batch_bytes(4	<<	20),	max_latency_seconds(1.),	block_when_full(true),	poll_seconds(0.0005)	{}
+};
+
+struct	IngestStats
+{
+uint64_t	records;	//	taken	from	the	rings	by	the	writer
+uint64_t	rejected;	//	pushes	which	failed	because	the	ring	was	full	or	the	queue	stopped
+uint64_t	waits;	//	pushes	which	had	to	wait	for	space
+uint64_t	appends;	//	calls	of	append_dataset
+uint64_t	bytes_written;
+size_t	rings;	//	of	the	live	producers	and	of	destroyed	ones	the	writer	has	not	drained	yet
+
+IngestStats()	:	records(0),	rejected(0),	waits(0),	appends(0),	bytes_written(0),	rings(0)	{}
+};
+
+/*
+Collects	records	from	many	threads	and	appends	them	to	datasets	in	one	writer
+thread,	the	only	thread	that	calls	HDF5	while	the	queue	runs.	A	record	is	one
+row	of	a	target	dataset,	which	needs	an	unlimited	maximum	size	in	the	first
+dimension.	Each	producer	has	its	own	single-producer	ring;	push	copies	the	row
+into	it	without	locks	or	system	calls,	unless	the	ring	is	full.	The	writer
+takes	the	records	in	batches,	stages	them	per	dataset	and	appends	them	in
+large	writes	ending	at	chunk	boundaries.	stop()	(or	the	destructor)	appends
+everything	pushed	before	it	and	flushes	the	file.
+
+IngestQueue<float>	q({	ds_a,	ds_b	});
+//	in	each	producer	thread
+IngestQueue<float>::Producer	p	=	q.producer();
+p.push(0,	row);
+*/
+template<class	T>
+class	IngestQueue
+{
+//	single	producer,	single	consumer	ring	of	records
+struct	Ring
+{
+size_t	mask,	stride;
+std::vector<T>	rows;
+std::vector<uint32_t>	targets;
+char	pad0[64];
+std::atomic<size_t>	tail;	//	written	by	the	producer
+size_t	cached_head;	//	producer's	last	view	of	head
+std::atomic<bool>	busy;	//	the	producer	is	inside	push,	see	stop
+std::atomic<bool>	closed;	//	the	Producer	is	gone,	the	writer	frees	the	ring	once	it	is	drained
+std::atomic<uint64_t>	waits,	rejected;
+char	pad1[64];
+std::atomic<size_t>	head;	//	written	by	the	writer
+char	pad2[64];
+
+Ring(size_t	capacity,	size_t	stride_)	:	mask(capacity	-	1),	stride(stride_),	rows(capacity	*	stride_),	targets(capacity),	tail(0),	cached_head(0),	busy(false),	closed(false),	waits(0),	rejected(0),	head(0)	{}
+};
+
+struct	Target
+{
+Dataset	ds;
+size_t	row_size;	//	elements
+hsize_t	extent;	//	rows	in	the	dataset
+hsize_t	chunk_rows;	//	0	if	not	chunked
+std::vector<T>	staged;
+std::chrono::steady_clock::time_point	oldest;
+};
+
+IngestOptions	options;
+std::vector<Target>	targets;
+size_t	stride;	//	elements	per	ring	slot,	the	largest	row	size
+size_t	capacity;
+mutable	std::mutex	mutex;	//	for	rings,	the	retired	counts	and	the	writer's	sleep
+std::condition_variable	wake;
+std::vector<std::shared_ptr<Ring>	>	rings;	//	shared	with	the	producers,	which	may	outlive	the	queue
+uint64_t	retired_waits,	retired_rejected;	//	of	the	freed	rings
+std::atomic<bool>	stopping,	done;
+std::atomic<uint64_t>	records,	appends,	bytes_written;
+std::thread	writer;
+std::string	error;
+std::once_flag	stop_once;
+
+void	append(Target	&t,	bool	all)
+{
+hsize_t	rows	=	t.staged.size()	/	t.row_size;
+if	(!all	&&	t.chunk_rows	>	0)
+{
+hsize_t	end	=	t.extent	+	rows;
+end	-=	end	%	t.chunk_rows;
+rows	=	end	>	t.extent	?	end	-	t.extent	:	0;
+}
+if	(rows	==	0)
+return;
+append_dataset(t.ds,	t.staged.data(),	rows);
+t.extent	+=	rows;
+t.staged.erase(t.staged.begin(),	t.staged.begin()	+	rows	*	t.row_size);
+t.oldest	=	std::chrono::steady_clock::now();
+appends.fetch_add(1,	std::memory_order_relaxed);
+bytes_written.fetch_add(rows	*	t.row_size	*	sizeof(T),	std::memory_order_relaxed);
+}
+
+size_t	drain(Ring	&r)
+{
+const	size_t	head	=	r.head.load(std::memory_order_relaxed),	tail	=	r.tail.load(std::memory_order_acquire);
+for	(size_t	i=head;	i!=tail;	++i)
+{
+const	size_t	slot	=	i	&	r.mask;
+Target	&t	=	targets[r.targets[slot]];
+if	(t.staged.empty())
+t.oldest	=	std::chrono::steady_clock::now();
+const	T	*row	=	r.rows.data()	+	slot	*	r.stride;
+t.staged.insert(t.staged.end(),	row,	row	+	t.row_size);
+if	(t.staged.size()	*	sizeof(T)	>=	options.batch_bytes)
+append(t,	false);
+}
+r.head.store(tail,	std::memory_order_release);
+records.fetch_add(tail	-	head,	std::memory_order_relaxed);
+return	tail	-	head;
+}
+
+//	frees	the	rings	of	destroyed	producers;	closed	is	read	before	the	last	drain,	so	nothing	is	left	behind
+size_t	retire(const	std::vector<Ring*>	&current)
+{
+std::vector<Ring*>	gone;
+size_t	n	=	0;
+for	(size_t	i=0;	i<current.size();	++i)
+if	(current[i]->closed.load(std::memory_order_acquire))
+{
+n	+=	drain(*current[i]);
+gone.push_back(current[i]);
+}
+if	(gone.empty())
+return	n;
+std::lock_guard<std::mutex>	lock(mutex);
+for	(size_t	i=0;	i<rings.size();	)
+if	(std::find(gone.begin(),	gone.end(),	rings[i].get())	!=	gone.end())
+{
+retired_waits	+=	rings[i]->waits.load(std::memory_order_relaxed);
+retired_rejected	+=	rings[i]->rejected.load(std::memory_order_relaxed);
+rings.erase(rings.begin()	+	i);
+}
+else
+++i;
+return	n;
+}
+
+void	run()
+{
+try
+{
+for	(;;)
+{
+const	bool	last	=	stopping.load();
+std::vector<Ring*>	current;
+{
+std::lock_guard<std::mutex>	lock(mutex);
+for	(size_t	i=0;	i<rings.size();	++i)
+current.push_back(rings[i].get());
+}
+size_t	n	=	0;
+if	(last)
+{
+//	pushes	which	started	before	stop()	are	completed	first,	they	may	wait	for	space
+for	(size_t	i=0;	i<current.size();	++i)
+while	(current[i]->busy.load())
+{
+n	+=	drain(*current[i]);
+std::this_thread::yield();
+}
+}
+for	(size_t	i=0;	i<current.size();	++i)
+n	+=	drain(*current[i]);
+n	+=	retire(current);
+const	std::chrono::steady_clock::time_point	now	=	std::chrono::steady_clock::now();
+for	(size_t	i=0;	i<targets.size();	++i)
+if	(last	||	(options.max_latency_seconds	>	0	&&	!targets[i].staged.empty()	&&	std::chrono::duration<double>(now	-	targets[i].oldest).count()	>=	options.max_latency_seconds))
+append(targets[i],	true);
+if	(last)
+break;
+if	(n	==	0)
+{
+std::unique_lock<std::mutex>	lock(mutex);
+wake.wait_for(lock,	std::chrono::duration<double>(options.poll_seconds));
+}
+}
+for	(size_t	i=0;	i<targets.size();	++i)
+if	(H5Fflush(targets[i].ds.get_id(),	H5F_SCOPE_LOCAL)	<	0)
+throw	Exception("unable	to	flush	file");
+}
+catch	(const	std::exception	&e)
+{
+std::lock_guard<std::mutex>	lock(mutex);
+error	=	e.what();
+stopping	=	true;
+}
+done	=	true;
+}
+
+public:
+class	Producer
+{
+IngestQueue	*queue;
+std::shared_ptr<Ring>	ring;
+friend	class	IngestQueue;
+Producer(IngestQueue	*q,	const	std::shared_ptr<Ring>	&r)	:	queue(q),	ring(r)	{}
+
+void	close()
+{
+if	(ring)
+ring->closed.store(true,	std::memory_order_release);
+ring.reset();
+queue	=	NULL;
+}
+public:
+Producer()	:	queue(NULL)	{}
+Producer(Producer	&&o)	:	queue(o.queue),	ring(std::move(o.ring))	{	o.queue	=	NULL;	}
+Producer(const	Producer	&)	=	delete;
+Producer&	operator=(const	Producer	&)	=	delete;
+
+Producer&	operator=(Producer	&&o)
+{
+if	(this	!=	&o)
+{
+close();
+queue	=	o.queue;
+ring	=	std::move(o.ring);
+o.queue	=	NULL;
+}
+return	*this;
+}
+
+//	the	writer	frees	the	ring	once	it	has	taken	the	remaining	records
+~Producer()
+{
+close();
+}
+
+/*
+Copies	row,	which	has	the	row	size	of	the	target	dataset,	into	the	ring.
+Returns	false	if	the	queue	stopped,	or	if	the	ring	is	full	and
+block_when_full	is	off.	Makes	no	HDF5	calls,	so	a	bad	target	is	reported
+with	std::out_of_range	rather	than	Exception,	which	reads	the	error	stack.
+*/
+bool	push(size_t	target,	const	T	*row)
+{
+if	(target	>=	queue->targets.size())
+throw	std::out_of_range("no	such	ingestion	target");
+ring->busy.store(true);
+if	(queue->stopping.load())
+{
+ring->busy.store(false,	std::memory_order_release);
+ring->rejected.fetch_add(1,	std::memory_order_relaxed);
+return	false;
+}
+const	size_t	tail	=	ring->tail.load(std::memory_order_relaxed);
+if	(tail	-	ring->cached_head	>	ring->mask)
+{
+ring->cached_head	=	ring->head.load(std::memory_order_acquire);
+if	(tail	-	ring->cached_head	>	ring->mask)
+{
+if	(!queue->options.block_when_full)
+{
+ring->busy.store(false,	std::memory_order_release);
+ring->rejected.fetch_add(1,	std::memory_order_relaxed);
+return	false;
+}
+ring->waits.fetch_add(1,	std::memory_order_relaxed);
+queue->wake.notify_one();
+for	(int	spins=0;	tail	-	ring->cached_head	>	ring->mask;	++spins)
+{
+if	(queue->done.load(std::memory_order_relaxed))
+{
+ring->busy.store(false,	std::memory_order_release);
+ring->rejected.fetch_add(1,	std::memory_order_relaxed);
+return	false;
+}
+if	(spins	<	64)
+std::this_thread::yield();
+else
+std::this_thread::sleep_for(std::chrono::microseconds(50));
+ring->cached_head	=	ring->head.load(std::memory_order_acquire);
+}
+}
+}
+const	size_t	slot	=	tail	&	ring->mask;
+std::copy(row,	row	+	queue->targets[target].row_size,	ring->rows.data()	+	slot	*	ring->stride);
+ring->targets[slot]	=	uint32_t(target);
+ring->tail.store(tail	+	1,	std::memory_order_release);
+ring->busy.store(false,	std::memory_order_release);
+if	(tail	+	1	-	ring->cached_head	==	(ring->mask	+	1)	/	2)	//	wake	the	writer	early	if	the	ring	fills	up
+queue->wake.notify_one();
+return	true;
+}
+};
+
+IngestQueue(const	std::vector<Dataset>	&datasets,	const	IngestOptions	&options_	=	IngestOptions())
+:	options(options_),	stride(1),	capacity(1),	retired_waits(0),	retired_rejected(0),	stopping(false),	done(false),	records(0),	appends(0),	bytes_written(0)
+{
+for	(size_t	i=0;	i<datasets.size();	++i)
+{
+Target	t;
+t.ds	=	datasets[i];
+hsize_t	dims[H5S_MAX_RANK];
+int	rank	=	t.ds.get_dataspace().get_dims(dims);
+hsize_t	max_dims[H5S_MAX_RANK];
+if	(rank	<	1	||	H5Sget_simple_extent_dims(t.ds.get_dataspace().get_id(),	NULL,	max_dims)	<	0	||	max_dims[0]	!=	H5S_UNLIMITED)
+throw	Exception("ingestion	needs	datasets	with	an	unlimited	first	dimension");
+t.row_size	=	1;
+for	(int	d=1;	d<rank;	++d)
+t.row_size	*=	dims[d];
+t.extent	=	dims[0];
+t.chunk_rows	=	0;
+Object	dcpl(H5Dget_create_plist(t.ds.get_id()));
+hsize_t	chunk_dims[H5S_MAX_RANK];
+if	(H5Pget_layout(dcpl.get_id())	==	H5D_CHUNKED	&&	H5Pget_chunk(dcpl.get_id(),	H5S_MAX_RANK,	chunk_dims)	>	0)
+t.chunk_rows	=	chunk_dims[0];
+stride	=	std::max(stride,	t.row_size);
+targets.push_back(t);
+}
+while	(capacity	<	options.ring_records)
+capacity	*=	2;
+writer	=	std::thread(&IngestQueue::run,	this);
+}
+
+~IngestQueue()
+{
+try
+{
+stop();
+}
+catch	(...)	{}
+}
+
+IngestQueue(const	IngestQueue&)	=	delete;
+IngestQueue&	operator=(const	IngestQueue&)	=	delete;
+
+//	a	producer	for	the	calling	thread;	each	thread	needs	its	own
+Producer	producer()
+{
+std::shared_ptr<Ring>	r(new	Ring(capacity,	stride));
+std::lock_guard<std::mutex>	lock(mutex);
+rings.push_back(r);
+return	Producer(this,	r);
+}
+
+/*
+Appends	all	records	pushed	before,	flushes	the	files	and	ends	the	writer
+thread;	later	pushes	fail.	Throws	if	the	writer	failed.	Several	threads	may
+call	it,	all	return	once	the	writer	has	ended.
+*/
+void	stop()
+{
+std::call_once(stop_once,	[this]()
+{
+stopping	=	true;
+wake.notify_one();
+writer.join();
+});
+std::lock_guard<std::mutex>	lock(mutex);
+if	(!error.empty())
+throw	Exception("ingestion	writer	failed:	"	+	error);
+}
+
+IngestStats	stats()	const
+{
+IngestStats	s;
+s.records	=	records.load(std::memory_order_relaxed);
+s.appends	=	appends.load(std::memory_order_relaxed);
+s.bytes_written	=	bytes_written.load(std::memory_order_relaxed);
+std::lock_guard<std::mutex>	lock(mutex);
+s.waits	=	retired_waits;
+s.rejected	=	retired_rejected;
+s.rings	=	rings.size();
+for	(size_t	i=0;	i<rings.size();	++i)
+{
+s.waits	+=	rings[i]->waits.load(std::memory_order_relaxed);
+s.rejected	+=	rings[i]->rejected.load(std::memory_order_relaxed);
+}
+return	s;
+}
+};
+
+
+/*--------------------------------------------------
+*	Zone	maps
+*	------------------------------------------------	*/
+
+/*
+Summary	of	the	values	in	one	zone	of	a	dataset.	min	and	max	ignore	NaNs;	they
+are	+inf	and	-inf	if	the	zone	holds	no	other	values.
+*/
+struct	ChunkStats
+{
+double	min,	max;
+uint64_t	count,	nan_count;
+};
+
+template<>
+struct	h5traits<ChunkStats>
+{
+static	inline	Datatype	get_memtype()
+{
+Datatype	dt	=	Datatype::createCompound(sizeof(ChunkStats));
+dt.insert("min",	HOFFSET(ChunkStats,	min),	h5cpp::get_memtype<double>());
+dt.insert("max",	HOFFSET(ChunkStats,	max),	h5cpp::get_memtype<double>());
+dt.insert("count",	HOFFSET(ChunkStats,	count),	h5cpp::get_memtype<unsigned	long	long>());
+dt.insert("nan_count",	HOFFSET(ChunkStats,	nan_count),	h5cpp::get_memtype<unsigned	long	long>());
+return	dt;
+}
+
+static	inline	Datatype	get_disktype()
+{
+Datatype	dt	=	Datatype::createCompound(32);
+dt.insert("min",	0,	h5cpp::get_disktype<double>());
+dt.insert("max",	8,	h5cpp::get_disktype<double>());
+dt.insert("count",	16,	h5cpp::get_disktype<unsigned	long	long>());
+dt.insert("nan_count",	24,	h5cpp::get_disktype<unsigned	long	long>());
+return	dt;
+}
+
+template<class	RWT>
+static	inline	void	write(RWT	&rw,	const	Datatype	&memtype,	const	Dataspace	&memspace,	const	ChunkStats	*values)
+{
+rw.write(values);
+}
+
+template<class	RWT>
+static	inline	void	read(RWT	&rw,	const	Datatype	&memtype,	const	Dataspace	&memspace,	ChunkStats	*values)
+{
+rw.read(values);
+}
+};
+
+
+/*
+Values	v	with	lo	<	v	<	hi,	each	bound	optionally	inclusive.	NaN	never	matches.
+Values	are	compared	as	double,	so	64	bit	integers	beyond	2^53	compare	inexactly.
+*/
+struct	ValueRange
+{
+double	lo,	hi;
+bool	lo_inclusive,	hi_inclusive;
+
+ValueRange(double	lo_	=	-std::numeric_limits<double>::infinity(),	double	hi_	=	std::numeric_limits<double>::infinity(),	bool	lo_inclusive_	=	true,	bool	hi_inclusive_	=	true)
+:	lo(lo_),	hi(hi_),	lo_inclusive(lo_inclusive_),	hi_inclusive(hi_inclusive_)	{}
+
+static	ValueRange	greater(double	x)	{	return	ValueRange(x,	std::numeric_limits<double>::infinity(),	false,	true);	}
+static	ValueRange	greater_equal(double	x)	{	return	ValueRange(x,	std::numeric_limits<double>::infinity(),	true,	true);	}
+static	ValueRange	less(double	x)	{	return	ValueRange(-std::numeric_limits<double>::infinity(),	x,	true,	false);	}
+static	ValueRange	less_equal(double	x)	{	return	ValueRange(-std::numeric_limits<double>::infinity(),	x,	true,	true);	}
+static	ValueRange	between(double	lo,	double	hi)	{	return	ValueRange(lo,	hi,	true,	true);	}
+
+template<class	T>
+bool	operator()(T	value)	const
+{
+double	x	=	static_cast<double>(value);
+return	(lo_inclusive	?	x	>=	lo	:	x	>	lo)	&&	(hi_inclusive	?	x	<=	hi	:	x	<	hi);
+}
+
+//	false	if	no	value	in	the	zone	can	match
+bool	may_match(const	ChunkStats	&s)	const
+{
+if	(s.count	==	s.nan_count)
+return	false;
+return	(lo_inclusive	?	s.max	>=	lo	:	s.max	>	lo)	&&	(hi_inclusive	?	s.min	<=	hi	:	s.min	<	hi);
+}
+};
+
+
+namespace	internal
+{
+
+/*
+Partition	of	a	dataset	into	zones:	its	chunks,	or	blocks	of	rows	of	about
+1	MiB	if	it	is	not	chunked.	Zones	are	numbered	in	row-major	order	of	the	grid.
+*/
+struct	ZoneGrid
+{
+int	rank;
+hsize_t	dims[H5S_MAX_RANK],	zone_dims[H5S_MAX_RANK],	grid[H5S_MAX_RANK];
+hsize_t	size;	//	number	of	zones
+
+void	init(const	hsize_t	*zone_dims_)
+{
+size	=	1;
+for	(int	d=0;	d<rank;	++d)
+{
+zone_dims[d]	=	std::max<hsize_t>(1,	zone_dims_[d]);
+grid[d]	=	(dims[d]	+	zone_dims[d]	-	1)	/	zone_dims[d];
+size	*=	grid[d];
+}
+}
+
+ZoneGrid(const	Dataset	&ds,	const	hsize_t	*zone_dims_	=	NULL)
+{
+rank	=	ds.get_dataspace().get_dims(dims);
+if	(rank	<	1)
+throw	Exception("zone	maps	need	a	dataset	of	rank	>=	1");
+hsize_t	zd[H5S_MAX_RANK];
+if	(zone_dims_)
+std::copy(zone_dims_,	zone_dims_	+	rank,	zd);
+else
+{
+Object	dcpl(H5Dget_create_plist(ds.get_id()));
+if	(H5Pget_layout(dcpl.get_id())	!=	H5D_CHUNKED	||	H5Pget_chunk(dcpl.get_id(),	rank,	zd)	!=	rank)
+{
+size_t	row_bytes	=	ds.get_datatype().get_size();
+for	(int	d=1;	d<rank;	++d)
+{
+zd[d]	=	dims[d];
+row_bytes	*=	dims[d];
+}
+zd[0]	=	std::max<size_t>(1,	(1	<<	20)	/	std::max<size_t>(1,	row_bytes));
+}
+}
+init(zd);
+}
+
+//	region	of	zone	i,	clipped	to	the	extent
+void	region(hsize_t	i,	hsize_t	*offset,	hsize_t	*count)	const
+{
+for	(int	d=rank-1;	d>=0;	--d)
+{
+hsize_t	k	=	i	%	grid[d];
+i	/=	grid[d];
+offset[d]	=	k	*	zone_dims[d];
+count[d]	=	std::min(zone_dims[d],	dims[d]	-	offset[d]);
+}
+}
+
+hsize_t	elements(const	hsize_t	*count)	const
+{
+hsize_t	n	=	1;
+for	(int	d=0;	d<rank;	++d)
+n	*=	count[d];
+return	n;
+}
+
+//	calls	f(linear	index	in	the	dataset,	linear	index	in	the	region,	length)	for	each	run	of	the	region	along	the	last	dimension
+template<class	F>
+void	for_each_run(const	hsize_t	*offset,	const	hsize_t	*count,	F	f)	const
+{
+if	(elements(count)	==	0)
+return;
+hsize_t	idx[H5S_MAX_RANK]	=	{	0	};
+hsize_t	local	=	0;
+for	(;;)
+{
+hsize_t	global	=	0;
+for	(int	d=0;	d<rank;	++d)
+global	=	global	*	dims[d]	+	offset[d]	+	idx[d];
+f(global,	local,	count[rank-1]);
+local	+=	count[rank-1];
+int	d	=	rank	-	2;
+for	(;	d>=0;	--d)
+{
+if	(++idx[d]	<	count[d])
+break;
+idx[d]	=	0;
+}
+if	(d	<	0)
+return;
+}
+}
+};
+
+#ifdef	HDF_WRAPPER_X86_SIMD
+/*
+The	stats	kernels	fold	the	first	elements	of	data	into	lo,	hi	and	nans	and
+return	how	many	they	did.	min/max	return	their	second	operand	if	either	is
+NaN,	so	NaNs	never	replace	lo	or	hi.
+*/
+__attribute__((target("avx2")))
+inline	size_t	stats_avx2(const	double	*data,	size_t	n,	double	&lo,	double	&hi,	uint64_t	&nans)
+{
+size_t	i	=	0;
+__m256d	vlo	=	_mm256_set1_pd(lo),	vhi	=	_mm256_set1_pd(hi);
+for	(;	i+4<=n;	i+=4)
+{
+__m256d	v	=	_mm256_loadu_pd(data	+	i);
+vlo	=	_mm256_min_pd(v,	vlo);
+vhi	=	_mm256_max_pd(v,	vhi);
+nans	+=	__builtin_popcount(_mm256_movemask_pd(_mm256_cmp_pd(v,	v,	_CMP_UNORD_Q)));
+}
+double	l[4],	h[4];
+_mm256_storeu_pd(l,	vlo);
+_mm256_storeu_pd(h,	vhi);
+for	(int	k=0;	k<4;	++k)
+{
+lo	=	std::min(lo,	l[k]);
+hi	=	std::max(hi,	h[k]);
+}
+return	i;
+}
+
+__attribute__((target("avx2")))
+inline	size_t	stats_avx2(const	float	*data,	size_t	n,	float	&lo,	float	&hi,	uint64_t	&nans)
+{
+size_t	i	=	0;
+__m256	vlo	=	_mm256_set1_ps(lo),	vhi	=	_mm256_set1_ps(hi);
+for	(;	i+8<=n;	i+=8)
+{
+__m256	v	=	_mm256_loadu_ps(data	+	i);
+vlo	=	_mm256_min_ps(v,	vlo);
+vhi	=	_mm256_max_ps(v,	vhi);
+nans	+=	__builtin_popcount(_mm256_movemask_ps(_mm256_cmp_ps(v,	v,	_CMP_UNORD_Q)));
+}
+float	l[8],	h[8];
+_mm256_storeu_ps(l,	vlo);
+_mm256_storeu_ps(h,	vhi);
+for	(int	k=0;	k<8;	++k)
+{
+lo	=	std::min(lo,	l[k]);
+hi	=	std::max(hi,	h[k]);
+}
+return	i;
+}
+
+//	see	double_to_float_avx512
+#pragma	GCC	diagnostic	push
+#pragma	GCC	diagnostic	ignored	"-Wmaybe-uninitialized"
+__attribute__((target("avx512f")))
+inline	size_t	stats_avx512(const	double	*data,	size_t	n,	double	&lo,	double	&hi,	uint64_t	&nans)
+{
+size_t	i	=	0;
+__m512d	vlo	=	_mm512_set1_pd(lo),	vhi	=	_mm512_set1_pd(hi);
+for	(;	i+8<=n;	i+=8)
+{
+__m512d	v	=	_mm512_loadu_pd(data	+	i);
+vlo	=	_mm512_min_pd(v,	vlo);
+vhi	=	_mm512_max_pd(v,	vhi);
+nans	+=	__builtin_popcount(_mm512_cmp_pd_mask(v,	v,	_CMP_UNORD_Q));
+}
+double	l[8],	h[8];
+_mm512_storeu_pd(l,	vlo);
+_mm512_storeu_pd(h,	vhi);
+for	(int	k=0;	k<8;	++k)
+{
+lo	=	std::min(lo,	l[k]);
+hi	=	std::max(hi,	h[k]);
+}
+return	i;
+}
+
+__attribute__((target("avx512f")))
+inline	size_t	stats_avx512(const	float	*data,	size_t	n,	float	&lo,	float	&hi,	uint64_t	&nans)
+{
+size_t	i	=	0;
+__m512	vlo	=	_mm512_set1_ps(lo),	vhi	=	_mm512_set1_ps(hi);
+for	(;	i+16<=n;	i+=16)
+{
+__m512	v	=	_mm512_loadu_ps(data	+	i);
+vlo	=	_mm512_min_ps(v,	vlo);
+vhi	=	_mm512_max_ps(v,	vhi);
+nans	+=	__builtin_popcount(_mm512_cmp_ps_mask(v,	v,	_CMP_UNORD_Q));
+}
+float	l[16],	h[16];
+_mm512_storeu_ps(l,	vlo);
+_mm512_storeu_ps(h,	vhi);
+for	(int	k=0;	k<16;	++k)
+{
+lo	=	std::min(lo,	l[k]);
+hi	=	std::max(hi,	h[k]);
+}
+return	i;
+}
+
+//	the	mask	kernels	set	mask[k]	to	range(data[k])	for	the	first	elements,	comparing	as	double,	and	return	how	many	they	did
+__attribute__((target("avx2")))
+inline	__m256d	load4_pd(const	double	*p)	{	return	_mm256_loadu_pd(p);	}
+
+__attribute__((target("avx2")))
+inline	__m256d	load4_pd(const	float	*p)	{	return	_mm256_cvtps_pd(_mm_loadu_ps(p));	}
+
+__attribute__((target("avx512f")))
+inline	__m512d	load8_pd(const	double	*p)	{	return	_mm512_loadu_pd(p);	}
+
+__attribute__((target("avx512f")))
+inline	__m512d	load8_pd(const	float	*p)	{	return	_mm512_cvtps_pd(_mm256_loadu_ps(p));	}
+
+template<class	T>
+__attribute__((target("avx2")))
+inline	size_t	range_mask_avx2(const	T	*data,	size_t	n,	const	ValueRange	&range,	unsigned	char	*mask)
+{
+size_t	i	=	0;
+const	__m256d	lo	=	_mm256_set1_pd(range.lo),	hi	=	_mm256_set1_pd(range.hi);
+for	(;	i+4<=n;	i+=4)
+{
+__m256d	v	=	load4_pd(data	+	i);
+__m256d	a	=	range.lo_inclusive	?	_mm256_cmp_pd(v,	lo,	_CMP_GE_OQ)	:	_mm256_cmp_pd(v,	lo,	_CMP_GT_OQ);
+__m256d	b	=	range.hi_inclusive	?	_mm256_cmp_pd(v,	hi,	_CMP_LE_OQ)	:	_mm256_cmp_pd(v,	hi,	_CMP_LT_OQ);
+uint32_t	m	=	_mm256_movemask_pd(_mm256_and_pd(a,	b));
+uint32_t	bytes	=	(m	&	1)	|	(m	&	2)	<<	7	|	(m	&	4)	<<	14	|	(m	&	8)	<<	21;	//	one	byte	per	bit,	little	endian
+std::memcpy(mask	+	i,	&bytes,	4);
+}
+return	i;
+}
+
+template<class	T>
+__attribute__((target("avx512f")))
+inline	size_t	range_mask_avx512(const	T	*data,	size_t	n,	const	ValueRange	&range,	unsigned	char	*mask)
+{
+size_t	i	=	0;
+const	__m512d	lo	=	_mm512_set1_pd(range.lo),	hi	=	_mm512_set1_pd(range.hi);
+const	__m512i	one	=	_mm512_set1_epi64(1);
+for	(;	i+8<=n;	i+=8)
+{
+__m512d	v	=	load8_pd(data	+	i);
+__mmask8	a	=	range.lo_inclusive	?	_mm512_cmp_pd_mask(v,	lo,	_CMP_GE_OQ)	:	_mm512_cmp_pd_mask(v,	lo,	_CMP_GT_OQ);
+__mmask8	b	=	range.hi_inclusive	?	_mm512_cmp_pd_mask(v,	hi,	_CMP_LE_OQ)	:	_mm512_cmp_pd_mask(v,	hi,	_CMP_LT_OQ);
+_mm512_mask_cvtepi64_storeu_epi8(mask	+	i,	0xff,	_mm512_maskz_mov_epi64(a	&	b,	one));
+}
+return	i;
+}
+#pragma	GCC	diagnostic	pop
+
+inline	size_t	simd_stats(const	double	*data,	size_t	n,	double	&lo,	double	&hi,	uint64_t	&nans)
+{
+return	cpu_has_avx512f()	?	stats_avx512(data,	n,	lo,	hi,	nans)	:	cpu_has_avx2()	?	stats_avx2(data,	n,	lo,	hi,	nans)	:	0;
+}
+
+inline	size_t	simd_stats(const	float	*data,	size_t	n,	float	&lo,	float	&hi,	uint64_t	&nans)
+{
+return	cpu_has_avx512f()	?	stats_avx512(data,	n,	lo,	hi,	nans)	:	cpu_has_avx2()	?	stats_avx2(data,	n,	lo,	hi,	nans)	:	0;
+}
+
+inline	size_t	simd_range_mask(const	double	*data,	size_t	n,	const	ValueRange	&range,	unsigned	char	*mask)
+{
+return	cpu_has_avx512f()	?	range_mask_avx512(data,	n,	range,	mask)	:	cpu_has_avx2()	?	range_mask_avx2(data,	n,	range,	mask)	:	0;
+}
+
+inline	size_t	simd_range_mask(const	float	*data,	size_t	n,	const	ValueRange	&range,	unsigned	char	*mask)
+{
+return	cpu_has_avx512f()	?	range_mask_avx512(data,	n,	range,	mask)	:	cpu_has_avx2()	?	range_mask_avx2(data,	n,	range,	mask)	:	0;
+}
+#endif
+
+//	other	types,	and	builds	without	SIMD,	take	the	scalar	loops
+template<class	T>
+inline	size_t	simd_stats(const	T	*,	size_t,	T	&,	T	&,	uint64_t	&)
+{
+return	0;
+}
+
+template<class	T>
+inline	size_t	simd_range_mask(const	T	*,	size_t,	const	ValueRange	&,	unsigned	char	*)
+{
+return	0;
+}
+
+//	comparisons	with	NaN	are	false,	so	NaNs	never	become	min	or	max
+template<class	T>
+inline	void	accumulate_stats(const	T	*data,	size_t	n,	ChunkStats	&s)
+{
+const	T	inf	=	std::numeric_limits<T>::has_infinity	?	std::numeric_limits<T>::infinity()	:	std::numeric_limits<T>::max();
+const	T	neg_inf	=	std::numeric_limits<T>::has_infinity	?	-std::numeric_limits<T>::infinity()	:	std::numeric_limits<T>::lowest();
+T	lo	=	inf,	hi	=	neg_inf;
+uint64_t	nans	=	0;
+for	(size_t	i=simd_stats(data,	n,	lo,	hi,	nans);	i<n;	++i)
+{
+T	v	=	data[i];
+lo	=	v	<	lo	?	v	:	lo;
+hi	=	v	>	hi	?	v	:	hi;
+nans	+=	(v	!=	v);
+}
+if	(s.count	==	s.nan_count)
+{
+s.min	=	std::numeric_limits<double>::infinity();
+s.max	=	-std::numeric_limits<double>::infinity();
+}
+if	(n	>	nans)
+{
+s.min	=	std::min(s.min,	static_cast<double>(lo));
+s.max	=	std::max(s.max,	static_cast<double>(hi));
+}
+s.count	+=	n;
+s.nan_count	+=	nans;
+}
+
+//	mask[k]	=	range(data[k])
+template<class	T>
+inline	void	range_mask(const	T	*data,	size_t	n,	const	ValueRange	&range,	unsigned	char	*mask)
+{
+const	double	lo	=	range.lo,	hi	=	range.hi;
+const	bool	lo_incl	=	range.lo_inclusive,	hi_incl	=	range.hi_inclusive;
+for	(size_t	k=simd_range_mask(data,	n,	range,	mask);	k<n;	++k)
+{
+double	x	=	static_cast<double>(data[k]);
+mask[k]	=	((x	>	lo)	|	(lo_incl	&	(x	==	lo)))	&	((x	<	hi)	|	(hi_incl	&	(x	==	hi)));
+}
+}
+
+inline	ChunkStats	empty_stats()
+{
+ChunkStats	s;
+s.min	=	std::numeric_limits<double>::infinity();
+s.max	=	-std::numeric_limits<double>::infinity();
+s.count	=	s.nan_count	=	0;
+return	s;
+}
+
+//	stores	the	stats	of	each	zone,	and	the	grid	they	were	computed	for,	see	invalidate_zone_map
+inline	void	write_zone_map(const	Dataset	&ds,	const	ZoneGrid	&grid,	const	std::vector<ChunkStats>	&stats)
+{
+Attributes	attrs(ds);
+if	(attrs.exists("zone_map.valid"))
+attrs.remove("zone_map.valid");
+const	hsize_t	pieces	=	(stats.size()	+	zone_map_piece	-	1)	/	zone_map_piece;
+for	(hsize_t	k=pieces;	attrs.exists(zone_map_piece_name(k));	++k)
+attrs.remove(zone_map_piece_name(k));
+for	(hsize_t	k=0;	k<pieces;	++k)
+{
+hsize_t	n	=	std::min<hsize_t>(zone_map_piece,	stats.size()	-	k	*	zone_map_piece);
+attrs.set(zone_map_piece_name(k),	Dataspace::simple(1,	&n),	stats.data()	+	k	*	zone_map_piece);
+}
+hsize_t	r	=	grid.rank;
+attrs.set("zone_map.dims",	Dataspace::simple(1,	&r),	grid.dims);
+attrs.set("zone_map.zone_dims",	Dataspace::simple(1,	&r),	grid.zone_dims);
+attrs.set("zone_map.valid",	1);
+}
+
+/*
+false	if	there	is	no	zone	map	for	the	current	extent	of	ds,	or	if	it	was
+invalidated	by	a	write	and	stale	is	false;	zone_dims	receives	the	zone
+dimensions	of	the	map
+*/
+inline	bool	read_zone_map(const	Dataset	&ds,	hsize_t	*zone_dims,	std::vector<ChunkStats>	&stats,	bool	stale	=	false)
+{
+Attributes	attrs(ds);
+if	(!attrs.exists("zone_map.dims")	||	(!stale	&&	!attrs.exists("zone_map.valid")))
+return	false;
+int	rank	=	ds.get_dataspace().get_rank();
+hsize_t	dims[H5S_MAX_RANK];
+Attribute	a	=	attrs.open("zone_map.dims");
+if	(H5Sget_simple_extent_npoints(a.get_dataspace().get_id())	!=	rank)
+return	false;
+a.read(dims);
+attrs.open("zone_map.zone_dims").read(zone_dims);
+ZoneGrid	grid(ds,	zone_dims);
+if	(!std::equal(dims,	dims	+	rank,	grid.dims))
+return	false;
+stats.resize(grid.size);
+for	(hsize_t	k=0;	k	*	zone_map_piece	<	grid.size;	++k)
+{
+hsize_t	n	=	std::min<hsize_t>(zone_map_piece,	grid.size	-	k	*	zone_map_piece);
+if	(!attrs.exists(zone_map_piece_name(k)))
+return	false;
+Attribute	p	=	attrs.open(zone_map_piece_name(k));
+if	(H5Sget_simple_extent_npoints(p.get_dataspace().get_id())	!=	(hssize_t)n)
+return	false;
+p.read(stats.data()	+	k	*	zone_map_piece);
+}
+return	true;
+}
+
+template<class	T>
+inline	ChunkStats	zone_stats(const	Dataset	&ds,	const	ZoneGrid	&grid,	hsize_t	zone,	std::vector<T>	&buf)
+{
+hsize_t	offset[H5S_MAX_RANK],	count[H5S_MAX_RANK];
+grid.region(zone,	offset,	count);
+buf.resize(grid.elements(count));
+ChunkStats	s	=	empty_stats();
+if	(buf.empty())
+return	s;
+Dataspace	file_space	=	ds.get_dataspace();
+file_space.select_hyperslab(offset,	NULL,	count,	NULL);
+ds.read(Dataspace::simple(grid.rank,	count),	file_space,	buf.data());
+accumulate_stats(buf.data(),	buf.size(),	s);
+return	s;
+}
+
+}	//	namespace	internal
+
+
+/*
+Compute	the	zone	map	of	a	numeric	dataset:	min,	max,	count	and	NaN	count	of
+each	chunk	(or	block	of	rows,	if	not	chunked).	It	is	stored	in	attributes
+of	the	dataset	and	used	by	Dataset::read_where	to	skip	zones.	Any	later	write
+through	the	wrapper	invalidates	it;	use	update_zone_map	or	write_with_zone_map
+to	keep	it.	Writes	by	other	programs	are	not	noticed.	A	zone	map	built	for	a
+different	extent	is	ignored.
+*/
+template<class	T>
+inline	void	build_zone_map(const	Dataset	&ds)
+{
+static_assert(std::is_arithmetic<T>::value,	"zone	maps	need	numeric	data");
+internal::ZoneGrid	grid(ds);
+std::vector<ChunkStats>	stats(grid.size);
+std::vector<T>	buf;
+for	(hsize_t	i=0;	i<grid.size;	++i)
+stats[i]	=	internal::zone_stats(ds,	grid,	i,	buf);
+internal::write_zone_map(ds,	grid,	stats);
+}
+
+/*
+Recompute	the	zones	which	intersect	the	given	region,	after	writing	to	it,	and
+make	the	zone	map	valid	again.	It	must	be	the	only	region	written	since	the
+map	was	last	built	or	updated.
+*/
+template<class	T>
+inline	void	update_zone_map(const	Dataset	&ds,	const	hsize_t	*offset,	const	hsize_t	*count)
+{
+static_assert(std::is_arithmetic<T>::value,	"zone	maps	need	numeric	data");
+hsize_t	zone_dims[H5S_MAX_RANK];
+std::vector<ChunkStats>	stats;
+if	(!internal::read_zone_map(ds,	zone_dims,	stats,	true))
+{
+build_zone_map<T>(ds);
+return;
+}
+internal::ZoneGrid	grid(ds,	zone_dims);
+hsize_t	zone_offset[H5S_MAX_RANK],	zone_count[H5S_MAX_RANK];
+std::vector<T>	buf;
+for	(hsize_t	i=0;	i<grid.size;	++i)
+{
+grid.region(i,	zone_offset,	zone_count);
+bool	hit	=	true;
+for	(int	d=0;	d<grid.rank	&&	hit;	++d)
+hit	=	zone_offset[d]	<	offset[d]	+	count[d]	&&	offset[d]	<	zone_offset[d]	+	zone_count[d];
+if	(hit)
+stats[i]	=	internal::zone_stats(ds,	grid,	i,	buf);
+}
+internal::write_zone_map(ds,	grid,	stats);
+}
+
+//	write	the	whole	dataset	and	compute	its	zone	map	from	data,	without	reading	it	back
+template<class	T>
+inline	void	write_with_zone_map(Dataset	ds,	const	T	*data)
+{
+static_assert(std::is_arithmetic<T>::value,	"zone	maps	need	numeric	data");
+ds.write(data);
+internal::ZoneGrid	grid(ds);
+std::vector<ChunkStats>	stats(grid.size,	internal::empty_stats());
+hsize_t	offset[H5S_MAX_RANK],	count[H5S_MAX_RANK];
+for	(hsize_t	i=0;	i<grid.size;	++i)
+{
+grid.region(i,	offset,	count);
+ChunkStats	&s	=	stats[i];
+grid.for_each_run(offset,	count,	[&](hsize_t	global,	hsize_t,	hsize_t	n)	{	internal::accumulate_stats(data	+	global,	n,	s);	});
+}
+internal::write_zone_map(ds,	grid,	stats);
+}
+
+
+/*
+Elements	of	ds	within	range,	as	linear	(row-major)	indices	and	values.	Zones
+which	cannot	match	according	to	the	zone	map	are	not	read;	without	a	zone	map
+for	the	current	extent	all	zones	are	scanned,	one	at	a	time.
+*/
+template<class	T>
+inline	void	Dataset::read_where(const	ValueRange	&range,	std::vector<hsize_t>	&indices,	std::vector<T>	&values)	const
+{
+static_assert(std::is_arithmetic<T>::value,	"read_where	needs	numeric	data");
+indices.clear();
+values.clear();
+hsize_t	zone_dims[H5S_MAX_RANK];
+std::vector<ChunkStats>	stats;
+bool	have_stats	=	internal::read_zone_map(*this,	zone_dims,	stats);
+internal::ZoneGrid	grid(*this,	have_stats	?	zone_dims	:	NULL);
+hsize_t	offset[H5S_MAX_RANK],	count[H5S_MAX_RANK];
+std::vector<T>	buf;
+std::vector<unsigned	char>	mask;
+for	(hsize_t	i=0;	i<grid.size;	++i)
+{
+if	(have_stats	&&	!range.may_match(stats[i]))
+continue;
+grid.region(i,	offset,	count);
+hsize_t	n	=	grid.elements(count);
+if	(n	==	0)
+continue;
+buf.resize(n);
+Dataspace	file_space	=	get_dataspace();
+file_space.select_hyperslab(offset,	NULL,	count,	NULL);
+read(Dataspace::simple(grid.rank,	count),	file_space,	buf.data());
+mask.resize(n);
+internal::range_mask(buf.data(),	n,	range,	mask.data());
+grid.for_each_run(offset,	count,	[&](hsize_t	global,	hsize_t	local,	hsize_t	len)
+{
+for	(hsize_t	k=0;	k<len;	++k)
+{
+if	(mask[local	+	k])
+{
+indices.push_back(global	+	k);
+values.push_back(buf[local	+	k]);
+}
+}
+});
+}
+}
+
+
+/*--------------------------------------------------
+*	Multi-resolution	pyramids
+*	------------------------------------------------	*/
+
+//	how	2^rank	elements	of	a	level	are	combined	into	one	element	of	the	next	level
+enum	PyramidReducer
+{
+PYRAMID_MEAN	=	0,
+PYRAMID_MIN	=	1,
+PYRAMID_MAX	=	2,
+PYRAMID_STRIDE	=	3	//	take	the	first	element,	i.e.	plain	subsampling
+};
+
+namespace	internal
+{
+
+/*
+Halve	dims[axis]	of	a	row-major	block	by	combining	pairs	of	elements.	A	last
+odd	element	is	combined	with	itself.	The	inner	loops	run	over	contiguous
+memory	and	vectorize,	except	for	the	last	axis.
+*/
+template<class	A>
+inline	void	reduce_axis(std::vector<A>	&buf,	std::vector<A>	&tmp,	int	rank,	hsize_t	*dims,	int	axis,	PyramidReducer	reducer)
+{
+hsize_t	outer	=	1,	inner	=	1;
+for	(int	d=0;	d<axis;	++d)
+outer	*=	dims[d];
+for	(int	d=axis+1;	d<rank;	++d)
+inner	*=	dims[d];
+const	hsize_t	n	=	dims[axis],	m	=	(n	+	1)	/	2;
+tmp.resize(outer	*	m	*	inner);
+for	(hsize_t	o=0;	o<outer;	++o)
+{
+for	(hsize_t	j=0;	j<m;	++j)
+{
+const	A	*a	=	&buf[(o	*	n	+	2	*	j)	*	inner];
+const	A	*b	=	2	*	j	+	1	<	n	?	a	+	inner	:	a;
+A	*out	=	&tmp[(o	*	m	+	j)	*	inner];
+switch	(reducer)
+{
+case	PYRAMID_MEAN:
+for	(hsize_t	i=0;	i<inner;	++i)	out[i]	=	(a[i]	+	b[i])	/	2;
+break;
+case	PYRAMID_MIN:
+for	(hsize_t	i=0;	i<inner;	++i)	out[i]	=	b[i]	<	a[i]	?	b[i]	:	a[i];
+break;
+case	PYRAMID_MAX:
+for	(hsize_t	i=0;	i<inner;	++i)	out[i]	=	b[i]	>	a[i]	?	b[i]	:	a[i];
+break;
+default:
+std::copy(a,	a	+	inner,	out);
+}
+}
+}
+dims[axis]	=	m;
+buf.swap(tmp);
+}
+
+template<class	T>
+inline	T	round_to(double	x)
+{
+return	std::is_integral<T>::value	?	static_cast<T>(std::floor(x	+	0.5))	:	static_cast<T>(x);
+}
+
+//	one	tile	of	dst	from	the	corresponding	block	of	src,	which	has	twice	its	size	in	each	dimension
+template<class	T>
+inline	void	downsample_tile(const	Dataset	&src,	Dataset	&dst,	int	rank,	const	hsize_t	*src_dims,	const	hsize_t	*offset,	const	hsize_t	*count,	PyramidReducer	reducer,	std::vector<T>	&raw,	std::vector<T>	&tmp,	std::vector<double>	&acc,	std::vector<double>	&acc_tmp)
+{
+hsize_t	in_offset[H5S_MAX_RANK],	in_count[H5S_MAX_RANK];
+hsize_t	n	=	1;
+for	(int	d=0;	d<rank;	++d)
+{
+in_offset[d]	=	2	*	offset[d];
+in_count[d]	=	std::min(2	*	count[d],	src_dims[d]	-	in_offset[d]);
+n	*=	in_count[d];
+}
+if	(n	==	0)
+return;
+raw.resize(n);
+Dataspace	file_space	=	src.get_dataspace();
+file_space.select_hyperslab(in_offset,	NULL,	in_count,	NULL);
+src.read(Dataspace::simple(rank,	in_count),	file_space,	raw.data());
+if	(reducer	==	PYRAMID_MEAN)
+{
+//	in	double,	so	integers	neither	overflow	nor	get	rounded	at	every	step
+acc.assign(raw.begin(),	raw.end());
+for	(int	d=0;	d<rank;	++d)
+reduce_axis(acc,	acc_tmp,	rank,	in_count,	d,	reducer);
+raw.resize(acc.size());
+for	(size_t	i=0;	i<acc.size();	++i)
+raw[i]	=	round_to<T>(acc[i]);
+}
+else
+{
+for	(int	d=0;	d<rank;	++d)
+reduce_axis(raw,	tmp,	rank,	in_count,	d,	reducer);
 }
+Dataspace	out_space	=	dst.get_dataspace();
+out_space.select_hyperslab(offset,	NULL,	count,	NULL);
+dst.write(Dataspace::simple(rank,	count),	out_space,	raw.data());
+}
+
+}	//	namespace	internal
+
+
+/*
+Build	a	pyramid	of	successively	downsampled	copies	of	src	in	the	new	group
+parent/name.	Link	"0"	refers	to	src	itself,	level	k	(link	"k")	halves	the	size
+of	level	k-1	in	every	dimension,	up	to	a	level	which	fits	into	a	single	tile.
+Levels	are	chunked	in	tiles	of	tile	elements	per	dimension.	Each	level	is
+computed	from	the	previous	one,	tile	by	tile,	so	memory	use	is	bounded	by
+(2*tile)^rank	elements.
+*/
+template<class	T>
+inline	Group	build_pyramid(const	Dataset	&src,	Group	parent,	const	std::string	&name,	PyramidReducer	reducer	=	PYRAMID_MEAN,	hsize_t	tile	=	256,	DsCreationFlags	flags	=	CREATE_DS_DEFAULT)
+{
+static_assert(std::is_arithmetic<T>::value,	"pyramids	need	numeric	data");
+hsize_t	dims[H5S_MAX_RANK];
+const	int	rank	=	src.get_dataspace().get_dims(dims);
+if	(rank	<	1)
+throw	Exception("pyramids	need	a	dataset	of	rank	>=	1");
+if	(tile	<	1)
+throw	Exception("pyramid	tile	size	must	be	positive");
+Group	g	=	parent.create_group(name);
+herr_t	err;
+if	(src.get_file_name()	==	g.get_file_name())
+err	=	H5Lcreate_soft(src.get_name().c_str(),	g.get_id(),	"0",	H5P_DEFAULT,	H5P_DEFAULT);
+else
+err	=	H5Lcreate_external(src.get_file_name().c_str(),	src.get_name().c_str(),	g.get_id(),	"0",	H5P_DEFAULT,	H5P_DEFAULT);
+if	(err	<	0)
+throw	Exception("cannot	link	full	resolution	level	of	pyramid	"	+	name);
 
-Attributes	attrs()
+Dataset	prev	=	src;
+std::vector<T>	raw,	tmp;
+std::vector<double>	acc,	acc_tmp;
+int	levels	=	1;
+for	(;;)
 {
-return	Attributes(*this);
+bool	fits	=	true;
+for	(int	d=0;	d<rank;	++d)
+fits	=	fits	&&	dims[d]	<=	tile;
+if	(fits)
+break;
+hsize_t	src_dims[H5S_MAX_RANK],	tile_dims[H5S_MAX_RANK];
+std::copy(dims,	dims	+	rank,	src_dims);
+for	(int	d=0;	d<rank;	++d)
+{
+dims[d]	=	(dims[d]	+	1)	/	2;
+tile_dims[d]	=	std::min(tile,	dims[d]);
+}
+Dataspace	sp	=	Dataspace::simple(rank,	dims);
+Datatype	dtype	=	internal::apply_disktype_flags(get_disktype<T>(),	flags);
+Properties	dcpl	=	Dataset::create_creation_properties(sp,	DsCreationFlags(flags	&	~CREATE_DS_COMPACT_SMALL),	dtype);
+dcpl.chunked(rank,	tile_dims);
+std::ostringstream	level_name;
+level_name	<<	levels;
+Dataset	level	=	Dataset::create(g,	level_name.str(),	dtype,	sp,	dcpl);
+internal::ZoneGrid	grid(level,	tile_dims);
+hsize_t	offset[H5S_MAX_RANK],	count[H5S_MAX_RANK];
+for	(hsize_t	i=0;	i<grid.size;	++i)
+{
+grid.region(i,	offset,	count);
+internal::downsample_tile(prev,	level,	rank,	src_dims,	offset,	count,	reducer,	raw,	tmp,	acc,	acc_tmp);
+}
+prev	=	level;
+++levels;
+}
+g.attrs().set("levels",	levels);
+g.attrs().set("reducer",	(int)reducer);
+return	g;
 }
 
-Dataspace	get_dataspace()	const
+
+/*
+Reads	regions	of	a	pyramid	made	by	build_pyramid	at	the	coarsest	level	which
+still	provides	the	requested	output	resolution.
+*/
+class	Pyramid
 {
-hid_t	id	=	H5Dget_space(this->id);
-if	(id	<	0)
-throw	Exception("unable	to	get	dataspace	of	dataset");
-return	Dataspace(id,	internal::NoIncRC());
+Group	group;
+std::vector<Dataset>	levels;
+int	rank;
+public:
+explicit	Pyramid(Group	g)	:	group(g)
+{
+int	n	=	0;
+group.attrs().open("levels").read(&n);
+for	(int	i=0;	i<n;	++i)
+{
+std::ostringstream	name;
+name	<<	i;
+levels.push_back(group.open_dataset(name.str()));
+}
+if	(levels.empty())
+throw	Exception("pyramid	has	no	levels");
+rank	=	levels[0].get_dataspace().get_rank();
 }
 
-Datatype	get_datatype()	const
+size_t	num_levels()	const	{	return	levels.size();	}
+Dataset	level(size_t	i)	const	{	return	levels.at(i);	}
+
+/*
+Coarsest	level	at	which	a	region	of	count	elements	(at	full	resolution)	still
+has	at	least	out_dims	elements	in	each	dimension.
+*/
+size_t	choose_level(const	hsize_t	*count,	const	hsize_t	*out_dims)	const
 {
-hid_t	type_id	=	H5Dget_type(this->id);
-if	(type_id<0)
-throw	Exception("unable	to	get	type	of	Attribute");
-return	Datatype(type_id);
+for	(size_t	k=levels.size()-1;	k>0;	--k)
+{
+bool	enough	=	true;
+for	(int	d=0;	d<rank;	++d)
+enough	=	enough	&&	((count[d]	+	(hsize_t(1)	<<	k)	-	1)	>>	k)	>=	out_dims[d];
+if	(enough)
+return	k;
+}
+return	0;
 }
 
-template<class	T>
-void	read(T	*data)	const
+/*
+Read	the	region	at	offset	of	count	elements,	given	in	full	resolution
+coordinates,	from	the	level	chosen	for	out_dims.	ret_dims	receives	the
+dimensions	of	the	returned	block,	which	are	at	least	out_dims	unless	the
+region	is	smaller	than	that	at	full	resolution.
+*/
+template<class	T,	class	A>
+size_t	read_region(const	hsize_t	*offset,	const	hsize_t	*count,	const	hsize_t	*out_dims,	std::vector<T,	A>	&ret,	hsize_t	*ret_dims)	const
 {
-Dataspace	ds	=	get_dataspace();
-read(ds,	H5S_ALL,	data);
+size_t	k	=	choose_level(count,	out_dims);
+const	Dataset	&ds	=	levels[k];
+hsize_t	dims[H5S_MAX_RANK],	level_offset[H5S_MAX_RANK];
+ds.get_dataspace().get_dims(dims);
+hsize_t	n	=	1;
+for	(int	d=0;	d<rank;	++d)
+{
+level_offset[d]	=	std::min(offset[d]	>>	k,	dims[d]);
+hsize_t	end	=	std::min((offset[d]	+	count[d]	+	(hsize_t(1)	<<	k)	-	1)	>>	k,	dims[d]);
+ret_dims[d]	=	end	-	level_offset[d];
+n	*=	ret_dims[d];
+}
+ret.resize(n);
+if	(n	>	0)
+{
+Dataspace	file_space	=	ds.get_dataspace();
+file_space.select_hyperslab(level_offset,	NULL,	ret_dims,	NULL);
+ds.read(Dataspace::simple(rank,	ret_dims),	file_space,	ret.data());
+}
+return	k;
 }
 };
 
 
+/*--------------------------------------------------
+*	Repacking
+*	------------------------------------------------	*/
 
+namespace	internal
+{
 
+/*
+Apply	the	filters	to	a	raw	chunk,	the	inverse	of	decode_chunk.	Only	for	filters
+accepted	by	can_decode.	Runs	in	worker	threads,	so	it	must	not	call	into	the
+HDF5	library.
+*/
+inline	void	encode_chunk(const	std::vector<ChunkFilter>	&filters,	std::vector<unsigned	char>	&buf,	std::vector<unsigned	char>	&tmp)
+{
+for	(size_t	i=0;	i<filters.size();	++i)
+{
+const	ChunkFilter	&f	=	filters[i];
+if	(f.id	==	H5Z_FILTER_FLETCHER32)
+{
+uint32_t	sum	=	fletcher32(buf.data(),	buf.size());
+for	(int	b=0;	b<4;	++b)
+buf.push_back((unsigned	char)(sum	>>	(8	*	b)));
+}
+else	if	(f.id	==	H5Z_FILTER_SHUFFLE)
+{
+size_t	elem_size	=	f.cd_values.empty()	?	1	:	f.cd_values[0];
+tmp.resize(buf.size());
+shuffle(buf.data(),	tmp.data(),	buf.size(),	elem_size);
+buf.swap(tmp);
+}
+else	if	(f.id	==	HDF_WRAPPER_SHUFFLE_LZ_FILTER_ID)
+{
+std::vector<unsigned	char>	out;
+shuffle_lz_encode(buf.data(),	buf.size(),	f.cd_values.empty()	?	1	:	f.cd_values[0],	out,	tmp);
+buf.swap(out);
+}
+#ifdef	HDF_WRAPPER_HAS_ZLIB
+else	if	(f.id	==	H5Z_FILTER_DEFLATE)
+{
+int	level	=	f.cd_values.empty()	?	Z_DEFAULT_COMPRESSION	:	(int)f.cd_values[0];
+uLongf	n	=	compressBound(buf.size());
+tmp.resize(n);
+if	(compress2(tmp.data(),	&n,	buf.data(),	buf.size(),	level)	!=	Z_OK)
+throw	std::runtime_error("error	deflating	chunk");
+tmp.resize(n);
+buf.swap(tmp);
+}
+#endif
+else
+throw	std::runtime_error("unsupported	filter");
+}
+}
 
-inline	Dataset	Group::open_dataset(const	std::string	&name)
+//	copy	the	part	of	the	box	[offset,	offset+count)	which	lies	in	a	chunk	into	the	chunk,	the	inverse	of	scatter_chunk
+inline	void	gather_chunk(int	rank,	const	hsize_t	*chunk_offset,	const	hsize_t	*chunk_dims,	const	hsize_t	*offset,	const	hsize_t	*count,	size_t	elem_size,	const	unsigned	char	*src,	unsigned	char	*chunk)
+{
+hsize_t	lo[H5S_MAX_RANK],	hi[H5S_MAX_RANK],	idx[H5S_MAX_RANK];
+for	(int	d=0;	d<rank;	++d)
+{
+lo[d]	=	std::max(chunk_offset[d],	offset[d]);
+hi[d]	=	std::min(chunk_offset[d]	+	chunk_dims[d],	offset[d]	+	count[d]);
+if	(lo[d]	>=	hi[d])
+return;
+idx[d]	=	lo[d];
+}
+const	size_t	run	=	(hi[rank-1]	-	lo[rank-1])	*	elem_size;
+for	(;;)
+{
+hsize_t	src_pos	=	0,	dst	=	0;
+for	(int	d=0;	d<rank;	++d)
+{
+src_pos	=	src_pos	*	count[d]	+	(idx[d]	-	offset[d]);
+dst	=	dst	*	chunk_dims[d]	+	(idx[d]	-	chunk_offset[d]);
+}
+std::memcpy(chunk	+	dst	*	elem_size,	src	+	src_pos	*	elem_size,	run);
+int	d	=	rank	-	2;
+for	(;	d>=0;	--d)
 {
-return	Dataset(this->id,	name,	H5P_DEFAULT,	internal::TagOpen());
+if	(++idx[d]	<	hi[d])
+break;
+idx[d]	=	lo[d];
+}
+if	(d	<	0)
+break;
+}
 }
 
-#ifdef	HDF_WRAPPER_HAS_BOOST
-inline	boost::optional<Dataset>	Group::try_open_dataset(const	std::string	&name)
+/*
+Writes	the	box	[offset,	offset+count)	of	a	chunked	dataset,	which	must	consist
+of	whole	chunks	(or	reach	the	end	of	the	extent).	Worker	threads	cut	the	box
+into	chunks	and	apply	the	filters,	the	calling	thread	writes	the	results	with
+H5Dwrite_chunk	in	order.	Returns	false,	without	writing	anything,	if	the	dataset
+doesn't	qualify:	it	must	be	chunked	with	filters	which	encode_chunk	can	apply,
+and	its	type	must	equal	the	memory	type.	If	chunks	is	given,	only	the	chunks
+with	these	(row-major)	indices	within	the	box	are	written.
+*/
+inline	bool	write_chunks_parallel(const	Dataset	&ds,	const	Datatype	&memtype,	const	hsize_t	*offset,	const	hsize_t	*count,	const	void	*data,	int	num_threads,	const	std::vector<hsize_t>	*chunks	=	NULL)
+{
+#if	H5_VERSION_GE(1,	10,	3)
+Object	dcpl(H5Dget_create_plist(ds.get_id()));
+if	(H5Pget_layout(dcpl.get_id())	!=	H5D_CHUNKED)
+return	false;
+std::vector<ChunkFilter>	filters	=	get_filters(dcpl.get_id());
+if	(filters.empty()	||	!can_decode(filters))
+return	false;
+if	(!ds.get_datatype().is_equal(memtype)	||	H5Tdetect_class(memtype.get_id(),	H5T_VLEN)	!=	0	||	H5Tis_variable_str(memtype.get_id())	!=	0)
+return	false;
+hsize_t	chunk_dims[H5S_MAX_RANK],	dims[H5S_MAX_RANK];
+const	int	rank	=	H5Pget_chunk(dcpl.get_id(),	H5S_MAX_RANK,	chunk_dims);
+if	(rank	!=	ds.get_dataspace().get_dims(dims))
+throw	Exception("cannot	get	chunk	dimensions");
+const	size_t	elem_size	=	H5Tget_size(memtype.get_id());
+size_t	chunk_bytes	=	elem_size;
+hsize_t	grid[H5S_MAX_RANK],	first[H5S_MAX_RANK];
+hsize_t	num_chunks	=	1;
+for	(int	d=0;	d<rank;	++d)
+{
+if	(offset[d]	%	chunk_dims[d]	!=	0	||	((offset[d]	+	count[d])	%	chunk_dims[d]	!=	0	&&	offset[d]	+	count[d]	!=	dims[d]))
+return	false;
+chunk_bytes	*=	chunk_dims[d];
+first[d]	=	offset[d]	/	chunk_dims[d];
+grid[d]	=	(count[d]	+	chunk_dims[d]	-	1)	/	chunk_dims[d];
+num_chunks	*=	grid[d];
+}
+if	(chunks)
+num_chunks	=	chunks->size();
+if	(num_chunks	==	0)
+return	true;
+internal::invalidate_zone_map(ds.get_id());
+if	(num_threads	<=	0)
+num_threads	=	std::max(1u,	std::thread::hardware_concurrency());
+const	unsigned	char	*src	=	static_cast<const	unsigned	char*>(data);
+const	size_t	max_queued	=	2	*	num_threads;	//	bounds	the	memory	used	for	encoded	chunks
+
+std::vector<std::vector<unsigned	char>	>	encoded(max_queued);
+std::vector<bool>	ready(num_chunks,	false);
+std::mutex	mutex;
+std::condition_variable	cv_done,	cv_space;
+hsize_t	next	=	0,	written	=	0;
+bool	stop	=	false;
+std::string	error;
+
+auto	chunk_offset_of	=	[&](hsize_t	i,	hsize_t	*chunk_offset)
+{
+if	(chunks)
+i	=	(*chunks)[i];
+for	(int	d=rank-1;	d>=0;	--d)
+{
+chunk_offset[d]	=	(first[d]	+	i	%	grid[d])	*	chunk_dims[d];
+i	/=	grid[d];
+}
+};
+
+auto	work	=	[&]()
 {
-hid_t	id;
+std::vector<unsigned	char>	buf,	tmp;
+for	(;;)
 {
-AutoErrorReportingGuard	guard;
-guard.disableReporting();
-id	=	H5Dopen2(this->id,	name.c_str(),	H5P_DEFAULT);
+hsize_t	i;
+{
+std::unique_lock<std::mutex>	lock(mutex);
+cv_space.wait(lock,	[&]()	{	return	stop	||	next	>=	num_chunks	||	next	<	written	+	max_queued;	});
+if	(stop	||	next	>=	num_chunks)
+return;
+i	=	next++;
 }
-if	(id	<	0)
+try
 {
-if	(exists(name))	//	well	so	the	dataset	exists	but	for	some	reason	it	cannot	be	opened	->	error
-throw	Exception("unable	to	open	existing	item	as	dataset:	"+name);
-else
-return	boost::optional<Dataset>();	//	no	dataset	under	this	name
+hsize_t	chunk_offset[H5S_MAX_RANK];
+chunk_offset_of(i,	chunk_offset);
+buf.assign(chunk_bytes,	0);	//	edge	chunks	are	padded
+gather_chunk(rank,	chunk_offset,	chunk_dims,	offset,	count,	elem_size,	src,	buf.data());
+encode_chunk(filters,	buf,	tmp);
+std::lock_guard<std::mutex>	lock(mutex);
+encoded[i	%	max_queued].swap(buf);
+ready[i]	=	true;
 }
-else	return	boost::optional<Dataset>(Dataset(id,	internal::NoIncRC()));
+catch	(const	std::exception	&e)
+{
+std::lock_guard<std::mutex>	lock(mutex);
+if	(error.empty())
+error	=	e.what();
+stop	=	true;
+}
+cv_done.notify_all();
+}
+};
+
+std::vector<std::thread>	workers;
+try
+{
+for	(int	i=0;	i<num_threads;	++i)
+workers.push_back(std::thread(work));
+std::vector<unsigned	char>	buf;
+for	(hsize_t	i=0;	i<num_chunks;	++i)
+{
+{
+std::unique_lock<std::mutex>	lock(mutex);
+cv_done.wait(lock,	[&]()	{	return	ready[i]	||	stop;	});
+if	(stop)
+break;
+buf.swap(encoded[i	%	max_queued]);
+++written;
+}
+cv_space.notify_all();
+hsize_t	chunk_offset[H5S_MAX_RANK];
+chunk_offset_of(i,	chunk_offset);
+if	(H5Dwrite_chunk(ds.get_id(),	H5P_DEFAULT,	0,	chunk_offset,	buf.size(),	buf.data())	<	0)
+throw	Exception("cannot	write	chunk");
+}
+}
+catch	(...)
+{
+{
+std::lock_guard<std::mutex>	lock(mutex);
+stop	=	true;
+}
+cv_space.notify_all();
+for	(size_t	i=0;	i<workers.size();	++i)
+workers[i].join();
+throw;
+}
+{
+std::lock_guard<std::mutex>	lock(mutex);
+stop	=	true;
 }
+cv_space.notify_all();
+for	(size_t	i=0;	i<workers.size();	++i)
+workers[i].join();
+if	(!error.empty())
+throw	Exception("error	encoding	chunks:	"	+	error);
+return	true;
+#else
+return	false;
 #endif
+}
+
+}	//	namespace	internal
+
+
+//	reported	by	repack	after	each	block	of	data
+struct	RepackProgress
+{
+std::string	path;	//	of	the	dataset	being	copied
+uint64_t	bytes_done,	bytes_total;	//	of	that	dataset,	uncompressed
+uint64_t	total_bytes_done;	//	of	all	datasets	so	far
+unsigned	datasets_done;
+double	seconds;	//	since	the	start
+
+RepackProgress()	:	bytes_done(0),	bytes_total(0),	total_bytes_done(0),	datasets_done(0),	seconds(0.)	{}
+
+//	bytes	per	second
+double	throughput()	const	{	return	seconds	>	0	?	total_bytes_done	/	seconds	:	0.;	}
+};
+
+struct	RepackOptions
+{
+/*
+Called	for	each	dataset	with	its	path	and	a	copy	of	its	creation	properties.
+Returning	true	rewrites	the	dataset	with	the	modified	properties;	returning
+false,	or	no	function	at	all,	copies	it	unchanged	with	H5Ocopy.
+*/
+std::function<bool(const	std::string	&path,	const	Dataset	&ds,	Properties	&dcpl)>	relayout;
+std::function<void(const	RepackProgress	&)>	progress;
+int	num_threads;	//	for	decoding	and	encoding	chunks,	0	=	number	of	cores
+size_t	buffer_bytes;	//	approximate	size	of	the	blocks	streamed	through	memory
+bool	set_libver;	//	use	libver_low	and	libver_high	for	the	new	file
+H5F_libver_t	libver_low,	libver_high;
 
+RepackOptions()	:	num_threads(0),	buffer_bytes(64	<<	20),	set_libver(false),	libver_low(H5F_LIBVER_EARLIEST),	libver_high(H5F_LIBVER_LATEST)	{}
 
+//	rewrite	every	non-scalar	dataset	with	the	creation	properties	of	flags,	e.g.	to	recompress	or	rechunk
+static	RepackOptions	with_flags(DsCreationFlags	flags)
+{
+RepackOptions	o;
+o.relayout	=	[flags](const	std::string	&,	const	Dataset	&ds,	Properties	&dcpl)
+{
+Dataspace	sp	=	ds.get_dataspace();
+hsize_t	dims[H5S_MAX_RANK],	maxdims[H5S_MAX_RANK];
+int	rank	=	H5Sget_simple_extent_dims(sp.get_id(),	dims,	maxdims);
+if	(rank	<	1)
+return	false;
+DsCreationFlags	f	=	flags;
+if	(!std::equal(dims,	dims	+	rank,	maxdims))	//	extendible	datasets	must	stay	chunked
+f	=	DsCreationFlags(f	|	CREATE_DS_CHUNKED);
+dcpl	=	Dataset::create_creation_properties(sp,	f,	ds.get_datatype());
+return	true;
+};
+return	o;
+}
+};
 
 
 namespace	internal
 {
 
-/*	This	section	deals	with	creation	of	Datatype	objects	for	basic	data	types.
-Copy	is	used	on	HDF	API	constants	like	"H5T_NATIVE_INT"	because	Datatype
-object	cannot	handle	these	constants.	This	is	because	H5T_NATIVE_INT,	etc.
-are	apparently	not	real	objects,	i.e.	H5O_isvalid	indicates	false.	Some	special
-case	handling	for	these	constants	might	be	needed	instead.
+inline	hsize_t	lcm(hsize_t	a,	hsize_t	b)
+{
+hsize_t	x	=	a,	y	=	b;
+while	(y)
+{
+hsize_t	t	=	x	%	y;
+x	=	y;
+y	=	t;
+}
+return	a	/	x	*	b;
+}
+
+inline	hsize_t	chunk_rows(const	Dataset	&ds)
+{
+Object	dcpl(H5Dget_create_plist(ds.get_id()));
+hsize_t	chunk_dims[H5S_MAX_RANK];
+if	(H5Pget_layout(dcpl.get_id())	==	H5D_CHUNKED	&&	H5Pget_chunk(dcpl.get_id(),	H5S_MAX_RANK,	chunk_dims)	>	0)
+return	chunk_dims[0];
+return	1;
+}
+
+class	Repacker
+{
+typedef	std::chrono::steady_clock	Clock;
+const	RepackOptions	&options;
+Clock::time_point	start;
+
+void	report()
+{
+progress.seconds	=	std::chrono::duration<double>(Clock::now()	-	start).count();
+if	(options.progress)
+options.progress(progress);
+}
+
+public:
+RepackProgress	progress;
+
+explicit	Repacker(const	RepackOptions	&options_)	:	options(options_),	start(Clock::now())	{}
+
+//	attributes	are	copied	with	their	file	types,	so	no	conversion	happens
+void	copy_attributes(const	Object	&src,	const	Object	&dst)
+{
+hsize_t	n	=	Attributes(src).size();
+for	(hsize_t	i=0;	i<n;	++i)
+{
+Object	a(H5Aopen_by_idx(src.get_id(),	".",	H5_INDEX_NAME,	H5_ITER_INC,	i,	H5P_DEFAULT,	H5P_DEFAULT));
+ssize_t	l	=	H5Aget_name(a.get_id(),	0,	NULL);
+if	(l	<	0)
+throw	Exception("cannot	get	attribute	name");
+std::string	name(l,	0);
+H5Aget_name(a.get_id(),	l+1,	&name[0]);
+Datatype	type(H5Aget_type(a.get_id()));
+Object	space(H5Aget_space(a.get_id()));
+hssize_t	npoints	=	H5Sget_simple_extent_npoints(space.get_id());
+std::vector<unsigned	char>	buf(std::max<hssize_t>(npoints,	1)	*	type.get_size());
+if	(H5Aread(a.get_id(),	type.get_id(),	buf.data())	<	0)
+throw	Exception("cannot	read	attribute	"	+	name);
+Object	b(H5Acreate2(dst.get_id(),	name.c_str(),	type.get_id(),	space.get_id(),	H5P_DEFAULT,	H5P_DEFAULT));
+herr_t	err	=	H5Awrite(b.get_id(),	type.get_id(),	buf.data());
+if	(H5Tdetect_class(type.get_id(),	H5T_VLEN)	>	0	||	H5Tis_variable_str(type.get_id())	>	0)
+H5Dvlen_reclaim(type.get_id(),	space.get_id(),	H5P_DEFAULT,	buf.data());
+if	(err	<	0)
+throw	Exception("cannot	write	attribute	"	+	name);
+}
+}
+
+//	copy	the	data,	in	blocks	of	whole	chunks	of	both	datasets	along	the	first	dimension,	so	each	chunk	is	decoded	and	encoded	once
+void	stream(const	Dataset	&src,	const	Dataset	&dst,	const	std::string	&path)
+{
+Datatype	type	=	src.get_datatype();
+const	bool	vlen	=	H5Tdetect_class(type.get_id(),	H5T_VLEN)	>	0	||	H5Tis_variable_str(type.get_id())	>	0;
+Dataspace	sp	=	src.get_dataspace();
+hsize_t	dims[H5S_MAX_RANK];
+const	int	rank	=	sp.get_dims(dims);
+hssize_t	npoints	=	H5Sget_simple_extent_npoints(sp.get_id());
+progress.path	=	path;
+progress.bytes_done	=	0;
+progress.bytes_total	=	npoints	*	type.get_size();
+if	(npoints	<=	0)
+return;
+if	(rank	==	0)
+{
+std::vector<unsigned	char>	buf(type.get_size());
+if	(H5Dread(src.get_id(),	type.get_id(),	H5S_ALL,	H5S_ALL,	H5P_DEFAULT,	buf.data())	<	0	||	H5Dwrite(dst.get_id(),	type.get_id(),	H5S_ALL,	H5S_ALL,	H5P_DEFAULT,	buf.data())	<	0)
+throw	Exception("cannot	copy	dataset	"	+	path);
+if	(vlen)
+H5Dvlen_reclaim(type.get_id(),	sp.get_id(),	H5P_DEFAULT,	buf.data());
+}
+else
+{
+const	size_t	row_bytes	=	progress.bytes_total	/	dims[0];
+hsize_t	step	=	lcm(chunk_rows(src),	chunk_rows(dst));
+//	chunk	sizes	without	common	factors	can	make	that	huge;	then	the	blocks	follow	the	chunks	of	dst,	and	chunks	of	src	across	block	boundaries	are	decoded	twice
+if	(step	*	row_bytes	>	options.buffer_bytes)
+step	=	chunk_rows(dst);
+const	hsize_t	rows	=	std::max<hsize_t>(1,	options.buffer_bytes	/	std::max<size_t>(1,	row_bytes)	/	step)	*	step;
+std::vector<unsigned	char>	buf;
+hsize_t	offset[H5S_MAX_RANK]	=	{	0	},	count[H5S_MAX_RANK];
+std::copy(dims,	dims	+	rank,	count);
+for	(hsize_t	r=0;	r<dims[0];	r+=rows)
+{
+offset[0]	=	r;
+count[0]	=	std::min(rows,	dims[0]	-	r);
+buf.resize(count[0]	*	row_bytes);
+Dataspace	mem_space	=	Dataspace::simple(rank,	count);
+Dataspace	file_space	=	src.get_dataspace();
+file_space.select_hyperslab(offset,	NULL,	count,	NULL);
+if	(!read_chunks_parallel(src,	type,	offset,	count,	buf.data(),	options.num_threads)
+&&	H5Dread(src.get_id(),	type.get_id(),	mem_space.get_id(),	file_space.get_id(),	H5P_DEFAULT,	buf.data())	<	0)
+throw	Exception("cannot	read	dataset	"	+	path);
+if	(!write_chunks_parallel(dst,	type,	offset,	count,	buf.data(),	options.num_threads)
+&&	H5Dwrite(dst.get_id(),	type.get_id(),	mem_space.get_id(),	file_space.get_id(),	H5P_DEFAULT,	buf.data())	<	0)
+throw	Exception("cannot	write	dataset	"	+	path);
+if	(vlen)
+H5Dvlen_reclaim(type.get_id(),	mem_space.get_id(),	H5P_DEFAULT,	buf.data());
+progress.bytes_done	+=	buf.size();
+progress.total_bytes_done	+=	buf.size();
+report();
+}
+}
+}
+
+void	copy_dataset(Group	src,	Group	dst,	const	std::string	&name,	const	std::string	&path)
+{
+Dataset	ds	=	src.open_dataset(name);
+Properties	dcpl	=	ds.get_creation_properties();
+if	(options.relayout	&&	options.relayout(path,	ds,	dcpl))
+{
+Dataset	out	=	Dataset::create(dst,	name,	ds.get_datatype(),	ds.get_dataspace(),	dcpl);
+copy_attributes(ds,	out);
+stream(ds,	out,	path);
+}
+else
+{
+if	(H5Ocopy(src.get_id(),	name.c_str(),	dst.get_id(),	name.c_str(),	H5P_DEFAULT,	H5P_DEFAULT)	<	0)
+throw	Exception("cannot	copy	dataset	"	+	path);
+progress.path	=	path;
+hssize_t	npoints	=	H5Sget_simple_extent_npoints(ds.get_dataspace().get_id());
+progress.bytes_total	=	progress.bytes_done	=	std::max<hssize_t>(npoints,	0)	*	ds.get_datatype().get_size();	//	uncompressed,	as	for	streamed	datasets
+progress.total_bytes_done	+=	progress.bytes_done;
+}
+++progress.datasets_done;
+report();
+}
+
+//	copy	the	links	of	src	into	dst;	objects	reachable	through	several	hard	links	are	copied	once	per	link
+void	copy_group(Group	src,	Group	dst,	const	std::string	&path)
+{
+hsize_t	n	=	src.size();
+for	(hsize_t	i=0;	i<n;	++i)
+{
+std::string	name	=	src.get_link_name(i);
+std::string	child	=	path	+	"/"	+	name;
+H5L_info_t	info;
+if	(H5Lget_info(src.get_id(),	name.c_str(),	&info,	H5P_DEFAULT)	<	0)
+throw	Exception("cannot	get	link	info	of	"	+	child);
+if	(info.type	==	H5L_TYPE_SOFT	||	info.type	==	H5L_TYPE_EXTERNAL)
+{
+std::vector<char>	val(info.u.val_size	+	1,	0);
+if	(H5Lget_val(src.get_id(),	name.c_str(),	val.data(),	val.size(),	H5P_DEFAULT)	<	0)
+throw	Exception("cannot	get	link	value	of	"	+	child);
+herr_t	err;
+if	(info.type	==	H5L_TYPE_SOFT)
+err	=	H5Lcreate_soft(val.data(),	dst.get_id(),	name.c_str(),	H5P_DEFAULT,	H5P_DEFAULT);
+else
+{
+unsigned	flags;
+const	char	*file,	*obj;
+if	(H5Lunpack_elink_val(val.data(),	info.u.val_size,	&flags,	&file,	&obj)	<	0)
+throw	Exception("cannot	unpack	external	link	"	+	child);
+err	=	H5Lcreate_external(file,	obj,	dst.get_id(),	name.c_str(),	H5P_DEFAULT,	H5P_DEFAULT);
+}
+if	(err	<	0)
+throw	Exception("cannot	create	link	"	+	child);
+continue;
+}
+Object	obj(H5Oopen(src.get_id(),	name.c_str(),	H5P_DEFAULT));
+H5I_type_t	type	=	H5Iget_type(obj.get_id());
+if	(type	==	H5I_GROUP)
+{
+Group	g	=	dst.create_group(name);
+copy_attributes(obj,	g);
+copy_group(src.open_group(name),	g,	child);
+}
+else	if	(type	==	H5I_DATASET)
+copy_dataset(src,	dst,	name,	child);
+else	if	(H5Ocopy(src.get_id(),	name.c_str(),	dst.get_id(),	name.c_str(),	H5P_DEFAULT,	H5P_DEFAULT)	<	0)
+throw	Exception("cannot	copy	object	"	+	child);
+}
+}
+};
+
+}	//	namespace	internal
+
+
+/*
+Copy	the	group	src_path	of	file	src_name,	with	its	attributes	and	everything
+below	it,	into	the	root	of	the	new	file	dst_name.	Datasets	for	which
+options.relayout	returns	true	are	rewritten	with	new	creation	properties,
+streaming	blocks	of	whole	chunks	through	memory;	chunks	are	decoded	and	encoded
+in	parallel	where	the	filters	allow	it	(see	read_chunks_parallel).	All	other
+objects	are	copied	with	H5Ocopy.	Returns	the	final	progress.
 */
-template<class	T>
-inline	Datatype	get_memtype()
+inline	RepackProgress	repack(const	std::string	&src_name,	const	std::string	&dst_name,	const	RepackOptions	&options	=	RepackOptions(),	const	std::string	&src_path	=	"/")
 {
-//	writing	sizeof(T)==0	seems	to	work	for	gcc.	just	writing	false	always	causes	an	error????!
-static_assert	(sizeof(T)==0,	"specialize	me!");
-return	Datatype();
+File	src(src_name,	"r");
+Properties	fapl(H5P_FILE_ACCESS);
+if	(options.set_libver)
+fapl.libver_bounds(options.libver_low,	options.libver_high);
+File	dst(dst_name,	"w",	fapl);
+Group	from	=	src.root().open_group(src_path);
+Group	to	=	dst.root();
+internal::Repacker	repacker(options);
+repacker.copy_attributes(from,	to);
+repacker.copy_group(from,	to,	src_path	==	"/"	?	""	:	src_path);
+return	repacker.progress;
 }
 
-template<class	T>
-inline	Datatype	get_disktype()
+
+/*--------------------------------------------------
+*	Incremental	checkpoints
+*	------------------------------------------------	*/
+
+namespace	internal
 {
-static_assert	(sizeof(T)==0,	"specialize	me!");
-return	Datatype();
+
+//	keys	of	chunk_hash:	stripe	i	of	a	KiB	uses	the	8	starting	at	i,	the	last	8	are	for	scrambling
+enum	{	CHUNK_HASH_SCRAMBLE_KEYS	=	24	};
+
+inline	const	uint64_t	*chunk_hash_keys()
+{
+static	const	uint64_t	keys[32]	=	{
+0xbe4ba423396cfeb9ull,	0x1cad21f72c81017dull,	0xdb979083e96dd4dfull,	0x1f67b3b7a4a44073ull,
+0x78e5c0cc4ee679cbull,	0x2172ffcc7dd05a83ull,	0x8e2443f7744608b9ull,	0x4c263a81e69035e1ull,
+0xcb00c391bb52283dull,	0xa32e531b8b65d089ull,	0x4ef90da297486471ull,	0xd8acdea946ef1939ull,
+0x3f349ce33f76faa9ull,	0x1d4f0bc7c7bbdcf9ull,	0x3159b4cd4be0518bull,	0x647378d9c97e9fc9ull,
+0x1ac046dda8e86e2aull,	0xbe2c3b00b1d348c8ull,	0x9b1a66a95412ff75ull,	0xc448c2b1f05f7e4cull,
+0xc111ca6b8f6e73c4ull,	0xb54861920d05b01dull,	0x8d61500f4a7bbe16ull,	0x5e0c25471f89e02eull,
+0x48105a3d28f0e221ull,	0x2169f8846b637746ull,	0x3d628782e0c0d863ull,	0xa5ddb2216078aa40ull,
+0xc8119d17f0571101ull,	0x98e2e2eb8f33280full,	0x8cd1e28860679cc4ull,	0x9dca6189c923aef3ull	};
+return	keys;
 }
 
+inline	void	hash_stripe(uint64_t	*acc,	const	unsigned	char	*p,	const	uint64_t	*keys)
+{
+uint64_t	w[8];
+std::memcpy(w,	p,	sizeof(w));
+for	(int	j=0;	j<8;	++j)
+{
+uint64_t	k	=	w[j]	^	keys[j];
+acc[j]	+=	(k	&	0xffffffffu)	*	(k	>>	32)	+	w[j	^	1];
+}
+}
 
-#define	HDF5_WRAPPER_SPECIALIZE_TYPE(T,	tid,	dtid)	\
-template<>	inline	Datatype	get_memtype<T>()	\
-{	\
-return	Datatype::copy(tid);	\
-}	\
-template<>	inline	Datatype	get_disktype<T>()	\
-{	\
-return	Datatype::copy(dtid);	\
+inline	void	hash_scramble(uint64_t	*acc,	const	uint64_t	*keys)
+{
+for	(int	j=0;	j<8;	++j)
+acc[j]	=	(acc[j]	^	(acc[j]	>>	47)	^	keys[CHUNK_HASH_SCRAMBLE_KEYS	+	j])	*	0x9e3779b1u;
 }
 
+#ifdef	HDF_WRAPPER_X86_SIMD
 
-HDF5_WRAPPER_SPECIALIZE_TYPE(int,	H5T_NATIVE_INT,	H5T_STD_I32LE)
-HDF5_WRAPPER_SPECIALIZE_TYPE(unsigned	int,	H5T_NATIVE_UINT,	H5T_STD_U32LE)
-HDF5_WRAPPER_SPECIALIZE_TYPE(unsigned	long	long,	H5T_NATIVE_ULLONG,	H5T_STD_U64LE)
-HDF5_WRAPPER_SPECIALIZE_TYPE(long	long,	H5T_NATIVE_LLONG,	H5T_STD_I64LE)
-HDF5_WRAPPER_SPECIALIZE_TYPE(char,	H5T_NATIVE_CHAR,	H5T_STD_I8LE)
-HDF5_WRAPPER_SPECIALIZE_TYPE(unsigned	char,	H5T_NATIVE_UCHAR,	H5T_STD_U8LE)
-HDF5_WRAPPER_SPECIALIZE_TYPE(float,	H5T_NATIVE_FLOAT,	H5T_IEEE_F32LE)
-HDF5_WRAPPER_SPECIALIZE_TYPE(double,	H5T_NATIVE_DOUBLE,	H5T_IEEE_F64LE)
-HDF5_WRAPPER_SPECIALIZE_TYPE(bool,	H5T_NATIVE_CHAR,	H5T_STD_U8LE)
-HDF5_WRAPPER_SPECIALIZE_TYPE(unsigned	long,	H5T_NATIVE_ULONG,	H5T_STD_U64LE)
-HDF5_WRAPPER_SPECIALIZE_TYPE(long,	H5T_NATIVE_LONG,	H5T_STD_I64LE)
+//	64	bit	multiplication	by	a	32	bit	constant
+__attribute__((target("avx2")))
+inline	__m256i	mul_u32_avx2(__m256i	x,	__m256i	c)
+{
+return	_mm256_add_epi64(_mm256_mul_epu32(x,	c),	_mm256_slli_epi64(_mm256_mul_epu32(_mm256_srli_epi64(x,	32),	c),	32));
+}
+
+//	blocks	of	16	stripes	of	64	bytes,	the	same	as	hash_stripe	and	hash_scramble
+__attribute__((target("avx2")))
+inline	void	hash_blocks_avx2(uint64_t	*acc,	const	unsigned	char	*p,	size_t	blocks,	const	uint64_t	*keys)
+{
+const	__m256i	prime	=	_mm256_set1_epi64x(0x9e3779b1);
+__m256i	a[2],	s[2];
+for	(int	h=0;	h<2;	++h)
+{
+a[h]	=	_mm256_loadu_si256(reinterpret_cast<const	__m256i*>(acc	+	4	*	h));
+s[h]	=	_mm256_loadu_si256(reinterpret_cast<const	__m256i*>(keys	+	CHUNK_HASH_SCRAMBLE_KEYS	+	4	*	h));
+}
+for	(size_t	b=0;	b<blocks;	++b)
+{
+for	(int	i=0;	i<16;	++i,	p+=64)
+for	(int	h=0;	h<2;	++h)
+{
+__m256i	w	=	_mm256_loadu_si256(reinterpret_cast<const	__m256i*>(p	+	32	*	h));
+__m256i	x	=	_mm256_xor_si256(w,	_mm256_loadu_si256(reinterpret_cast<const	__m256i*>(keys	+	i	+	4	*	h)));
+a[h]	=	_mm256_add_epi64(a[h],	_mm256_add_epi64(_mm256_mul_epu32(x,	_mm256_srli_epi64(x,	32)),	_mm256_shuffle_epi32(w,	0x4e)));
+}
+for	(int	h=0;	h<2;	++h)
+a[h]	=	mul_u32_avx2(_mm256_xor_si256(_mm256_xor_si256(a[h],	_mm256_srli_epi64(a[h],	47)),	s[h]),	prime);
+}
+for	(int	h=0;	h<2;	++h)
+_mm256_storeu_si256(reinterpret_cast<__m256i*>(acc	+	4	*	h),	a[h]);
+}
+
+__attribute__((target("avx512f")))
+inline	void	hash_blocks_avx512(uint64_t	*acc,	const	unsigned	char	*p,	size_t	blocks,	const	uint64_t	*keys)
+{
+const	__m512i	prime	=	_mm512_set1_epi64(0x9e3779b1);
+const	__m512i	s	=	_mm512_loadu_si512(keys	+	CHUNK_HASH_SCRAMBLE_KEYS);
+__m512i	a	=	_mm512_loadu_si512(acc);
+for	(size_t	b=0;	b<blocks;	++b)
+{
+for	(int	i=0;	i<16;	++i,	p+=64)
+{
+__m512i	w	=	_mm512_loadu_si512(p);
+__m512i	x	=	_mm512_xor_si512(w,	_mm512_loadu_si512(keys	+	i));
+a	=	_mm512_add_epi64(a,	_mm512_add_epi64(_mm512_mul_epu32(x,	_mm512_srli_epi64(x,	32)),	_mm512_shuffle_epi32(w,	_MM_PERM_BADC)));
+}
+__m512i	x	=	_mm512_xor_si512(_mm512_xor_si512(a,	_mm512_srli_epi64(a,	47)),	s);
+a	=	_mm512_add_epi64(_mm512_mul_epu32(x,	prime),	_mm512_slli_epi64(_mm512_mul_epu32(_mm512_srli_epi64(x,	32),	prime),	32));
+}
+_mm512_storeu_si512(acc,	a);
+}
+
+#endif
+
+/*
+Fast	64	bit	hash	for	detecting	changed	chunks,	not	a	cryptographic	one.	Eight
+lanes	take	every	eighth	64	bit	word:	the	product	of	the	halves	of	the	word
+xored	with	a	key,	plus	the	neighboring	word,	is	added	to	the	lane,	and	the
+lanes	are	scrambled	after	every	KiB.	As	in	XXH3,	each	64	byte	stripe	of	a
+KiB	has	its	own	keys,	so	swapping	stripes	changes	the	hash.	The	SIMD	versions	give	the	same	results,
+so	hashes	stored	on	one	machine	remain	valid	on	another	(of	the	same	byte	order).
+*/
+inline	uint64_t	chunk_hash(const	unsigned	char	*p,	size_t	len)
+{
+const	uint64_t	*keys	=	chunk_hash_keys();
+uint64_t	acc[8];
+std::copy(keys,	keys	+	8,	acc);
+const	size_t	blocks	=	len	/	1024;
+size_t	b	=	0;
+#ifdef	HDF_WRAPPER_X86_SIMD
+if	(cpu_has_avx512f())
+{
+hash_blocks_avx512(acc,	p,	blocks,	keys);
+b	=	blocks;
+}
+else	if	(cpu_has_avx2())
+{
+hash_blocks_avx2(acc,	p,	blocks,	keys);
+b	=	blocks;
+}
+#endif
+for	(;	b<blocks;	++b)
+{
+for	(int	i=0;	i<16;	++i)
+hash_stripe(acc,	p	+	1024	*	b	+	64	*	i,	keys	+	i);
+hash_scramble(acc,	keys);
+}
+size_t	pos	=	1024	*	blocks;
+int	i	=	0;
+for	(;	pos+64<=len;	pos+=64,	++i)
+hash_stripe(acc,	p	+	pos,	keys	+	i);
+if	(pos	<	len)
+{
+unsigned	char	last[64]	=	{	0	};
+std::memcpy(last,	p	+	pos,	len	-	pos);
+hash_stripe(acc,	last,	keys	+	i);
+}
+uint64_t	h	=	len	*	0x9e3779b185ebca87ull;
+for	(int	j=0;	j<8;	++j)
+{
+h	^=	acc[j]	*	0xc2b2ae3d27d4eb4full;
+h	=	((h	<<	27)	|	(h	>>	37))	*	0x9e3779b185ebca87ull	+	0x85ebca77c2b2ae63ull;
+}
+h	^=	h	>>	33;
+h	*=	0xc2b2ae3d27d4eb4full;
+h	^=	h	>>	29;
+h	*=	0x165667b19e3779f9ull;
+h	^=	h	>>	32;
+return	h;
+}
 
+//	chunk_hash	of	the	contents	of	every	zone	of	data,	which	has	the	extent	of	grid
+inline	void	hash_zones(const	ZoneGrid	&grid,	size_t	elem_size,	const	unsigned	char	*data,	uint64_t	*hashes,	int	num_threads)
+{
+if	(grid.size	==	0)
+return;
+if	(num_threads	<=	0)
+num_threads	=	std::max(1u,	std::thread::hardware_concurrency());
+num_threads	=	int(std::min<hsize_t>(num_threads,	grid.size));
+std::string	error;
+std::mutex	mutex;
 
-template<>	inline	Datatype	get_memtype<const	char	*>()
+auto	work	=	[&](hsize_t	first,	hsize_t	last)
 {
-Datatype	dt	=	Datatype::copy(H5T_C_S1);
-dt.set_variable_size();
-return	dt;
+try
+{
+std::vector<unsigned	char>	buf;
+hsize_t	offset[H5S_MAX_RANK],	count[H5S_MAX_RANK];
+for	(hsize_t	i=first;	i<last;	++i)
+{
+grid.region(i,	offset,	count);
+const	size_t	bytes	=	grid.elements(count)	*	elem_size;
+//	zones	spanning	whole	rows	are	contiguous	in	memory
+int	d	=	grid.rank	-	1;
+while	(d	>	0	&&	count[d]	==	grid.dims[d])
+--d;
+bool	contiguous	=	true;
+for	(int	e=0;	e<d;	++e)
+contiguous	=	contiguous	&&	count[e]	==	1;
+hsize_t	start	=	0;
+for	(int	e=0;	e<grid.rank;	++e)
+start	=	start	*	grid.dims[e]	+	offset[e];
+if	(contiguous)
+{
+hashes[i]	=	chunk_hash(data	+	start	*	elem_size,	bytes);
+continue;
 }
-template<>	inline	Datatype	get_disktype<const	char	*>()
+buf.resize(bytes);
+grid.for_each_run(offset,	count,	[&](hsize_t	global,	hsize_t	local,	hsize_t	n)
 {
-return	get_memtype<const	char*>();
+std::memcpy(buf.data()	+	local	*	elem_size,	data	+	global	*	elem_size,	n	*	elem_size);
+});
+hashes[i]	=	chunk_hash(buf.data(),	bytes);
 }
-
-template<>	inline	Datatype	get_memtype<char*>()
+}
+catch	(const	std::exception	&e)
 {
-return	get_memtype<const	char*>();
+std::lock_guard<std::mutex>	lock(mutex);
+if	(error.empty())
+error	=	e.what();
 }
+};
 
-template<>	inline	Datatype	get_disktype<char	*>()
-{
-return	get_memtype<char*>();
+std::vector<std::thread>	workers;
+for	(int	t=1;	t<num_threads;	++t)
+workers.push_back(std::thread(work,	grid.size	*	t	/	num_threads,	grid.size	*	(t	+	1)	/	num_threads));
+work(0,	grid.size	/	num_threads);
+for	(size_t	t=0;	t<workers.size();	++t)
+workers[t].join();
+if	(!error.empty())
+throw	Exception("error	hashing	chunks:	"	+	error);
+}
+
+//	calls	f(offset,	count)	for	boxes	covering	the	zones	with	the	given	sorted	indices,	merging	neighbors	along	the	last	dimension
+template<class	F>
+inline	void	for_each_zone_box(const	ZoneGrid	&grid,	const	std::vector<hsize_t>	&zones,	F	f)
+{
+hsize_t	offset[H5S_MAX_RANK],	count[H5S_MAX_RANK],	last_offset[H5S_MAX_RANK],	last_count[H5S_MAX_RANK];
+const	int	r	=	grid.rank	-	1;
+for	(size_t	k=0;	k<zones.size();)
+{
+size_t	e	=	k	+	1;
+while	(e	<	zones.size()	&&	zones[e]	==	zones[e-1]	+	1	&&	zones[e]	/	grid.grid[r]	==	zones[k]	/	grid.grid[r])
+++e;
+grid.region(zones[k],	offset,	count);
+grid.region(zones[e-1],	last_offset,	last_count);
+count[r]	=	last_offset[r]	+	last_count[r]	-	offset[r];
+f(offset,	count);
+k	=	e;
+}
+}
+
+//	copies	chunks	between	datasets	with	the	same	type	and	creation	properties,	without	decoding	them	if	possible
+inline	void	copy_chunks(const	Dataset	&from,	const	Dataset	&to,	const	ZoneGrid	&grid,	const	std::vector<hsize_t>	&chunks)
+{
+hsize_t	offset[H5S_MAX_RANK],	count[H5S_MAX_RANK];
+std::vector<unsigned	char>	buf;
+invalidate_zone_map(to.get_id());
+#if	H5_VERSION_GE(1,	10,	3)
+for	(size_t	k=0;	k<chunks.size();	++k)
+{
+grid.region(chunks[k],	offset,	count);
+hsize_t	size	=	0;
+if	(H5Dget_chunk_storage_size(from.get_id(),	offset,	&size)	<	0)
+throw	Exception("cannot	get	chunk	size");
+if	(size	==	0)
+continue;
+buf.resize(size);
+uint32_t	mask	=	0;
+if	(H5Dread_chunk(from.get_id(),	H5P_DEFAULT,	offset,	&mask,	buf.data())	<	0)
+throw	Exception("cannot	read	chunk");
+if	(H5Dwrite_chunk(to.get_id(),	H5P_DEFAULT,	mask,	offset,	size,	buf.data())	<	0)
+throw	Exception("cannot	write	chunk");
+}
+#else
+Datatype	dtype	=	from.get_datatype();
+for	(size_t	k=0;	k<chunks.size();	++k)
+{
+grid.region(chunks[k],	offset,	count);
+buf.resize(grid.elements(count)	*	dtype.get_size());
+Dataspace	fs	=	from.get_dataspace();
+fs.select_hyperslab(offset,	NULL,	count,	NULL);
+Dataspace	ms	=	Dataspace::simple(grid.rank,	count);
+if	(H5Dread(from.get_id(),	dtype.get_id(),	ms.get_id(),	fs.get_id(),	H5P_DEFAULT,	buf.data())	<	0	||
+H5Dwrite(to.get_id(),	dtype.get_id(),	ms.get_id(),	fs.get_id(),	H5P_DEFAULT,	buf.data())	<	0)
+throw	Exception("cannot	copy	chunk");
+}
+#endif
 }
 
 }	//	namespace	internal
 
 
+//	reported	by	IncrementalCheckpoint::write
+struct	CheckpointStats
+{
+int	generation;
+hsize_t	num_chunks,	dirty_chunks;
+uint64_t	bytes_written;	//	of	the	dirty	chunks,	before	filters
+double	hash_seconds,	write_seconds;
 
+CheckpointStats()	:	generation(-1),	num_chunks(0),	dirty_chunks(0),	bytes_written(0),	hash_seconds(0.),	write_seconds(0.)	{}
 
-template<class	T>
-struct	h5traits
-{
-static	inline	Datatype	get_memtype()
+double	change_ratio()	const	{	return	num_chunks	?	double(dirty_chunks)	/	num_chunks	:	0.;	}
+};
+
+struct	CheckpointOptions
 {
-return	internal::get_memtype<T>();
-}
+int	keep;	//	number	of	generations	retained	by	write,	0	=	all
+int	num_threads;	//	for	hashing	and	encoding	chunks,	0	=	number	of	cores
 
-static	inline	Datatype	get_disktype()
+CheckpointOptions()	:	keep(0),	num_threads(0)	{}
+};
+
+/*
+Checkpoints	of	an	array	which	rewrite	only	the	chunks	that	changed	since	the
+previous	checkpoint,	found	by	comparing	hashes	of	the	chunks.	The	store	is	a
+group	with	an	empty	dataset	"prototype",	which	has	the	type,	extent	and
+chunking,	and	a	subgroup	per	generation	(named	0,	1,	...)	with
+-	data:	like	the	prototype,	with	only	the	changed	chunks	written
+-	hashes:	chunk_hash	of	each	chunk	at	that	generation
+-	manifest:	for	each	chunk,	the	generation	whose	data	holds	it
+Each	manifest	is	complete,	so	any	retained	generation	can	be	restored.	The
+manifest	is	written	last:	generations	without	one	are	incomplete,	they	are
+ignored	and	removed	by	the	next	write.
+*/
+class	IncrementalCheckpoint
 {
-return	internal::get_disktype<T>();
-}
+Group	group;
+Dataset	prototype;
+CheckpointOptions	options;
 
-static	inline	void	write(RW	&rw,	const	Datatype	&memtype,	const	Dataspace	&memspace,	const	T	*values)
+Group	generation_group(int	generation)	const
 {
-rw.write(values);
+Group	g	=	group;
+return	g.open_group(std::to_string(generation));
 }
 
-static	inline	void	read(RW	&rw,	const	Datatype	&memtype,	const	Dataspace	&memspace,	T	*values)
+static	std::vector<uint32_t>	read_manifest(Group	g)
 {
-rw.read(values);
+std::vector<uint32_t>	manifest;
+read_dataset(g.open_dataset("manifest"),	manifest);
+return	manifest;
 }
-};
-
 
-template<>
-struct	h5traits<std::string>
+//	numeric	names	of	the	subgroups,	with	or	without	manifest
+std::vector<int>	all_generations()	const
 {
-static	inline	Datatype	get_memtype()
+std::vector<int>	gens;
+for	(hsize_t	i=0;	i<group.size();	++i)
 {
-return	internal::get_memtype<char*>();
+std::string	name	=	group.get_link_name(i);
+if	(!name.empty()	&&	name.find_first_not_of("0123456789")	==	std::string::npos)
+gens.push_back(std::stoi(name));
+}
+std::sort(gens.begin(),	gens.end());
+return	gens;
 }
 
-static	inline	Datatype	get_disktype()
+public:
+explicit	IncrementalCheckpoint(Group	g,	const	CheckpointOptions	&options_	=	CheckpointOptions())	:	group(g),	options(options_)
 {
-return	internal::get_disktype<char*>();
+prototype	=	group.open_dataset("prototype");
 }
 
-static	inline	void	write(RW	&rw,	const	Datatype	&memtype,	const	Dataspace	&memspace,	const	std::string	*values)
+//	chunk_dims	defaults	to	the	chunking	of	flags;	the	layout	is	always	chunked
+template<class	T>
+static	IncrementalCheckpoint	create(Group	parent,	const	std::string	&name,	const	Dataspace	&space,	const	hsize_t	*chunk_dims	=	NULL,
+DsCreationFlags	flags	=	CREATE_DS_DEFAULT,	const	CheckpointOptions	&options	=	CheckpointOptions())
 {
-hssize_t	n	=	memspace.get_npoints();
-assert(n	>=	1);
-std::vector<const	char*>	s(n);
-for	(int	i=0;	i<n;	++i)	s[i]	=	values[i].c_str();
-rw.write(&s[0]);
+Group	g	=	parent.create_group(name);
+Datatype	dtype	=	internal::apply_disktype_flags(get_disktype<T>(),	flags);
+Properties	dcpl	=	Dataset::create_creation_properties(space,	DsCreationFlags((flags	|	CREATE_DS_CHUNKED)	&	~CREATE_DS_COMPACT_SMALL),	dtype);
+if	(chunk_dims)
+dcpl.chunked(space.get_rank(),	chunk_dims);
+Dataset::create(g,	"prototype",	dtype,	space,	dcpl);
+return	IncrementalCheckpoint(g,	options);
 }
 
-static	inline	void	read(RW	&rw,	const	Datatype	&memtype,	const	Dataspace	&memspace,	std::string	*values)
+//	the	complete	generations,	oldest	first
+std::vector<int>	generations()	const
 {
-hssize_t	n	=	memspace.get_npoints();
-assert(n	>=	1);
-assert(H5Tis_variable_str(memtype.get_id()));
-
-//	see	https://www.hdfgroup.org/HDF5/doc1.6/UG/11_Datatypes.html
-//	variable	data	sets.	string	types	(char*,	char[n],	std::string)	are	mapped	by	default	to	variable	length	data	types
+std::vector<int>	gens	=	all_generations(),	ret;
+for	(size_t	i=0;	i<gens.size();	++i)
+if	(group.exists(std::to_string(gens[i])	+	"/manifest"))
+ret.push_back(gens[i]);
+return	ret;
+}
 
-std::vector<char*>	buffers(n);
-rw.read(&buffers[0]);
-for	(hssize_t	i	=	0;	i	<	n;	++i)
+//	the	newest	complete	generation,	-1	if	there	is	none
+int	latest()	const
 {
-values[i].assign(buffers[i]);
+std::vector<int>	gens	=	generations();
+return	gens.empty()	?	-1	:	gens.back();
 }
-//	release	the	stuff	that	hdf5	allocated
-H5Dvlen_reclaim(memtype.get_id(),	memspace.get_id(),	H5P_DEFAULT,	&buffers[0]);
-}
-};
 
-
-template<size_t	n>
-struct	h5traits<char[n]>
+//	writes	a	new	generation	from	data,	which	has	the	extent	of	the	prototype
+template<class	T>
+CheckpointStats	write(const	T	*data)
 {
-typedef	char	CharArray[n];
-
-static	inline	Datatype	get_memtype()
+typedef	std::chrono::steady_clock	Clock;
+Datatype	memtype	=	get_memtype<T>();
+if	(H5Tdetect_class(memtype.get_id(),	H5T_VLEN)	!=	0	||	H5Tis_variable_str(memtype.get_id())	!=	0)
+throw	Exception("checkpoints	need	a	fixed	size	type");
+std::vector<int>	gens	=	all_generations();
+for	(size_t	i=0;	i<gens.size();	++i)
+if	(!group.exists(std::to_string(gens[i])	+	"/manifest"))
+group.remove(std::to_string(gens[i]));
+const	int	prev	=	latest();
+
+CheckpointStats	st;
+st.generation	=	prev	+	1;
+internal::ZoneGrid	grid(prototype);
+st.num_chunks	=	grid.size;
+Clock::time_point	t0	=	Clock::now();
+std::vector<uint64_t>	hashes(grid.size),	prev_hashes;
+internal::hash_zones(grid,	memtype.get_size(),	reinterpret_cast<const	unsigned	char*>(data),	hashes.data(),	options.num_threads);
+std::vector<uint32_t>	manifest(grid.size,	uint32_t(st.generation));
+if	(prev	>=	0)
+{
+Group	g	=	generation_group(prev);
+read_dataset(g.open_dataset("hashes"),	prev_hashes);
+manifest	=	read_manifest(g);
+}
+std::vector<hsize_t>	dirty;
+hsize_t	offset[H5S_MAX_RANK],	count[H5S_MAX_RANK];
+for	(hsize_t	i=0;	i<grid.size;	++i)
+if	(prev	<	0	||	hashes[i]	!=	prev_hashes[i])
+{
+dirty.push_back(i);
+manifest[i]	=	st.generation;
+grid.region(i,	offset,	count);
+st.bytes_written	+=	grid.elements(count)	*	memtype.get_size();
+}
+st.dirty_chunks	=	dirty.size();
+Clock::time_point	t1	=	Clock::now();
+st.hash_seconds	=	std::chrono::duration<double>(t1	-	t0).count();
+
+Group	g	=	group.create_group(std::to_string(st.generation));
+Dataset	ds	=	Dataset::create(g,	"data",	prototype.get_datatype(),	prototype.get_dataspace(),	prototype.get_creation_properties());
+hsize_t	zero[H5S_MAX_RANK]	=	{	0	};
+if	(dirty.size()	==	grid.size)
+{
+if	(!internal::write_chunks_parallel(ds,	memtype,	zero,	grid.dims,	data,	options.num_threads))
+ds.write(data);
+}
+else	if	(!internal::write_chunks_parallel(ds,	memtype,	zero,	grid.dims,	data,	options.num_threads,	&dirty))
+{
+internal::for_each_zone_box(grid,	dirty,	[&](const	hsize_t	*box_offset,	const	hsize_t	*box_count)
 {
-return	internal::get_memtype<char*>();
+Dataspace	sp	=	ds.get_dataspace();
+sp.select_hyperslab(box_offset,	NULL,	box_count,	NULL);
+ds.write(sp,	sp,	data);
+});
+}
+create_dataset(g,	"hashes",	hashes,	CREATE_DS_0);
+create_dataset(g,	"manifest",	manifest);
+if	(options.keep	>	0)
+prune(options.keep);
+if	(H5Fflush(group.get_id(),	H5F_SCOPE_LOCAL)	<	0)
+throw	Exception("cannot	flush	checkpoint");
+st.write_seconds	=	std::chrono::duration<double>(Clock::now()	-	t1).count();
+return	st;
 }
 
-static	inline	Datatype	get_disktype()
+//	restores	a	generation,	by	default	the	latest,	into	data,	which	has	the	extent	of	the	prototype
+template<class	T>
+void	restore(T	*data,	int	generation	=	-1)	const
+{
+std::vector<int>	gens	=	generations();
+if	(generation	<	0	&&	!gens.empty())
+generation	=	gens.back();
+if	(std::find(gens.begin(),	gens.end(),	generation)	==	gens.end())
+throw	Exception("no	such	checkpoint	generation");
+std::vector<uint32_t>	manifest	=	read_manifest(generation_group(generation));
+internal::ZoneGrid	grid(prototype);
+if	(manifest.size()	!=	grid.size)
+throw	Exception("checkpoint	manifest	doesn't	match	the	prototype");
+std::map<uint32_t,	std::vector<hsize_t>	>	chunks_of;
+for	(hsize_t	i=0;	i<grid.size;	++i)
+chunks_of[manifest[i]].push_back(i);
+for	(auto	it=chunks_of.begin();	it!=chunks_of.end();	++it)
+{
+Dataset	ds	=	generation_group(it->first).open_dataset("data");
+if	(it->second.size()	==	grid.size)
+{
+ds.read(data);
+continue;
+}
+internal::for_each_zone_box(grid,	it->second,	[&](const	hsize_t	*offset,	const	hsize_t	*count)
 {
-return	internal::get_disktype<char*>();
+Dataspace	sp	=	ds.get_dataspace();
+sp.select_hyperslab(offset,	NULL,	count,	NULL);
+ds.read(sp,	sp,	data);
+});
+}
 }
 
-static	inline	void	write(RW	&rw,	const	Datatype	&memtype,	const	Dataspace	&memspace,	const	CharArray	*values)
+/*
+Removes	the	oldest	generations	until	keep	are	left.	Chunks	still	referenced
+are	first	moved	to	the	next	generation,	as	raw	(filtered)	chunks.	The	space	of
+removed	data	is	not	reclaimed	inside	the	file,	see	repack.
+*/
+void	prune(int	keep)
 {
-std::vector<const	char*>	s(memspace.get_npoints());
-for	(int	i=0;	i<s.size();	++i)	s[i]	=	values[i];	//	because	i	don't	know	how	to	deal	with	an
-rw.write(&s[0]);
+std::vector<int>	gens	=	generations();
+internal::ZoneGrid	grid(prototype);
+while	(keep	>	0	&&	gens.size()	>	size_t(keep))
+{
+const	uint32_t	oldest	=	gens[0],	next	=	gens[1];
+Group	next_group	=	generation_group(next);
+std::vector<uint32_t>	manifest	=	read_manifest(next_group);
+std::vector<hsize_t>	moved;
+for	(hsize_t	i=0;	i<manifest.size();	++i)
+if	(manifest[i]	==	oldest)
+moved.push_back(i);
+internal::copy_chunks(generation_group(oldest).open_dataset("data"),	next_group.open_dataset("data"),	grid,	moved);
+for	(size_t	k=1;	k<gens.size();	++k)
+{
+Group	g	=	generation_group(gens[k]);
+manifest	=	read_manifest(g);
+if	(std::find(manifest.begin(),	manifest.end(),	oldest)	==	manifest.end())
+continue;
+std::replace(manifest.begin(),	manifest.end(),	oldest,	next);
+g.open_dataset("manifest").write(manifest.data());
+}
+group.remove(std::to_string(oldest));
+gens.erase(gens.begin());
+}
 }
 };
 
+/*--------------------------------------------------
+*	cache	tuning
+*	------------------------------------------------	*/
 
-template<>
-struct	h5traits	<	char*	>
+/*
+Recommended	cache	settings,	see	advise_cache.	Zero	means	keep	the	current
+setting.	notes	explains	each	recommendation.
+*/
+struct	CacheAdvice
 {
-static	inline	Datatype	get_memtype()
+size_t	mdc_max_size;
+size_t	page_buffer_size;	//	needs	reopening	the	file	with	Properties::page_buffer_size
+size_t	chunk_cache_bytes,	chunk_cache_slots;
+std::vector<std::string>	notes;
+
+CacheAdvice()	:	mdc_max_size(0),	page_buffer_size(0),	chunk_cache_bytes(0),	chunk_cache_slots(0)	{}
+};
+
+namespace	internal
 {
-return	internal::get_memtype<char*>();
-}
 
-static	inline	Datatype	get_disktype()
+inline	bool	is_prime(size_t	n)
 {
-return	internal::get_disktype<char*>();
+if	(n	<	2)
+return	false;
+for	(size_t	d=2;	d*d<=n;	++d)
+if	(n	%	d	==	0)
+return	false;
+return	true;
 }
 
-static	inline	void	write(RW	&rw,	const	Datatype	&memtype,	const	Dataspace	&memspace,	const	char	*const	*values)
+//	the	chunk	cache	hash	table	should	have	about	100	times	as	many	slots	as	chunks	fit	into	the	cache,	a	prime	number
+inline	size_t	chunk_cache_slots_for(size_t	chunks)
 {
-rw.write(values);
+size_t	n	=	std::max<size_t>(521,	100	*	chunks);
+while	(!is_prime(n))
+++n;
+return	n;
 }
-//	TODO:	enable	reading.	Needs	treatment	similar	to	std::string.	Don't	want	references	to	memory	allocated	by	HDF5	lib
-};
-
 
-//	the	rest	of	the	api	uses	h5traits_of	to	get	rid	of	const	and	volatile	qualifiers
-template<class	T>
-struct	h5traits_of
+inline	std::string	format_bytes(size_t	n)
 {
-typedef	typename	std::remove_cv<T>::type	stripped_type;
-typedef	h5traits<stripped_type>	type;	//	the	resulting	"clean"	traits	type
-};
+std::ostringstream	os;
+if	(n	>=	(size_t(1)	<<	20))
+os	<<	n	/	double(1	<<	20)	<<	"	MiB";
+else
+os	<<	n	/	1024.	<<	"	KiB";
+return	os.str();
+}
 
+}	//	namespace	internal
 
 /*
-Here	is	this	super	ugly	code	which	caches	the	result	of	the	construction	of	HDF5
-types	in	static,	i.e.	global	variables.	The	mechanism	uses	hid_t	as	static
-variable	type,	because	using	Datatype	would	result	in	destructor	calls,
-and	concomitant	api	calls	when	the	hdf	lib	is	unloaded	already.
+Compare	the	statistics	of	a	file,	and	optionally	of	a	dataset	with	its	typical
+access	shape	(elements	per	read	or	write	in	each	dimension),	with	the	current
+cache	settings.	Call	it	after	a	representative	part	of	the	workload	ran.
 */
-namespace	internal
+inline	CacheAdvice	advise_cache(const	File	&file,	const	Dataset	*ds	=	NULL,	const	hsize_t	*access_count	=	NULL)
 {
-
-inline	hid_t	prep_type_cache(Datatype	dt)
+//	the	library	refuses	larger	metadata	caches
+const	size_t	MAX_MDC_SIZE	=	128	<<	20;
+CacheAdvice	a;
+FileCacheStats	fs	=	file.cache_stats();
+if	(fs.mdc_hit_rate	<	0.95	&&	fs.mdc_cur_size	>=	0.9	*	fs.mdc_config_max_size	&&	fs.mdc_config_max_size	<	MAX_MDC_SIZE)
 {
-dt.lock();
-dt.inc_ref();
-return	dt.get_id();
+a.mdc_max_size	=	std::min(2	*	fs.mdc_config_max_size,	MAX_MDC_SIZE);
+std::ostringstream	os;
+os	<<	"metadata	cache	hit	rate	is	"	<<	fs.mdc_hit_rate	<<	"	with	the	cache	at	its	limit	of	"	<<	internal::format_bytes(fs.mdc_config_max_size)	<<	";	raise	the	limit	to	"	<<	internal::format_bytes(a.mdc_max_size);
+a.notes.push_back(os.str());
 }
-
+if	(fs.page_buffering)
+{
+unsigned	accesses	=	fs.page_accesses[0]	+	fs.page_accesses[1];
+unsigned	evictions	=	fs.page_evictions[0]	+	fs.page_evictions[1];
+if	(accesses	>	0	&&	(fs.page_hit_rate(0)	<	0.9	||	evictions	>	accesses	/	4))
+{
+a.page_buffer_size	=	2	*	fs.page_buffer_size;
+std::ostringstream	os;
+os	<<	"page	buffer	hit	rate	is	"	<<	fs.page_hit_rate(0)	<<	"	for	metadata	and	"	<<	fs.page_hit_rate(1)	<<	"	for	raw	data	with	"	<<	evictions	<<	"	evictions;	reopen	the	file	with	a	page	buffer	of	"	<<	internal::format_bytes(a.page_buffer_size);
+a.notes.push_back(os.str());
 }
-
-//	wrap	complicated	things	in	neat	api	functions
-template<class	T>
-inline	Datatype	get_disktype()
+}
+if	(ds)
 {
-static	hid_t	id	=	internal::prep_type_cache(h5traits_of<T>::type::get_disktype());
-return	Datatype(id,	internal::IncRC());
+DatasetIoStats	s	=	ds->io_stats();
+if	(s.chunked)
+{
+//	chunks	touched	by	an	unaligned	access,	which	must	all	stay	cached	while	it	runs
+size_t	chunks	=	1;
+for	(int	d=0;	d<s.rank;	++d)
+{
+hsize_t	count	=	access_count	?	std::max<hsize_t>(access_count[d],	1)	:	1;
+chunks	*=	std::min<hsize_t>((count	+	s.chunk_dims[d]	-	2)	/	s.chunk_dims[d]	+	1,	std::max<hsize_t>((s.dims[d]	+	s.chunk_dims[d]	-	1)	/	s.chunk_dims[d],	1));
+}
+size_t	needed	=	chunks	*	s.chunk_bytes;
+if	(needed	>	s.chunk_cache_bytes)
+{
+a.chunk_cache_bytes	=	needed	+	needed	/	4;
+a.chunk_cache_slots	=	internal::chunk_cache_slots_for(a.chunk_cache_bytes	/	std::max<size_t>(s.chunk_bytes,	1));
+std::ostringstream	os;
+os	<<	"accesses	touch	up	to	"	<<	chunks	<<	"	chunks	of	"	<<	internal::format_bytes(s.chunk_bytes)	<<	",	which	don't	fit	into	the	chunk	cache	of	"	<<	internal::format_bytes(s.chunk_cache_bytes)
+<<	",	so	chunks	are	decompressed	repeatedly;	use	a	chunk	cache	of	"	<<	internal::format_bytes(a.chunk_cache_bytes)	<<	"	with	"	<<	a.chunk_cache_slots	<<	"	slots";
+a.notes.push_back(os.str());
+}
+else	if	(s.chunk_cache_slots	<	10	*	(s.chunk_cache_bytes	/	std::max<size_t>(s.chunk_bytes,	1)))
+{
+a.chunk_cache_bytes	=	s.chunk_cache_bytes;
+a.chunk_cache_slots	=	internal::chunk_cache_slots_for(s.chunk_cache_bytes	/	std::max<size_t>(s.chunk_bytes,	1));
+a.notes.push_back("chunk	cache	has	few	hash	slots	for	the	number	of	chunks	it	holds,	which	causes	collisions;	use	"	+	std::to_string(a.chunk_cache_slots)	+	"	slots");
+}
+}
+}
+return	a;
 }
 
-template<class	T>
-inline	Datatype	get_memtype()
+//	set	the	metadata	cache	limit	recommended	by	advice	on	an	open	file
+inline	void	apply_advice(File	&file,	const	CacheAdvice	&advice)
 {
-static	hid_t	id	=	internal::prep_type_cache(h5traits_of<T>::type::get_memtype());
-return	Datatype(id,	internal::IncRC());
+if	(advice.mdc_max_size	>	0)
+file.set_mdc_max_size(advice.mdc_max_size);
 }
 
-}	//	namespace	h5cpp
+/*
+Reopen	ds	with	the	chunk	cache	recommended	by	advice.	The	chunk	cache	belongs
+to	the	open	dataset	and	is	set	when	it	is	first	opened,	so	this	has	no	effect
+while	other	handles	of	the	dataset	are	open.
+*/
+inline	void	apply_advice(Dataset	&ds,	const	CacheAdvice	&advice)
+{
+if	(advice.chunk_cache_bytes	==	0)
+return;
+Properties	dapl(H5P_DATASET_ACCESS);
+dapl.chunk_cache(advice.chunk_cache_slots,	advice.chunk_cache_bytes);
+std::string	name	=	ds.get_name();
+File	file	=	ds.get_file();
+ds	=	Dataset();
+ds	=	file.root().open_dataset(name,	dapl);
+}
 
 
+/*--------------------------------------------------
+*	I/O	trace	analysis
+*	------------------------------------------------	*/
 
-namespace	h5cpp
+//	summary	of	an	IoTrace,	see	analyze_io_trace
+struct	IoTraceReport
 {
+//	I/O	of	a	dataset,	of	all	metadata	("(metadata)")	or	of	raw	data	outside	known	datasets	("(raw	data)")
+struct	Target
+{
+std::string	name;
+uint64_t	reads,	writes,	read_bytes,	write_bytes,	small_reads;
+uint64_t	unique_read_bytes;	//	bytes	of	the	file	read	at	least	once
+double	read_seconds,	write_seconds;
 
-/*==================================================
-*	some	free	functions
-*===================================================*/
+Target()	:	reads(0),	writes(0),	read_bytes(0),	write_bytes(0),	small_reads(0),	unique_read_bytes(0),	read_seconds(0.),	write_seconds(0.)	{}
 
-#if	0
-template<class	iterator>
-inline	Dataspace	create_dataspace_from_iter(iterator	begin,	iterator	end)
-{
-hsize_t	dims[H5S_MAX_RANK];
-int	i	=	0;
-for	(;	begin	!=	end;	++begin)
-{
-dims[i++]	=	*begin;
+//	bytes	read	per	distinct	byte;	above	1	if	the	same	parts	of	the	file	are	read	again
+double	read_amplification()	const	{	return	unique_read_bytes	?	double(read_bytes)	/	unique_read_bytes	:	1.;	}
+};
 
-if	(i	>=	H5S_MAX_RANK)
-throw	Exception("error	creating	dataspace:	provided	range	is	too	large");
-}
-return	Dataspace::simple(i,	dims);
+Target	total;
+uint64_t	dropped;	//	records	overwritten	in	the	ring	buffer	before	the	analysis
+size_t	small_bytes;	//	reads	below	this	size	count	as	small
+std::vector<uint64_t>	size_histogram;	//	reads	by	size:	[0]	empty,	[k]	size	in	[2^(k-1),	2^k)
+std::vector<uint64_t>	seek_histogram;	//	reads	by	distance	from	the	end	of	the	previous	read	of	the	file:	[0]	sequential,	[k]	distance	in	[2^(k-1),	2^k)
+std::vector<Target>	targets;	//	most	small	reads	first
+
+IoTraceReport()	:	dropped(0),	small_bytes(0)	{}
+
+std::string	to_string(size_t	max_targets	=	10)	const
+{
+std::ostringstream	s;
+s	<<	"reads:	"	<<	total.reads	<<	"	("	<<	total.read_bytes	<<	"	bytes,	"	<<	total.read_seconds	<<	"	s),	"
+<<	"small	reads	(<	"	<<	small_bytes	<<	"	bytes):	"	<<	total.small_reads	<<	",	read	amplification:	"	<<	total.read_amplification()	<<	"\n";
+s	<<	"writes:	"	<<	total.writes	<<	"	("	<<	total.write_bytes	<<	"	bytes,	"	<<	total.write_seconds	<<	"	s)\n";
+if	(dropped)
+s	<<	"records	dropped:	"	<<	dropped	<<	"\n";
+s	<<	"read	sizes:\n";
+for	(size_t	k=0;	k<size_histogram.size();	++k)
+if	(size_histogram[k])
+s	<<	"	"	<<	(k	?	uint64_t(1)	<<	(k	-	1)	:	0)	<<	"	-	"	<<	(k	?	(uint64_t(1)	<<	k)	-	1	:	0)	<<	"	bytes:	"	<<	size_histogram[k]	<<	"\n";
+s	<<	"seek	distances:\n";
+for	(size_t	k=0;	k<seek_histogram.size();	++k)
+if	(seek_histogram[k])
+{
+if	(k	==	0)
+s	<<	"	sequential:	"	<<	seek_histogram[k]	<<	"\n";
+else
+s	<<	"	"	<<	(uint64_t(1)	<<	(k	-	1))	<<	"	-	"	<<	((uint64_t(1)	<<	k)	-	1)	<<	"	bytes:	"	<<	seek_histogram[k]	<<	"\n";
 }
-
-template<class	T,	class	A>
-inline	Dataspace	create_dataspace_simple(const	std::vector<T,	A>	&dims)
+s	<<	"targets:\n";
+for	(size_t	i=0;	i<targets.size()	&&	i<max_targets;	++i)
 {
-assert(dims.size()	>	0);
-return	Dataspace::simple(dims.size(),	&dims[0]);
+const	Target	&t	=	targets[i];
+s	<<	"	"	<<	t.name	<<	":	reads	"	<<	t.reads	<<	"	(small	"	<<	t.small_reads	<<	"),	"	<<	t.read_bytes	<<	"	bytes,	amplification	"
+<<	t.read_amplification()	<<	",	"	<<	t.read_seconds	<<	"	s;	writes	"	<<	t.writes	<<	",	"	<<	t.write_bytes	<<	"	bytes\n";
 }
+return	s.str();
+}
+};
 
-
-template<class	T,	class	A>
-inline	void	get_dims(const	Dataspace	&sp,	std::vector<T,	A>	&ret)
+namespace	internal
 {
-hsize_t	dims[H5S_MAX_RANK];
-int	r	=	sp.get_dims(dims);
-ret.resize(r);
-std::copy(dims,	dims	+	r,	ret.begin());
-}
-#endif
-/*--------------------------------------------------
-*	datasets
-*	------------------------------------------------	*/
 
+//	the	storage	of	(a	chunk	of)	a	dataset	in	the	file
+struct	DataExtent
+{
+haddr_t	addr;
+hsize_t	size;
+size_t	target;
 
+bool	operator<(const	DataExtent	&o)	const	{	return	addr	<	o.addr;	}
+};
 
-template<class	T>
-inline	Dataset	create_dataset(Group	group,	const	std::string	&name,	const	Dataspace	&sp,	const	T*	data	=	nullptr,	DsCreationFlags	flags	=
+//	0	for	0,	k	for	[2^(k-1),	2^k)
+inline	size_t	log2_bucket(uint64_t	v)
 {
-Dataset	ds	=	Dataset::create(group,	name,	get_disktype<T>(),	sp,	Dataset::create_creation_properties(sp,	flags));
-if	(data	!=	nullptr)
-ds.write<T>(data);
-return	ds;
+size_t	k	=	0;
+for	(;	v;	v>>=1)
+++k;
+return	k;
 }
 
-template<class	T>
-inline	Dataset	create_dataset_scalar(Group	group,	const	std::string	&name,	const	T&	data)
+inline	haddr_t	object_addr(hid_t	id)
 {
-Dataspace	sp	=	Dataspace::scalar();
-Dataset	ds	=	Dataset::create(group,	name,	get_disktype<T>(),	sp,	Dataset::create_creation_properties(sp,	CREATE_DS_0));
-ds.write<T>(&data);
-return	ds;
+#if	H5_VERSION_GE(1,	12,	0)
+H5O_info2_t	info;
+if	(H5Oget_info3(id,	&info,	H5O_INFO_BASIC)	<	0)
+throw	Exception("error	getting	object	info");
+haddr_t	addr	=	0;
+std::memcpy(&addr,	&info.token,	std::min(sizeof(addr),	sizeof(info.token)));	//	the	address	with	the	native	file	format
+return	addr;
+#else
+H5O_info_t	info;
+if	(H5Oget_info(id,	&info)	<	0)
+throw	Exception("error	getting	object	info");
+return	info.addr;
+#endif
 }
 
+//	datasets	below	g,	following	hard	links	only,	each	object	once	however	many
+//	links	lead	to	it	(and	through	cycles);	chunk	addresses	need	HDF5	>=	1.10.5
+inline	void	collect_data_extents(Group	g,	const	std::string	&path,	std::vector<std::string>	&names,	std::vector<DataExtent>	&extents,	std::set<haddr_t>	&visited)
+{
+hsize_t	n	=	g.size();
+for	(hsize_t	i=0;	i<n;	++i)
+{
+std::string	name	=	g.get_link_name(i);
+std::string	child	=	path	+	"/"	+	name;
+H5L_info_t	info;
+if	(H5Lget_info(g.get_id(),	name.c_str(),	&info,	H5P_DEFAULT)	<	0	||	info.type	!=	H5L_TYPE_HARD)
+continue;
+Object	obj(H5Oopen(g.get_id(),	name.c_str(),	H5P_DEFAULT));
+if	(!visited.insert(object_addr(obj.get_id())).second)
+continue;
+H5I_type_t	type	=	H5Iget_type(obj.get_id());
+if	(type	==	H5I_GROUP)
+collect_data_extents(g.open_group(name),	child,	names,	extents,	visited);
+if	(type	!=	H5I_DATASET)
+continue;
+Dataset	ds(obj.get_id());
+DataExtent	e;
+e.target	=	names.size();
+names.push_back(child);
+Object	dcpl(H5Dget_create_plist(ds.get_id()));
+H5D_layout_t	layout	=	H5Pget_layout(dcpl.get_id());
+if	(layout	==	H5D_CONTIGUOUS)
+{
+e.addr	=	H5Dget_offset(ds.get_id());
+e.size	=	H5Dget_storage_size(ds.get_id());
+if	(e.addr	!=	HADDR_UNDEF)
+extents.push_back(e);
+}
+#if	H5_VERSION_GE(1,	10,	5)
+else	if	(layout	==	H5D_CHUNKED)
+{
+ZoneGrid	grid(ds);
+hsize_t	offset[H5S_MAX_RANK],	count[H5S_MAX_RANK];
+for	(hsize_t	c=0;	c<grid.size;	++c)
+{
+grid.region(c,	offset,	count);
+unsigned	int	mask;
+if	(H5Dget_chunk_info_by_coord(ds.get_id(),	offset,	&mask,	&e.addr,	&e.size)	>=	0	&&	e.addr	!=	HADDR_UNDEF)
+extents.push_back(e);
+}
+}
+#endif
+}
+}
 
-template<class	T,	class	A>
-inline	Dataset	create_dataset(Group	group,	const	std::string	&name,	const	std::vector<T,	A>	&data,	DsCreationFlags	flags	=	CREATE_DS_DEFAULT)
+//	total	length	of	the	union	of	the	ranges	[first,	second)
+inline	uint64_t	union_length(std::vector<std::pair<uint64_t,	uint64_t>	>	&ranges)
 {
-return	create_dataset(group,	name,	Dataspace::simple_dims(data.size()),	&data[0],	flags);
+std::sort(ranges.begin(),	ranges.end());
+uint64_t	len	=	0,	end	=	0;
+for	(size_t	i=0;	i<ranges.size();	++i)
+{
+uint64_t	begin	=	std::max(ranges[i].first,	end);
+if	(ranges[i].second	>	begin)
+{
+len	+=	ranges[i].second	-	begin;
+end	=	ranges[i].second;
+}
+}
+return	len;
 }
 
+}	//	namespace	internal
 
-template<class	T,	class	A>
-inline	void	read_dataset(const	Dataset	ds,	std::vector<T,	A>	&ret)
-{
-Dataspace	sp	=	ds.get_dataspace();
-ret.resize(sp.get_npoints());
-ds.read(&ret[0]);
+/*
+Statistics	of	traced	reads	and	writes:	sizes,	seek	distances,	read
+amplification,	and	which	datasets	get	many	small	reads.	Raw	data	I/O	is
+attributed	to	datasets	by	its	start	address	if	file	is	given,	which	must	be
+a	traced	file	(or	another	handle	to	it);	compact	datasets	are	part	of	their
+object	header,	i.e.	metadata.	Raw	data	of	other	files	opened	with	the	same
+trace	stays	"(raw	data)":	file_names	(IoTrace::file_names)	tells	the	files	of
+the	records	apart	by	name,	without	it	all	records	must	be	of	file.
+*/
+inline	IoTraceReport	analyze_io_trace(const	std::vector<IoTraceRecord>	&records,	File	file	=	File(),	size_t	small_bytes	=	4096,	const	std::vector<std::string>	&file_names	=	std::vector<std::string>())
+{
+IoTraceReport	rep;
+rep.small_bytes	=	small_bytes;
+rep.total.name	=	"(total)";
+std::vector<std::string>	names;
+names.push_back("(metadata)");
+names.push_back("(raw	data)");
+std::vector<internal::DataExtent>	extents;
+std::vector<bool>	of_file;	//	by	IoTraceRecord::file,	empty	if	all	are
+if	(file.is_valid())
+{
+std::set<haddr_t>	visited;
+Group	root	=	file.root();
+visited.insert(internal::object_addr(root.get_id()));
+internal::collect_data_extents(root,	"",	names,	extents,	visited);
+if	(!file_names.empty())
+{
+const	std::string	name	=	internal::file_name_of(file.get_id());
+for	(size_t	k=0;	k<file_names.size();	++k)
+of_file.push_back(file_names[k]	==	name);
+}
+}
+std::sort(extents.begin(),	extents.end());
+std::vector<IoTraceReport::Target>	targets(names.size());
+for	(size_t	i=0;	i<names.size();	++i)
+targets[i].name	=	names[i];
+
+std::vector<std::vector<std::pair<uint64_t,	uint64_t>	>	>	ranges(names.size());
+std::vector<std::pair<uint64_t,	uint64_t>	>	all_ranges;
+std::map<uint16_t,	uint64_t>	last_end;	//	of	the	previous	read	of	each	file
+for	(size_t	i=0;	i<records.size();	++i)
+{
+const	IoTraceRecord	&r	=	records[i];
+size_t	t	=	0;
+if	(r.type	==	H5FD_MEM_DRAW)
+{
+t	=	1;
+if	(of_file.empty()	||	(r.file	<	of_file.size()	&&	of_file[r.file]))
+{
+internal::DataExtent	key	=	{	r.offset,	0,	0	};
+std::vector<internal::DataExtent>::const_iterator	it	=	std::upper_bound(extents.begin(),	extents.end(),	key);
+if	(it	!=	extents.begin()	&&	r.offset	<	(it	-	1)->addr	+	(it	-	1)->size)
+t	=	(it	-	1)->target;
+}
+}
+IoTraceReport::Target	&target	=	targets[t];
+const	double	seconds	=	r.latency_ns	*	1e-9;
+if	(r.write)
+{
+++target.writes;
+++rep.total.writes;
+target.write_bytes	+=	r.size;
+rep.total.write_bytes	+=	r.size;
+target.write_seconds	+=	seconds;
+rep.total.write_seconds	+=	seconds;
+continue;
+}
+++target.reads;
+++rep.total.reads;
+target.read_bytes	+=	r.size;
+rep.total.read_bytes	+=	r.size;
+target.read_seconds	+=	seconds;
+rep.total.read_seconds	+=	seconds;
+if	(r.size	<	small_bytes)
+{
+++target.small_reads;
+++rep.total.small_reads;
+}
+ranges[t].push_back(std::make_pair(r.offset,	r.offset	+	r.size));
+all_ranges.push_back(ranges[t].back());
+size_t	k	=	internal::log2_bucket(r.size);
+if	(rep.size_histogram.size()	<=	k)
+rep.size_histogram.resize(k	+	1,	0);
+++rep.size_histogram[k];
+std::map<uint16_t,	uint64_t>::iterator	last	=	last_end.find(r.file);
+if	(last	!=	last_end.end())
+{
+k	=	internal::log2_bucket(r.offset	>	last->second	?	r.offset	-	last->second	:	last->second	-	r.offset);
+if	(rep.seek_histogram.size()	<=	k)
+rep.seek_histogram.resize(k	+	1,	0);
+++rep.seek_histogram[k];
+}
+last_end[r.file]	=	r.offset	+	r.size;
+}
+for	(size_t	t=0;	t<targets.size();	++t)
+{
+targets[t].unique_read_bytes	=	internal::union_length(ranges[t]);
+if	(targets[t].reads	||	targets[t].writes)
+rep.targets.push_back(targets[t]);
+}
+rep.total.unique_read_bytes	=	internal::union_length(all_ranges);
+std::stable_sort(rep.targets.begin(),	rep.targets.end(),	[](const	IoTraceReport::Target	&a,	const	IoTraceReport::Target	&b)
+{
+return	a.small_reads	!=	b.small_reads	?	a.small_reads	>	b.small_reads	:	a.reads	>	b.reads;
+});
+return	rep;
+}
+
+inline	IoTraceReport	analyze_io_trace(const	IoTrace	&trace,	File	file	=	File(),	size_t	small_bytes	=	4096)
+{
+IoTraceReport	rep	=	analyze_io_trace(trace.records(),	file,	small_bytes,	trace.file_names());
+rep.dropped	=	trace.dropped();
+return	rep;
 }
 
 
@@ -0,0 +1,35 @@
+/*
+Round	trips	of	std::vector<std::array<T,	N>>	in	both	ArrayMapping	layouts,
+including	empty	vectors.
+*/
+#include	"hdf_wrapper.h"
+#include	<cstdio>
+
+using	namespace	h5cpp;
+
+int	main()
+{
+File	f("array_datasets.h5",	"w");
+int	failures	=	0;
+const	ArrayMapping	mappings[2]	=	{	ARRAY_AS_TYPE,	ARRAY_AS_DIMENSION	};
+const	char	*names[2]	=	{	"as_type",	"as_dimension"	};
+for	(int	m=0;	m<2;	++m)
+{
+for	(size_t	n=0;	n<=5;	n+=5)
+{
+std::vector<std::array<float,	3>	>	data(n),	back(7);
+for	(size_t	i=0;	i<n;	++i)
+data[i]	=	{{	float(i),	float(i)	+	0.5f,	-float(i)	}};
+std::string	name	=	std::string(names[m])	+	"_"	+	std::to_string(n);
+create_dataset(f.root(),	name,	data,	CREATE_DS_0,	mappings[m]);
+read_dataset(f.root().open_dataset(name),	back);
+if	(back	!=	data)
+{
+printf("%s:	round	trip	differs\n",	name.c_str());
+++failures;
+}
+}
+}
+printf("%d	failures\n",	failures);
+return	failures	!=	0;
+}
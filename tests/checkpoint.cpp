@@ -0,0 +1,96 @@
+/*
+Incremental	checkpoints:	chunk_hash	depends	on	the	order	of	the	stripes,	so
+a	chunk	whose	64	byte	stripes	were	permuted	is	written.
+*/
+#include	"hdf_wrapper.h"
+#include	<cstdio>
+#include	<cstdlib>
+
+using	namespace	h5cpp;
+
+static	int	failures	=	0;
+
+static	void	expect(bool	ok,	const	char	*what)
+{
+if	(!ok)
+{
+printf("failed:	%s\n",	what);
+++failures;
+}
+}
+
+static	void	swap_stripes(unsigned	char	*p,	size_t	a,	size_t	b)
+{
+unsigned	char	tmp[64];
+std::memcpy(tmp,	p	+	64	*	a,	64);
+std::memcpy(p	+	64	*	a,	p	+	64	*	b,	64);
+std::memcpy(p	+	64	*	b,	tmp,	64);
+}
+
+int	main()
+{
+//	every	pair	of	stripes	of	a	KiB	block,	of	a	block	after	the	first,	and	of	the	stripes	after	the	last	block
+std::vector<unsigned	char>	bytes(2048	+	5	*	64	+	17);
+for	(size_t	i=0;	i<bytes.size();	++i)
+bytes[i]	=	(unsigned	char)rand();
+const	uint64_t	h	=	internal::chunk_hash(bytes.data(),	bytes.size());
+int	collisions	=	0;
+for	(size_t	base	:	{	size_t(0),	size_t(1024),	size_t(2048)	})
+{
+size_t	stripes	=	base	<	2048	?	16	:	5;
+for	(size_t	a=0;	a<stripes;	++a)
+for	(size_t	b=a+1;	b<stripes;	++b)
+{
+swap_stripes(bytes.data()	+	base,	a,	b);
+collisions	+=	internal::chunk_hash(bytes.data(),	bytes.size())	==	h;
+swap_stripes(bytes.data()	+	base,	a,	b);
+}
+}
+expect(collisions	==	0,	"swapping	stripes	changes	the	hash");
+
+#ifdef	HDF_WRAPPER_X86_SIMD
+//	the	SIMD	block	loops	against	the	scalar	one
+const	uint64_t	*keys	=	internal::chunk_hash_keys();
+uint64_t	scalar[8],	simd[8];
+std::copy(keys,	keys	+	8,	scalar);
+for	(size_t	b=0;	b<2;	++b)
+{
+for	(int	i=0;	i<16;	++i)
+internal::hash_stripe(scalar,	bytes.data()	+	1024	*	b	+	64	*	i,	keys	+	i);
+internal::hash_scramble(scalar,	keys);
+}
+if	(internal::cpu_has_avx2())
+{
+std::copy(keys,	keys	+	8,	simd);
+internal::hash_blocks_avx2(simd,	bytes.data(),	2,	keys);
+expect(std::equal(simd,	simd	+	8,	scalar),	"AVX2	hash	matches	the	scalar	one");
+}
+if	(internal::cpu_has_avx512f())
+{
+std::copy(keys,	keys	+	8,	simd);
+internal::hash_blocks_avx512(simd,	bytes.data(),	2,	keys);
+expect(std::equal(simd,	simd	+	8,	scalar),	"AVX-512	hash	matches	the	scalar	one");
+}
+#endif
+
+File	f("checkpoint.h5",	"w");
+const	hsize_t	n	=	4096,	chunk	=	1024;
+hsize_t	dims	=	n;
+IncrementalCheckpoint	cp	=	IncrementalCheckpoint::create<double>(f.root(),	"cp",	Dataspace::simple(1,	&dims),	&chunk);
+std::vector<double>	data(n);
+for	(hsize_t	i=0;	i<n;	++i)
+data[i]	=	double(rand());
+cp.write(data.data());
+
+//	the	second	chunk,	with	its	first	two	stripes	swapped
+swap_stripes(reinterpret_cast<unsigned	char*>(data.data()	+	chunk),	0,	1);
+CheckpointStats	st	=	cp.write(data.data());
+expect(st.dirty_chunks	==	1,	"the	permuted	chunk	is	dirty");
+
+std::vector<double>	back(n);
+cp.restore(back.data());
+expect(back	==	data,	"restore	gives	the	permuted	data");
+
+printf("%d	failures\n",	failures);
+return	failures	!=	0;
+}
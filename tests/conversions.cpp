@@ -0,0 +1,166 @@
+/*
+Checks	the	SIMD	conversion	kernels	against	the	scalar	path	and	the	library's
+own	conversions	at	the	boundaries	of	the	float	range,	and	the	16	bit	float
+kernels	against	the	scalar	encode	and	decode.
+*/
+#include	"hdf_wrapper.h"
+#include	<cstdio>
+
+using	namespace	h5cpp;
+
+static	bool	same(float	a,	float	b)
+{
+return	(std::isnan(a)	&&	std::isnan(b))	||	std::memcmp(&a,	&b,	sizeof(float))	==	0;
+}
+
+static	int	check(const	char	*what,	const	std::vector<double>	&src,	const	std::vector<float>	&dst,	const	std::vector<float>	&expected,	size_t	n)
+{
+int	failures	=	0;
+for	(size_t	i=0;	i<n;	++i)
+{
+if	(!same(dst[i],	expected[i]))
+{
+printf("%s:	%.17g	->	%.9g,	expected	%.9g\n",	what,	src[i],	dst[i],	expected[i]);
+++failures;
+}
+}
+return	failures;
+}
+
+typedef	size_t	(*Kernel)(const	unsigned	char	*,	unsigned	char	*,	size_t);
+
+//	a	16	bit	float	kernel	pair	against	the	scalar	encode	and	decode	of	F,	bit	for	bit
+template<class	F>
+static	int	check_16(const	char	*what,	Kernel	decode,	Kernel	encode)
+{
+int	failures	=	0;
+std::vector<uint16_t>	halves(1	<<	16);
+for	(size_t	i=0;	i<halves.size();	++i)
+halves[i]	=	uint16_t(i);
+std::vector<float>	floats(halves.size());
+size_t	done	=	decode(reinterpret_cast<const	unsigned	char*>(halves.data()),	reinterpret_cast<unsigned	char*>(floats.data()),	halves.size());
+for	(size_t	i=0;	i<done;	++i)
+{
+float	expected	=	F::decode(halves[i]);
+if	(std::memcmp(&floats[i],	&expected,	4)	!=	0	&&	failures++	<	5)
+printf("%s	decode:	%04x	->	%08x\n",	what,	unsigned(halves[i]),	*reinterpret_cast<uint32_t*>(&floats[i]));
+}
+
+//	the	decoded	values,	the	midpoints	between	them,	their	neighbours	and	random	bit	patterns
+std::vector<uint32_t>	bits;
+for	(size_t	i=0;	i<halves.size();	++i)
+{
+uint32_t	b;
+float	f	=	F::decode(halves[i]);
+std::memcpy(&b,	&f,	4);
+bits.push_back(b);
+if	(i	+	1	<	halves.size())
+{
+float	g	=	F::decode(halves[i	+	1]);
+uint32_t	c;
+std::memcpy(&c,	&g,	4);
+bits.push_back(b	/	2	+	c	/	2	+	(b	&	c	&	1));
+bits.push_back(b	/	2	+	c	/	2	+	(b	&	c	&	1)	+	1);
+bits.push_back(b	/	2	+	c	/	2	+	(b	&	c	&	1)	-	1);
+}
+}
+for	(int	i=0;	i<100000;	++i)
+bits.push_back(uint32_t(rand())	^	(uint32_t(rand())	<<	16));
+std::vector<uint16_t>	out(bits.size());
+done	=	encode(reinterpret_cast<const	unsigned	char*>(bits.data()),	reinterpret_cast<unsigned	char*>(out.data()),	bits.size());
+for	(size_t	i=0;	i<done;	++i)
+{
+float	f;
+std::memcpy(&f,	&bits[i],	4);
+if	(out[i]	!=	F::encode(f)	&&	failures++	<	10)
+printf("%s	encode:	%08x	->	%04x,	expected	%04x\n",	what,	unsigned(bits[i]),	unsigned(out[i]),	unsigned(F::encode(f)));
+}
+return	failures;
+}
+
+int	main()
+{
+const	double	fmax	=	std::numeric_limits<float>::max();
+const	double	half_ulp	=	std::ldexp(1.,	127	-	24);
+const	double	boundary[]	=	{
+0.,	-0.,	1.5,	-1.5,	1e-40,	-1e-40,	1e-320,
+fmax,	-fmax,	std::nextafter(fmax,	0.),	fmax	+	half_ulp	/	2,	-fmax	-	half_ulp	/	2,
+std::nextafter(fmax	+	half_ulp,	0.),	-std::nextafter(fmax	+	half_ulp,	0.),	fmax	+	half_ulp,	-fmax	-	half_ulp,
+1e39,	-1e39,	std::numeric_limits<double>::max(),	-std::numeric_limits<double>::max(),
+std::numeric_limits<double>::infinity(),	-std::numeric_limits<double>::infinity(),	std::numeric_limits<double>::quiet_NaN()
+};
+const	size_t	nb	=	sizeof(boundary)	/	sizeof(boundary[0]);
+
+//	every	value	at	every	position	of	a	vector,	and	a	tail	for	the	scalar	loop
+const	size_t	n	=	64	*	nb	+	7;
+std::vector<double>	src(n);
+for	(size_t	i=0;	i<n;	++i)
+src[i]	=	boundary[(i	+	i	/	nb)	%	nb];
+std::vector<float>	expected(n),	dst(n);
+for	(size_t	i=0;	i<n;	++i)
+expected[i]	=	internal::convert_value<float>(src[i]);
+
+int	failures	=	0;
+const	unsigned	char	*s	=	reinterpret_cast<const	unsigned	char*>(src.data());
+unsigned	char	*d	=	reinterpret_cast<unsigned	char*>(dst.data());
+
+//	the	library,	before	the	conversions	of	the	wrapper	replace	its	own
+std::vector<double>	buf(src);
+if	(H5Tconvert(H5T_NATIVE_DOUBLE,	H5T_NATIVE_FLOAT,	n,	buf.data(),	NULL,	H5P_DEFAULT)	<	0)
+return	1;
+failures	+=	check("library",	src,	std::vector<float>((float*)buf.data(),	(float*)buf.data()	+	n),	expected,	n);
+
+#ifdef	HDF_WRAPPER_X86_SIMD
+if	(internal::cpu_has_avx2())
+{
+std::fill(dst.begin(),	dst.end(),	0.f);
+failures	+=	check("avx2",	src,	dst,	expected,	internal::double_to_float_avx2(s,	d,	n));
+}
+if	(internal::cpu_has_avx512f())
+{
+std::fill(dst.begin(),	dst.end(),	0.f);
+failures	+=	check("avx512",	src,	dst,	expected,	internal::double_to_float_avx512(s,	d,	n));
+}
+
+//	and	back,	which	is	exact
+std::vector<double>	wide(n),	wide_expected(n);
+for	(size_t	i=0;	i<n;	++i)
+wide_expected[i]	=	expected[i];
+if	(internal::cpu_has_avx2())
+{
+size_t	done	=	internal::float_to_double_avx2(reinterpret_cast<const	unsigned	char*>(expected.data()),	reinterpret_cast<unsigned	char*>(wide.data()),	n);
+for	(size_t	i=0;	i<done;	++i)
+failures	+=	std::memcmp(&wide[i],	&wide_expected[i],	sizeof(double))	!=	0;
+}
+if	(internal::cpu_has_avx512f())
+{
+size_t	done	=	internal::float_to_double_avx512(reinterpret_cast<const	unsigned	char*>(expected.data()),	reinterpret_cast<unsigned	char*>(wide.data()),	n);
+for	(size_t	i=0;	i<done;	++i)
+failures	+=	std::memcmp(&wide[i],	&wide_expected[i],	sizeof(double))	!=	0;
+}
+
+//	16	bit	floats	against	the	scalar	code	of	the	registered	conversions
+if	(internal::cpu_has_f16c())
+failures	+=	check_16<internal::Float16Format>("f16c",	internal::half_to_float_f16c,	internal::float_to_half_f16c);
+if	(internal::cpu_has_avx2())
+failures	+=	check_16<internal::BFloat16Format>("bfloat16	avx2",	internal::bfloat16_to_float_avx2,	internal::float_to_bfloat16_avx2);
+if	(internal::cpu_has_avx512f())
+{
+failures	+=	check_16<internal::Float16Format>("half	avx512",	internal::half_to_float_avx512,	internal::float_to_half_avx512);
+failures	+=	check_16<internal::BFloat16Format>("bfloat16	avx512",	internal::bfloat16_to_float_avx512,	internal::float_to_bfloat16_avx512);
+}
+#endif
+
+std::fill(dst.begin(),	dst.end(),	0.f);
+internal::ConvertKernel<double,	float>::run(s,	d,	n);
+failures	+=	check("kernel",	src,	dst,	expected,	n);
+
+register_fast_conversions();
+buf	=	src;
+if	(H5Tconvert(H5T_NATIVE_DOUBLE,	H5T_NATIVE_FLOAT,	n,	buf.data(),	NULL,	H5P_DEFAULT)	<	0)
+return	1;
+failures	+=	check("registered",	src,	std::vector<float>((float*)buf.data(),	(float*)buf.data()	+	n),	expected,	n);
+
+printf("%d	failures\n",	failures);
+return	failures	!=	0;
+}
@@ -0,0 +1,51 @@
+/*
+Layout	and	allocation	chosen	by	the	DsCreationFlags.
+*/
+#include	"hdf_wrapper.h"
+#include	<cstdio>
+
+using	namespace	h5cpp;
+
+static	int	failures	=	0;
+
+static	void	expect(bool	ok,	const	char	*what)
+{
+if	(!ok)
+{
+printf("failed:	%s\n",	what);
+++failures;
+}
+}
+
+static	H5D_layout_t	layout(const	Dataset	&ds)
+{
+return	H5Pget_layout(ds.get_creation_properties().get_id());
+}
+
+static	H5D_alloc_time_t	alloc_time(const	Dataset	&ds)
+{
+H5D_alloc_time_t	t;
+H5Pget_alloc_time(ds.get_creation_properties().get_id(),	&t);
+return	t;
+}
+
+int	main()
+{
+File	f("create_flags.h5",	"w");
+hsize_t	zero	=	0,	unlimited	=	H5S_UNLIMITED,	ten	=	10;
+
+Dataset	small	=	create_dataset<float>(f.root(),	"small",	Dataspace::simple(1,	&ten),	NULL,	DsCreationFlags(CREATE_DS_COMPACT_SMALL));
+expect(layout(small)	==	H5D_COMPACT,	"small	fixed	size	dataset	is	compact");
+
+Dataset	ext	=	create_dataset<float>(f.root(),	"extendible",	Dataspace::simple(1,	&zero,	&unlimited),	NULL,	DsCreationFlags(CREATE_DS_COMPACT_SMALL	|	CREATE_DS_CHUNKED));
+expect(layout(ext)	==	H5D_CHUNKED,	"empty	extendible	dataset	is	chunked,	not	compact");
+
+Dataset	contiguous	=	create_dataset<float>(f.root(),	"contiguous",	Dataspace::simple(1,	&ten),	NULL,	DsCreationFlags(CREATE_DS_NO_FILL));
+expect(layout(contiguous)	==	H5D_CONTIGUOUS	&&	alloc_time(contiguous)	==	H5D_ALLOC_TIME_LATE,	"no	fill,	contiguous:	late	allocation");
+
+Dataset	chunked	=	create_dataset<float>(f.root(),	"chunked",	Dataspace::simple(1,	&ten),	NULL,	DsCreationFlags(CREATE_DS_NO_FILL	|	CREATE_DS_CHUNKED));
+expect(layout(chunked)	==	H5D_CHUNKED	&&	alloc_time(chunked)	==	H5D_ALLOC_TIME_INCR,	"no	fill,	chunked:	incremental	allocation");
+
+printf("%d	failures\n",	failures);
+return	failures	!=	0;
+}
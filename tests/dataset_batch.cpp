@@ -0,0 +1,45 @@
+/*
+DatasetBatch	with	selections	which	select	nothing,	as	on	processes	without
+data	in	a	decomposition;	they	must	be	kept	and	transfer	nothing.
+*/
+#include	"hdf_wrapper.h"
+#include	<cstdio>
+
+using	namespace	h5cpp;
+
+int	main()
+{
+File	f("dataset_batch.h5",	"w");
+hsize_t	dims[2]	=	{	8,	3	};
+Dataset	a	=	Dataset::create(f.root(),	"a",	get_disktype<int>(),	Dataspace::simple(2,	dims),	Properties(H5P_DATASET_CREATE));
+Dataset	b	=	Dataset::create(f.root(),	"b",	get_disktype<int>(),	Dataspace::simple(2,	dims),	Properties(H5P_DATASET_CREATE));
+std::vector<int>	rows	=	{	1,	5	},	none;
+std::vector<int>	data(rows.size()	*	3);
+for	(size_t	i=0;	i<data.size();	++i)
+data[i]	=	int(i)	+	1;
+
+DatasetBatch	batch;
+batch.add(a,	Selection::indices(rows),	(const	int*)data.data());
+batch.add(b,	Selection::indices(none),	(const	int*)NULL);
+batch.write();
+
+std::vector<int>	back(data.size()),	nothing;
+DatasetBatch	rbatch;
+rbatch.add(a,	Selection::indices(rows),	back.data());
+rbatch.add(b,	Selection::indices(none),	nothing.data());
+rbatch.read();
+
+int	failures	=	0;
+if	(batch.size()	!=	2	||	rbatch.size()	!=	2)
+{
+printf("empty	selections	were	dropped\n");
+++failures;
+}
+if	(back	!=	data)
+{
+printf("data	read	back	differs\n");
+++failures;
+}
+printf("%d	failures\n",	failures);
+return	failures	!=	0;
+}
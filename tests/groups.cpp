@@ -0,0 +1,41 @@
+/*
+Group::create_creation_properties	makes	new	style	groups	even	with	the
+default	library	version	bounds,	so	the	storage	settings	apply.
+*/
+#include	"hdf_wrapper.h"
+#include	<cstdio>
+
+using	namespace	h5cpp;
+
+static	int	failures	=	0;
+
+static	void	expect(bool	ok,	const	char	*what)
+{
+if	(!ok)
+{
+printf("failed:	%s\n",	what);
+++failures;
+}
+}
+
+int	main()
+{
+File	f("groups.h5",	"w");
+Group	big	=	f.root().create_group("big",	Group::create_creation_properties(1000));
+Group	small	=	f.root().create_group("small",	Group::create_creation_properties(4));
+Group	ordered	=	f.root().create_group("ordered",	Group::create_creation_properties(4,	16,	true));
+for	(int	i=0;	i<3;	++i)
+{
+std::string	name	=	"g"	+	std::to_string(2	-	i);
+big.create_group(name);
+small.create_group(name);
+ordered.create_group(name);
+}
+expect(big.storage_type()	==	H5G_STORAGE_TYPE_DENSE,	"large	group	is	dense	from	the	start");
+expect(small.storage_type()	==	H5G_STORAGE_TYPE_COMPACT,	"small	group	is	compact");
+expect(f.root().create_group("plain").storage_type()	==	H5G_STORAGE_TYPE_SYMBOL_TABLE,	"default	groups	stay	old	style");
+expect(ordered.get_link_name(0,	H5_INDEX_CRT_ORDER)	==	"g2",	"creation	order	index");
+
+printf("%d	failures\n",	failures);
+return	failures	!=	0;
+}
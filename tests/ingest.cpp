@@ -0,0 +1,81 @@
+/*
+IngestQueue:	the	rings	of	destroyed	producers	are	freed	once	drained,	and
+stop()	may	be	called	from	several	threads	at	once.
+*/
+#include	"hdf_wrapper.h"
+#include	<cstdio>
+
+using	namespace	h5cpp;
+
+static	int	failures	=	0;
+
+static	void	expect(bool	ok,	const	char	*what)
+{
+if	(!ok)
+{
+printf("failed:	%s\n",	what);
+++failures;
+}
+}
+
+static	Dataset	create_rows(Group	g,	const	char	*name)
+{
+hsize_t	dims[2]	=	{	0,	2	},	maxdims[2]	=	{	H5S_UNLIMITED,	2	},	chunk[2]	=	{	64,	2	};
+Properties	dcpl(H5Pcreate(H5P_DATASET_CREATE),	internal::NoIncRC());
+H5Pset_chunk(dcpl.get_id(),	2,	chunk);
+return	Dataset::create(g,	name,	get_disktype<double>(),	Dataspace::simple(2,	dims,	maxdims),	dcpl);
+}
+
+int	main()
+{
+File	f("ingest.h5",	"w");
+Dataset	ds	=	create_rows(f.root(),	"rows");
+IngestOptions	options;
+options.ring_records	=	16;
+IngestQueue<double>::Producer	outliving;
+{
+IngestQueue<double>	q({	ds	},	options);
+const	int	threads	=	4,	producers	=	50,	rows	=	20;
+std::vector<std::thread>	pool;
+for	(int	t=0;	t<threads;	++t)
+pool.push_back(std::thread([&q,	t]()
+{
+for	(int	p=0;	p<producers;	++p)
+{
+IngestQueue<double>::Producer	producer	=	q.producer();
+for	(int	r=0;	r<rows;	++r)
+{
+double	row[2]	=	{	double(t),	double(p	*	rows	+	r)	};
+producer.push(0,	row);
+}
+}
+}));
+for	(size_t	t=0;	t<pool.size();	++t)
+pool[t].join();
+for	(int	i=0;	i<10000	&&	q.stats().rings	>	0;	++i)
+std::this_thread::sleep_for(std::chrono::milliseconds(1));
+expect(q.stats().rings	==	0,	"rings	of	destroyed	producers	are	freed");
+
+outliving	=	q.producer();
+double	row[2]	=	{	-1.,	-1.	};
+expect(outliving.push(0,	row),	"push	to	a	new	producer");
+expect(q.stats().rings	==	1,	"one	ring	in	use");
+
+std::vector<std::thread>	stoppers;
+for	(int	t=0;	t<2;	++t)
+stoppers.push_back(std::thread([&q]()	{	q.stop();	}));
+q.stop();
+for	(size_t	t=0;	t<stoppers.size();	++t)
+stoppers[t].join();
+expect(!outliving.push(0,	row),	"pushes	fail	after	stop");
+IngestStats	s	=	q.stats();
+expect(s.records	==	uint64_t(threads	*	producers	*	rows	+	1),	"all	records	taken");
+expect(s.rejected	==	1,	"rejected	pushes	counted");
+}
+hsize_t	dims[2];
+ds.get_dataspace().get_dims(dims);
+expect(dims[0]	==	4	*	50	*	20	+	1,	"all	rows	appended");
+
+printf("%d	failures\n",	failures);
+return	failures	!=	0;
+}
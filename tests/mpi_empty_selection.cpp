@@ -0,0 +1,56 @@
+/*
+Collective	transfers	where	one	process	has	nothing	to	transfer,	which	must
+not	leave	the	others	waiting.	Run	with	mpirun	-np	N,	N	>=	2;	the	last
+process	owns	no	rows.
+*/
+#define	HDF_WRAPPER_HAS_MPI
+#include	"hdf_wrapper.h"
+#include	<cstdio>
+
+using	namespace	h5cpp;
+
+int	main(int	argc,	char	**argv)
+{
+MPI_Init(&argc,	&argv);
+int	rank,	nprocs;
+MPI_Comm_rank(MPI_COMM_WORLD,	&rank);
+MPI_Comm_size(MPI_COMM_WORLD,	&nprocs);
+int	failures	=	0;
+{
+const	hsize_t	cols	=	4,	rows	=	nprocs	-	1;
+File	f	=	File::parallel("mpi_empty_selection.h5",	"w",	MPI_COMM_WORLD);
+hsize_t	dims[2]	=	{	rows,	cols	};
+Dataset	a	=	Dataset::create(f.root(),	"a",	get_disktype<int>(),	Dataspace::simple(2,	dims),	Properties(H5P_DATASET_CREATE));
+Dataset	b	=	Dataset::create(f.root(),	"b",	get_disktype<int>(),	Dataspace::simple(2,	dims),	Properties(H5P_DATASET_CREATE));
+Properties	xfer(H5P_DATASET_XFER);
+xfer.collective();
+
+std::vector<int>	own;
+if	(rank	<	nprocs	-	1)
+own.push_back(rank);
+Selection	sel	=	Selection::indices(own);
+std::vector<int>	data(own.size()	*	cols,	rank	+	1);
+
+a.write(sel,	data.data(),	xfer);
+DatasetBatch	batch;
+batch.add(b,	sel,	(const	int*)data.data());
+batch.write(xfer);
+
+std::vector<int>	back_a(data.size(),	-1),	back_b(data.size(),	-1);
+a.read(sel,	back_a.data(),	xfer);
+DatasetBatch	rbatch;
+rbatch.add(b,	sel,	back_b.data());
+rbatch.read(xfer);
+if	(back_a	!=	data	||	back_b	!=	data)
+{
+printf("rank	%d:	data	read	back	differs\n",	rank);
+++failures;
+}
+}
+int	total	=	0;
+MPI_Allreduce(&failures,	&total,	1,	MPI_INT,	MPI_SUM,	MPI_COMM_WORLD);
+if	(rank	==	0)
+printf("%d	failures\n",	total);
+MPI_Finalize();
+return	total	!=	0;
+}
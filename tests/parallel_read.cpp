@@ -0,0 +1,67 @@
+/*
+The	parallel	chunk	reader	against	H5Dread	on	sparse	datasets,	where	only	some
+chunks	were	written,	with	the	different	fill	value	settings.
+*/
+#include	"hdf_wrapper.h"
+#include	<cstdio>
+
+using	namespace	h5cpp;
+
+enum	Fill	{	FILL_DEFAULT,	FILL_USER,	FILL_UNDEFINED,	FILL_NEVER,	FILL_ALLOC	};
+
+static	Dataset	create_sparse(Group	g,	const	char	*name,	Fill	fill)
+{
+hsize_t	dims[2]	=	{	100,	60	},	chunk[2]	=	{	16,	16	};
+Properties	dcpl(H5P_DATASET_CREATE);
+dcpl.chunked(2,	chunk).shuffle();
+H5Pset_fletcher32(dcpl.get_id());
+if	(fill	==	FILL_USER)
+dcpl.fill_value(7);
+else	if	(fill	==	FILL_UNDEFINED)
+H5Pset_fill_value(dcpl.get_id(),	H5T_NATIVE_INT,	NULL);
+else	if	(fill	==	FILL_NEVER)
+dcpl.fill_value(7).fill_time(H5D_FILL_TIME_NEVER);
+else	if	(fill	==	FILL_ALLOC)
+dcpl.fill_value(7).fill_time(H5D_FILL_TIME_ALLOC);
+Dataset	ds	=	Dataset::create(g,	name,	get_disktype<int>(),	Dataspace::simple(2,	dims),	dcpl);
+//	two	boxes,	the	rest	of	the	chunks	stays	unallocated
+std::vector<int>	v(20	*	20);
+for	(size_t	i=0;	i<v.size();	++i)
+v[i]	=	int(i)	+	1;
+hsize_t	offsets[2][2]	=	{	{	5,	3	},	{	60,	40	}	},	count[2]	=	{	20,	20	};
+for	(int	b=0;	b<2;	++b)
+{
+Dataspace	fs	=	ds.get_dataspace();
+fs.select_hyperslab(offsets[b],	NULL,	count,	NULL);
+ds.write(Dataspace::simple(2,	count),	fs,	v.data());
+}
+return	ds;
+}
+
+int	main()
+{
+File	f("parallel_read.h5",	"w");
+const	char	*names[]	=	{	"default",	"user",	"undefined",	"never",	"alloc"	};
+int	failures	=	0;
+for	(int	fill=FILL_DEFAULT;	fill<=FILL_ALLOC;	++fill)
+{
+Dataset	ds	=	create_sparse(f.root(),	names[fill],	Fill(fill));
+hsize_t	offset[2]	=	{	3,	2	},	count[2]	=	{	90,	55	};
+std::vector<int>	expected(count[0]	*	count[1],	-1),	got(expected.size(),	-1);
+Dataspace	fs	=	ds.get_dataspace();
+fs.select_hyperslab(offset,	NULL,	count,	NULL);
+ds.read(Dataspace::simple(2,	count),	fs,	expected.data());
+if	(!internal::read_chunks_parallel(ds,	get_memtype<int>(),	offset,	count,	got.data(),	3))
+{
+printf("%s:	chunks	were	not	read	in	parallel\n",	names[fill]);
+++failures;
+}
+if	(got	!=	expected)
+{
+printf("%s:	differs	from	H5Dread\n",	names[fill]);
+++failures;
+}
+}
+printf("%d	failures\n",	failures);
+return	failures	!=	0;
+}
@@ -0,0 +1,68 @@
+/*
+Ragged	arrays	without	rows	and	with	CREATE_DS_FLOAT16,	and	pyramids	with
+CREATE_DS_FLOAT16.
+*/
+#include	"hdf_wrapper.h"
+#include	<cstdio>
+
+using	namespace	h5cpp;
+
+static	int	failures	=	0;
+
+static	void	expect(bool	ok,	const	char	*what)
+{
+if	(!ok)
+{
+printf("failed:	%s\n",	what);
+++failures;
+}
+}
+
+static	size_t	stored_size(const	Dataset	&ds)
+{
+Datatype	t	=	ds.get_datatype();
+if	(t.get_class()	!=	H5T_VLEN)
+return	t.get_size();
+hid_t	base	=	H5Tget_super(t.get_id());
+size_t	n	=	H5Tget_size(base);
+H5Tclose(base);
+return	n;
+}
+
+int	main()
+{
+File	f("ragged.h5",	"w");
+
+RaggedArray<float>	empty,	back;
+back.push_back(NULL,	0);
+Dataset	e	=	create_dataset(f.root(),	"empty",	empty);
+read_dataset(e,	back);
+hsize_t	dims[1],	maxdims[1];
+H5Sget_simple_extent_dims(e.get_dataspace().get_id(),	dims,	maxdims);
+expect(back.size()	==	0	&&	back.values.empty(),	"empty	ragged	array	reads	back	empty");
+expect(dims[0]	==	0	&&	maxdims[0]	==	H5S_UNLIMITED,	"empty	ragged	dataset	is	extendible");
+
+RaggedArray<float>	rows;
+const	float	row0[]	=	{	0.5f,	1.25f,	-2.f	},	row1[]	=	{	1024.f	};
+rows.push_back(row0,	3);
+rows.push_back(row1,	1);
+Dataset	h	=	create_dataset(f.root(),	"half",	rows,	CREATE_DS_FLOAT16);
+read_dataset(h,	back);
+expect(stored_size(h)	==	2,	"ragged	values	stored	as	float16");
+expect(back.values	==	rows.values	&&	back.offsets	==	rows.offsets,	"float16	ragged	round	trip");
+
+RaggedDataset<float>	rd	=	RaggedDataset<float>::create(f.root(),	"ragged_half",	16,	CREATE_DS_FLOAT16);
+rd.append(rows);
+rd.read(back);
+expect(stored_size(rd.get_group().open_dataset("values"))	==	2,	"ragged	dataset	values	stored	as	float16");
+expect(back.values	==	rows.values,	"float16	ragged	dataset	round	trip");
+
+std::vector<float>	img(64	*	64,	1.5f);
+hsize_t	img_dims[2]	=	{	64,	64	};
+Dataset	src	=	create_dataset(f.root(),	"img",	Dataspace::simple(2,	img_dims),	img.data(),	CREATE_DS_0);
+Group	p	=	build_pyramid<float>(src,	f.root(),	"pyramid",	PYRAMID_MEAN,	16,	CREATE_DS_FLOAT16);
+expect(stored_size(p.open_dataset("1"))	==	2,	"pyramid	levels	stored	as	float16");
+
+printf("%d	failures\n",	failures);
+return	failures	!=	0;
+}
@@ -0,0 +1,73 @@
+/*
+repack:	empty	datasets,	and	streaming	between	chunk	sizes	without	common	factors.
+*/
+#include	"hdf_wrapper.h"
+#include	<cstdio>
+
+using	namespace	h5cpp;
+
+static	int	failures	=	0;
+
+static	void	expect(bool	ok,	const	char	*what)
+{
+if	(!ok)
+{
+printf("failed:	%s\n",	what);
+++failures;
+}
+}
+
+static	void	create_chunked(Group	g,	const	char	*name,	hsize_t	n,	hsize_t	chunk,	const	double	*data)
+{
+hsize_t	maxdims	=	H5S_UNLIMITED;
+Properties	dcpl(H5Pcreate(H5P_DATASET_CREATE),	internal::NoIncRC());
+H5Pset_chunk(dcpl.get_id(),	1,	&chunk);
+Dataset	ds	=	Dataset::create(g,	name,	get_disktype<double>(),	Dataspace::simple(1,	&n,	&maxdims),	dcpl);
+if	(n	>	0)
+ds.write(data);
+}
+
+int	main()
+{
+const	hsize_t	rows	=	20000;
+std::vector<double>	data(rows);
+for	(hsize_t	i=0;	i<rows;	++i)
+data[i]	=	double(i);
+{
+File	f("repack_in.h5",	"w");
+create_chunked(f.root(),	"empty",	0,	16,	NULL);
+create_chunked(f.root(),	"coprime",	rows,	1000,	data.data());
+}
+
+//	unchanged	copies	go	through	H5Ocopy
+RepackProgress	p	=	repack("repack_in.h5",	"repack_copy.h5");
+expect(p.datasets_done	==	2,	"both	datasets	copied");
+
+RepackOptions	options;
+options.buffer_bytes	=	64	<<	10;
+options.relayout	=	[](const	std::string	&,	const	Dataset	&,	Properties	&dcpl)
+{
+hsize_t	chunk	=	999;
+H5Pset_chunk(dcpl.get_id(),	1,	&chunk);
+return	true;
+};
+uint64_t	largest_block	=	0,	last_done	=	0;
+options.progress	=	[&](const	RepackProgress	&pr)
+{
+if	(pr.bytes_done	>	last_done)
+largest_block	=	std::max(largest_block,	pr.bytes_done	-	last_done);
+last_done	=	pr.bytes_done;
+};
+p	=	repack("repack_in.h5",	"repack_out.h5",	options);
+expect(p.datasets_done	==	2,	"both	datasets	rewritten");
+expect(largest_block	<=	options.buffer_bytes,	"blocks	stay	within	buffer_bytes");
+
+File	out("repack_out.h5",	"r");
+std::vector<double>	back;
+read_dataset(out.root().open_dataset("coprime"),	back);
+expect(back	==	data,	"data	survives	rechunking");
+expect(H5Sget_simple_extent_npoints(out.root().open_dataset("empty").get_dataspace().get_id())	==	0,	"empty	dataset	stays	empty");
+
+printf("%d	failures\n",	failures);
+return	failures	!=	0;
+}
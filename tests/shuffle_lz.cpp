@@ -0,0 +1,129 @@
+/*
+The	shuffle	+	LZ	filter	through	H5Dwrite/H5Dread,	and	the	SIMD	shuffle
+kernels	against	the	scalar	loops.
+*/
+#include	"hdf_wrapper.h"
+#include	<cstdio>
+#include	<cstdlib>
+
+using	namespace	h5cpp;
+
+static	int	failures	=	0;
+
+static	void	expect(bool	ok,	const	char	*what)
+{
+if	(!ok)
+{
+printf("failed:	%s\n",	what);
+++failures;
+}
+}
+
+static	Dataset	create_filtered(Group	g,	const	char	*name,	const	Datatype	&type,	hsize_t	n,	hsize_t	chunk)
+{
+Properties	dcpl(H5Pcreate(H5P_DATASET_CREATE),	internal::NoIncRC());
+dcpl.chunked(1,	&chunk).shuffle_lz();
+Properties	dapl(H5Pcreate(H5P_DATASET_ACCESS),	internal::NoIncRC());
+dapl.chunk_cache(0,	0);	//	so	reads	decode	the	chunks	instead	of	finding	them	in	the	cache
+return	Dataset::create(g,	name,	type,	Dataspace::simple(1,	&n),	dcpl,	dapl);
+}
+
+//	decodes	the	first	chunk	with	the	filter's	own	decoder,	so	data	which	silently	passed	unfiltered	is	noticed
+static	bool	first_chunk_decodes_to(const	Dataset	&ds,	const	void	*data,	size_t	nbytes)
+{
+hsize_t	offset	=	0,	size	=	0;
+uint32_t	mask	=	0;
+if	(H5Dget_chunk_storage_size(ds.get_id(),	&offset,	&size)	<	0	||	size	==	0)
+return	false;
+std::vector<unsigned	char>	raw(size),	out,	tmp;
+if	(H5Dread_chunk(ds.get_id(),	H5P_DEFAULT,	&offset,	&mask,	raw.data())	<	0	||	mask	!=	0)
+return	false;
+return	internal::shuffle_lz_decode(raw.data(),	raw.size(),	out,	tmp)	&&	out.size()	>=	nbytes	&&	std::memcmp(out.data(),	data,	nbytes)	==	0;
+}
+
+static	void	scalar_shuffle(const	unsigned	char	*src,	unsigned	char	*dst,	size_t	n,	size_t	elem_size)
+{
+for	(size_t	b=0;	b<elem_size;	++b)
+for	(size_t	i=0;	i<n;	++i)
+dst[b	*	n	+	i]	=	src[i	*	elem_size	+	b];
+}
+
+int	main()
+{
+File	f("shuffle_lz.h5",	"w");
+
+const	hsize_t	n	=	5000;
+std::vector<float>	floats(n);
+for	(hsize_t	i=0;	i<n;	++i)
+floats[i]	=	float(i	%	97)	*	0.25f;
+Dataset	fd	=	create_filtered(f.root(),	"floats",	get_disktype<float>(),	n,	1000);
+fd.write(floats.data());
+std::vector<float>	floats_back(n);
+fd.read(floats_back.data());
+expect(floats_back	==	floats,	"float	round	trip");
+expect(first_chunk_decodes_to(fd,	floats.data(),	1000	*	sizeof(float)),	"float	chunk	is	filtered");
+
+std::vector<double>	doubles(n);
+for	(hsize_t	i=0;	i<n;	++i)
+doubles[i]	=	double(i	*	7);
+Dataset	dd	=	create_filtered(f.root(),	"doubles",	get_disktype<double>(),	n,	1000);
+dd.write(doubles.data());
+std::vector<double>	doubles_back(n);
+dd.read(doubles_back.data());
+expect(doubles_back	==	doubles,	"double	round	trip");
+
+//	elements	of	80000	bytes,	beyond	the	16	bit	element	size	of	the	header
+int	len	=	20000;
+Datatype	big	=	Datatype::createArray(get_disktype<float>(),	1,	&len);
+std::vector<float>	bigs(2	*	len);
+for	(size_t	i=0;	i<bigs.size();	++i)
+bigs[i]	=	float(i	%	1013);
+Dataset	bd	=	create_filtered(f.root(),	"big",	big,	2,	2);
+H5Dwrite(bd.get_id(),	big.get_id(),	H5S_ALL,	H5S_ALL,	H5P_DEFAULT,	bigs.data());
+std::vector<float>	bigs_back(bigs.size());
+H5Dread(bd.get_id(),	big.get_id(),	H5S_ALL,	H5S_ALL,	H5P_DEFAULT,	bigs_back.data());
+expect(bigs_back	==	bigs,	"large	element	round	trip");
+expect(first_chunk_decodes_to(bd,	bigs.data(),	len	*	sizeof(float)),	"large	element	chunk	is	filtered");
+
+//	the	dispatched	shuffle	(SIMD	for	4	byte	elements)	against	the	scalar	loop,	with	leftover	bytes
+for	(size_t	elem_size	:	{	size_t(2),	size_t(4),	size_t(8)	})
+{
+for	(size_t	count=0;	count<200;	count+=7)
+{
+size_t	nbytes	=	count	*	elem_size	+	count	%	elem_size;
+std::vector<unsigned	char>	src(nbytes),	simd(nbytes),	scalar(nbytes),	back(nbytes);
+for	(size_t	i=0;	i<nbytes;	++i)
+src[i]	=	(unsigned	char)rand();
+internal::shuffle(src.data(),	simd.data(),	nbytes,	elem_size);
+scalar_shuffle(src.data(),	scalar.data(),	count,	elem_size);
+std::memcpy(scalar.data()	+	count	*	elem_size,	src.data()	+	count	*	elem_size,	nbytes	-	count	*	elem_size);
+internal::unshuffle(simd.data(),	back.data(),	nbytes,	elem_size);
+if	(simd	!=	scalar	||	back	!=	src)
+{
+printf("elem_size	%d,	%d	elements:	",	int(elem_size),	int(count));
+expect(false,	"SIMD	shuffle	matches	the	scalar	one");
+}
+}
+}
+
+#ifdef	HDF_WRAPPER_X86_SIMD
+//	each	kernel,	not	only	the	one	the	dispatch	picks	on	this	machine
+std::vector<unsigned	char>	src(4	*	256),	ref(src.size()),	out(src.size()),	back(src.size());
+for	(size_t	i=0;	i<src.size();	++i)
+src[i]	=	(unsigned	char)rand();
+scalar_shuffle(src.data(),	ref.data(),	256,	4);
+if	(internal::cpu_has_ssse3())
+{
+expect(internal::shuffle4_ssse3(src.data(),	out.data(),	256)	==	256	&&	out	==	ref,	"SSSE3	shuffle");
+expect(internal::unshuffle4_ssse3(ref.data(),	back.data(),	256)	==	256	&&	back	==	src,	"SSSE3	unshuffle");
+}
+if	(internal::cpu_has_avx2())
+{
+expect(internal::shuffle4_avx2(src.data(),	out.data(),	256)	==	256	&&	out	==	ref,	"AVX2	shuffle");
+expect(internal::unshuffle4_avx2(ref.data(),	back.data(),	256)	==	256	&&	back	==	src,	"AVX2	unshuffle");
+}
+#endif
+
+printf("%d	failures\n",	failures);
+return	failures	!=	0;
+}
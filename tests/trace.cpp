@@ -0,0 +1,73 @@
+/*
+analyze_io_trace:	raw	data	of	other	files	opened	with	the	same	trace	is	not
+attributed	to	the	datasets	of	the	analyzed	file,	and	hard	link	cycles	end.
+*/
+#include	"hdf_wrapper.h"
+#include	<cstdio>
+
+using	namespace	h5cpp;
+
+static	int	failures	=	0;
+
+static	void	expect(bool	ok,	const	char	*what)
+{
+if	(!ok)
+{
+printf("failed:	%s\n",	what);
+++failures;
+}
+}
+
+//	the	same	layout	in	each	file,	so	the	datasets	share	addresses
+static	void	create_file(const	char	*name,	const	std::vector<double>	&data)
+{
+File	f(name,	"w");
+hsize_t	n	=	data.size();
+Dataset	ds	=	Dataset::create(f.root(),	"x",	get_disktype<double>(),	Dataspace::simple(1,	&n),	Properties(H5P_DATASET_CREATE));
+ds.write(data.data());
+Group	g	=	f.root().create_group("g");
+H5Lcreate_hard(f.root().get_id(),	".",	g.get_id(),	"up",	H5P_DEFAULT,	H5P_DEFAULT);
+H5Lcreate_hard(f.root().get_id(),	"x",	g.get_id(),	"x_again",	H5P_DEFAULT,	H5P_DEFAULT);
+}
+
+static	const	IoTraceReport::Target	*find(const	IoTraceReport	&rep,	const	std::string	&name)
+{
+for	(size_t	i=0;	i<rep.targets.size();	++i)
+if	(rep.targets[i].name	==	name)
+return	&rep.targets[i];
+return	NULL;
+}
+
+int	main()
+{
+std::vector<double>	data(100000,	1.);
+create_file("trace_a.h5",	data);
+create_file("trace_b.h5",	data);
+
+IoTrace	trace;
+File	a	=	File::traced("trace_a.h5",	"r",	trace);
+File	b	=	File::traced("trace_b.h5",	"r",	trace);
+std::vector<double>	in;
+read_dataset(a.root().open_dataset("x"),	in);
+read_dataset(b.root().open_dataset("x"),	in);
+read_dataset(b.root().open_dataset("x"),	in);
+
+uint64_t	raw_a	=	0,	raw_b	=	0;
+std::vector<IoTraceRecord>	records	=	trace.records();
+for	(size_t	i=0;	i<records.size();	++i)
+if	(records[i].type	==	H5FD_MEM_DRAW	&&	!records[i].write)
+(records[i].file	==	0	?	raw_a	:	raw_b)	+=	records[i].size;
+expect(raw_a	>	0	&&	raw_b	>	0,	"raw	data	reads	of	both	files	traced");
+
+IoTraceReport	rep	=	analyze_io_trace(trace,	a);
+const	IoTraceReport::Target	*x	=	find(rep,	"/x"),	*x_again	=	find(rep,	"/g/x_again");
+expect(!x	!=	!x_again,	"datasets	reached	by	two	links	count	once");
+if	(!x)
+x	=	x_again;
+const	IoTraceReport::Target	*other	=	find(rep,	"(raw	data)");
+expect(x	&&	x->read_bytes	==	raw_a,	"only	reads	of	the	analyzed	file	count	for	its	dataset");
+expect(other	&&	other->read_bytes	==	raw_b,	"reads	of	the	other	file	are	raw	data");
+
+printf("%d	failures\n",	failures);
+return	failures	!=	0;
+}
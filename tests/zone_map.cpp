@@ -0,0 +1,132 @@
+/*
+Zone	maps:	stored	in	attributes	of	the	dataset,	invalidated	by	plain	writes,
+and	the	SIMD	stats	and	range	kernels	agree	with	the	scalar	loops.
+*/
+#include	"hdf_wrapper.h"
+#include	<cstdio>
+#include	<cstdlib>
+
+using	namespace	h5cpp;
+
+static	int	failures	=	0;
+
+static	void	expect(bool	ok,	const	char	*what)
+{
+if	(!ok)
+{
+printf("failed:	%s\n",	what);
+++failures;
+}
+}
+
+static	std::vector<hsize_t>	where(const	Dataset	&ds,	const	ValueRange	&range)
+{
+std::vector<hsize_t>	indices;
+std::vector<double>	values;
+ds.read_where(range,	indices,	values);
+return	indices;
+}
+
+static	Dataset	create_chunked(Group	g,	const	char	*name,	hsize_t	n,	hsize_t	chunk)
+{
+Properties	dcpl(H5Pcreate(H5P_DATASET_CREATE),	internal::NoIncRC());
+H5Pset_chunk(dcpl.get_id(),	1,	&chunk);
+hid_t	id	=	H5Dcreate2(g.get_id(),	name,	H5T_NATIVE_DOUBLE,	Dataspace::simple(1,	&n).get_id(),	H5P_DEFAULT,	dcpl.get_id(),	H5P_DEFAULT);
+Dataset	ds(id);
+H5Idec_ref(id);
+return	ds;
+}
+
+static	herr_t	count_link(hid_t,	const	char	*,	const	H5L_info_t	*,	void	*n)
+{
+++*static_cast<int*>(n);
+return	0;
+}
+
+template<class	T>
+static	void	check_kernels(const	char	*what)
+{
+T	nan	=	std::numeric_limits<T>::quiet_NaN();
+for	(size_t	n=0;	n<70;	++n)
+{
+std::vector<T>	data(n);
+for	(size_t	i=0;	i<n;	++i)
+data[i]	=	(rand()	%	7	==	0)	?	nan	:	T(rand()	%	200	-	100)	/	4;
+ChunkStats	s	=	internal::empty_stats();
+internal::accumulate_stats(data.data(),	n,	s);
+double	lo	=	std::numeric_limits<double>::infinity(),	hi	=	-lo;
+uint64_t	nans	=	0;
+for	(size_t	i=0;	i<n;	++i)
+{
+if	(data[i]	!=	data[i])
+++nans;
+else
+{
+lo	=	std::min(lo,	double(data[i]));
+hi	=	std::max(hi,	double(data[i]));
+}
+}
+bool	ok	=	s.count	==	n	&&	s.nan_count	==	nans	&&	(nans	==	n	||	(s.min	==	lo	&&	s.max	==	hi));
+expect(ok,	what);
+
+ValueRange	ranges[]	=	{	ValueRange::between(-5,	5),	ValueRange::greater(0),	ValueRange::less(-2.5),	ValueRange(-10,	10,	false,	false)	};
+for	(const	ValueRange	&r	:	ranges)
+{
+std::vector<unsigned	char>	mask(n,	2);
+internal::range_mask(data.data(),	n,	r,	mask.data());
+for	(size_t	i=0;	i<n;	++i)
+ok	&=	mask[i]	==	(r(data[i])	?	1	:	0);
+}
+expect(ok,	what);
+}
+}
+
+int	main()
+{
+check_kernels<double>("double	stats	and	mask	match	the	scalar	reference");
+check_kernels<float>("float	stats	and	mask	match	the	scalar	reference");
+
+File	f("zone_map.h5",	"w");
+hsize_t	n	=	1000;
+Dataset	ds	=	create_chunked(f.root(),	"x",	n,	100);
+std::vector<double>	data(n);
+for	(hsize_t	i=0;	i<n;	++i)
+data[i]	=	double(i);
+write_with_zone_map(ds,	data.data());
+expect(where(ds,	ValueRange::greater_equal(2000)).empty(),	"nothing	above	2000");
+
+int	links	=	0;
+H5Literate(f.root().get_id(),	H5_INDEX_NAME,	H5_ITER_NATIVE,	NULL,	count_link,	&links);
+expect(links	==	1,	"zone	map	is	not	a	sibling	link");
+
+//	a	plain	write	invalidates	the	map,	so	the	new	value	is	found
+data[550]	=	5000;
+ds.write(data.data());
+expect(where(ds,	ValueRange::greater_equal(2000))	==	std::vector<hsize_t>(1,	550),	"plain	write	is	seen	by	read_where");
+
+//	updating	after	a	partial	write	makes	the	map	valid	again
+build_zone_map<double>(ds);
+double	v	=	7000;
+hsize_t	offset	=	120,	one	=	1;
+Dataspace	fs	=	ds.get_dataspace();
+fs.select_hyperslab(&offset,	NULL,	&one,	NULL);
+ds.write(Dataspace::simple(1,	&one),	fs,	&v);
+update_zone_map<double>(ds,	&offset,	&one);
+expect(ds.attrs().exists("zone_map.valid"),	"update_zone_map	validates	the	map");
+std::vector<hsize_t>	expected	=	{	120,	550	};
+expect(where(ds,	ValueRange::greater_equal(2000))	==	expected,	"partial	write	and	update");
+
+//	more	zones	than	fit	in	one	attribute
+hsize_t	big	=	4500;
+Dataset	many	=	create_chunked(f.root(),	"many",	big,	1);
+std::vector<double>	d2(big);
+for	(hsize_t	i=0;	i<big;	++i)
+d2[i]	=	double(i	%	10);
+d2[4321]	=	100;
+write_with_zone_map(many,	d2.data());
+expect(many.attrs().exists("zone_map.2"),	"map	split	over	attributes");
+expect(where(many,	ValueRange::greater(50))	==	std::vector<hsize_t>(1,	4321),	"split	map	is	read	back");
+
+printf("%d	failures\n",	failures);
+return	failures	!=	0;
+}